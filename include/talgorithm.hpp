@@ -14,6 +14,7 @@
 #include <titerator.hpp>
 #include <tstl_heap.hpp> // heap algorithms
 #include <tstl_uninitialized.hpp>
+#include <tstl_bit_iterator.hpp> // bit iterators of vector<bool>
 
 namespace tstd
 {
@@ -48,12 +49,17 @@ public:
     using iterator = T*;
     using reverse_iterator = tstd::reverse_iterator<iterator>;
     TemporaryBuffer(ForwardIterator seed, std::size_t n) 
-        : elem_count(n == 0 ? 1 : n)
-        , data(nullptr)
+        : data(nullptr)
+        , elem_count(n == 0 ? 1 : n)
+        , capacity(0)
         , alloc()
     {
-        data = static_cast<T*>(alloc.allocate(elem_count));
-        for (int i = 0; i < elem_count; ++i)
+        // the block may be larger than requested, only elem_count elements are used since
+        // algorithms rely on the exact range, but the block is returned with its real size.
+        auto result = impl::_allocate_at_least(alloc, elem_count);
+        data = result.ptr;
+        capacity = result.count;
+        for (std::size_t i = 0; i < elem_count; ++i)
         {
             alloc.construct(data+i, std::move(*seed));
         }
@@ -61,11 +67,11 @@ public:
     }
     ~TemporaryBuffer()
     {
-        for (int i = 0; i < elem_count; ++i)
+        for (std::size_t i = 0; i < elem_count; ++i)
         {
             alloc.destroy(data+i);
         }
-        alloc.deallocate(data, elem_count);
+        alloc.deallocate(data, capacity);
     }
     T* begin()
     {
@@ -86,7 +92,8 @@ public:
 private:
     T* data;
     std::size_t elem_count;
-    tstd::allocator<T> alloc;
+    std::size_t capacity; // real size of the block
+    Allocator alloc;
 };
 }
 
@@ -239,6 +246,13 @@ constexpr std::pair<InputIterator1, InputIterator2> mismatch(InputIterator1 firs
 template<typename InputIterator, typename T>
 constexpr InputIterator find(InputIterator first, InputIterator last, const T& value)
 {
+    if constexpr (impl::is_block_searchable_v<InputIterator, T>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            return first + impl::_find_n(first, static_cast<std::size_t>(last - first), value);
+        }
+    }
     for (; first != last; ++first)
     {
         if (*first == value)
@@ -541,6 +555,14 @@ constexpr ForwardIterator search_n(ForwardIterator first, ForwardIterator last,
 template<typename InputIterator, typename OutputIterator>
 constexpr OutputIterator copy(InputIterator first, InputIterator last, OutputIterator d_first)
 {
+    if constexpr (impl::is_copy_memmovable_v<InputIterator, OutputIterator>
+        && std::is_trivially_copy_assignable_v<std::remove_pointer_t<OutputIterator>>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            return impl::_memmove_n(first, static_cast<std::size_t>(last - first), d_first);
+        }
+    }
     for (; first != last; ++first)
     {
         *d_first++ = *first;
@@ -615,6 +637,14 @@ BidirectionalIterator2 move_backward(BidirectionalIterator1 first, Bidirectional
 template<typename ForwardIterator, typename T>
 constexpr void fill(ForwardIterator first, ForwardIterator last, const T& value)
 {
+    if constexpr (impl::is_memsetable_v<ForwardIterator, T>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            impl::_memset_n(first, static_cast<std::size_t>(last - first), value);
+            return;
+        }
+    }
     for (; first != last; ++first)
     {
         *first = value;
@@ -1345,7 +1375,7 @@ constexpr void sort(RandomIterator first, RandomIterator last) // 1
     {
         return;
     }
-    auto pivot = *tstd::next(first, tstd::distance(first, last) / 2);
+    typename std::iterator_traits<RandomIterator>::value_type pivot = *tstd::next(first, tstd::distance(first, last) / 2);
     auto middle1 = tstd::partition(first, last, [pivot](const auto& elem) { return elem < pivot; });
     auto middle2 = tstd::partition(middle1, last, [pivot](const auto& elem) { return !(pivot < elem); });
     tstd::sort(first, middle1);
@@ -1358,7 +1388,7 @@ constexpr void sort(RandomIterator first, RandomIterator last, Compare comp) //
     {
         return;
     }
-    auto pivot = *tstd::next(first, tstd::distance(first, last) / 2);
+    typename std::iterator_traits<RandomIterator>::value_type pivot = *tstd::next(first, tstd::distance(first, last) / 2);
     auto middle1 = tstd::partition(first, last, [pivot, &comp](const auto& elem) { return comp(elem, pivot); });
     auto middle2 = tstd::partition(middle1, last, [pivot, &comp](const auto& elem) { return !comp(pivot, elem); });
     tstd::sort(first, middle1, comp);
@@ -1375,7 +1405,7 @@ constexpr void partial_sort(RandomIterator first, RandomIterator middle, RandomI
         return;
     }
     auto N = tstd::distance(first, middle);
-    auto pivot = *tstd::next(first, tstd::distance(first, last) / 2);
+    typename std::iterator_traits<RandomIterator>::value_type pivot = *tstd::next(first, tstd::distance(first, last) / 2);
     auto middle1 = tstd::partition(first, last, [pivot](const auto& elem) { return elem < pivot; });
     auto middle2 = tstd::partition(middle1, last, [pivot](const auto& elem) { return !(pivot < elem); });
     if (tstd::distance(first, middle2) < N)
@@ -1400,7 +1430,7 @@ constexpr void partial_sort(RandomIterator first, RandomIterator middle, RandomI
         return;
     }
     auto N = tstd::distance(first, middle);
-    auto pivot = *tstd::next(first, tstd::distance(first, last) / 2);
+    typename std::iterator_traits<RandomIterator>::value_type pivot = *tstd::next(first, tstd::distance(first, last) / 2);
     auto middle1 = tstd::partition(first, last, [pivot, &comp](const auto& elem) { return comp(elem, pivot); });
     auto middle2 = tstd::partition(middle1, last, [pivot, &comp](const auto& elem) { return !comp(pivot, elem); });
     if (tstd::distance(first, middle2) < N)
@@ -1574,7 +1604,7 @@ constexpr void nth_element(RandomIterator first, RandomIterator nth, RandomItera
         return;
     }
     auto N = nth - first;
-    auto pivot = *tstd::next(first, tstd::distance(first, last) / 2);
+    typename std::iterator_traits<RandomIterator>::value_type pivot = *tstd::next(first, tstd::distance(first, last) / 2);
     auto middle1 = tstd::partition(first, last, [pivot](const auto& elem) { return elem < pivot; });
     auto middle2 = tstd::partition(middle1, last, [pivot](const auto& elem) { return !(pivot < elem); });
     if (tstd::distance(first, middle2) < N)
@@ -1598,7 +1628,7 @@ constexpr void nth_element(RandomIterator first, RandomIterator nth, RandomItera
         return;
     }
     auto N = nth - first;
-    auto pivot = *tstd::next(first, tstd::distance(first, last) / 2);
+    typename std::iterator_traits<RandomIterator>::value_type pivot = *tstd::next(first, tstd::distance(first, last) / 2);
     auto middle1 = tstd::partition(first, last, [pivot, &comp](const auto& elem) { return comp(elem, pivot); });
     auto middle2 = tstd::partition(middle1, last, [pivot, &comp](const auto& elem) { return !comp(pivot, elem); });
     if (tstd::distance(first, middle2) < N)
@@ -2332,6 +2362,13 @@ constexpr const T& clamp(const T& v, const T& lo, const T& hi, Compare comp) //
 template<typename InputIterator1, typename InputIterator2>
 constexpr bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) // 1
 {
+    if constexpr (impl::is_memcmp_comparable_v<InputIterator1, InputIterator2>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            return impl::_memequal_n(first1, first2, static_cast<std::size_t>(last1 - first1));
+        }
+    }
     for (; first1 != last1; ++first1, ++first2)
     {
         if (!(*first1 == *first2))
@@ -2356,26 +2393,33 @@ constexpr bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2
 template<typename InputIterator1, typename InputIterator2>
 constexpr bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2) // 3
 {
-    for (; first1 != last2 && first2 != last2; ++first1, ++first2)
+    if constexpr (impl::is_memcmp_comparable_v<InputIterator1, InputIterator2>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            return last1 - first1 == last2 - first2 && impl::_memequal_n(first1, first2, static_cast<std::size_t>(last1 - first1));
+        }
+    }
+    for (; first1 != last1 && first2 != last2; ++first1, ++first2)
     {
         if (!(*first1 == *first2))
         {
             return false;
         }
     }
-    return true;
+    return first1 == last1 && first2 == last2;
 }
 template<typename InputIterator1, typename InputIterator2, typename BinaryPredicate>
 constexpr bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, BinaryPredicate p) // 4
 {
-    for (; first1 != last2 && first2 != last2; ++first1, ++first2)
+    for (; first1 != last1 && first2 != last2; ++first1, ++first2)
     {
         if (!p(*first1, *first2))
         {
             return false;
         }
     }
-    return true;
+    return first1 == last1 && first2 == last2;
 }
 
 // lexicographical_compare: compare two range in lexicographical order, return range1 < range2
@@ -2383,7 +2427,14 @@ constexpr bool equal(InputIterator1 first1, InputIterator1 last1, InputIterator2
 template<typename InputIterator1, typename InputIterator2>
 constexpr bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2) // 1
 {
-    for (; first1 != last2 && first2 != last2; ++first1, ++first2)
+    if constexpr (impl::is_memcmp_comparable_v<InputIterator1, InputIterator2>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            return impl::_memcmp_three_way(first1, static_cast<std::size_t>(last1 - first1), first2, static_cast<std::size_t>(last2 - first2)) < 0;
+        }
+    }
+    for (; first1 != last1 && first2 != last2; ++first1, ++first2)
     {
         if (*first1 < *first2)
         {
@@ -2399,7 +2450,7 @@ constexpr bool lexicographical_compare(InputIterator1 first1, InputIterator1 las
 template<typename InputIterator1, typename InputIterator2, typename Compare>
 constexpr bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, Compare comp) // 2
 {
-    for (; first1 != last2 && first2 != last2; ++first1, ++first2)
+    for (; first1 != last1 && first2 != last2; ++first1, ++first2)
     {
         if (comp(*first1, *first2))
         {
@@ -2425,6 +2476,13 @@ constexpr auto lexicographical_compare_three_way(InputIterator1 first1, InputIte
                       std::is_same<ret_t, std::weak_ordering>,
                       std::is_same<ret_t, std::partial_ordering>>,
                   "The return type must be a comparison category type.");
+    if constexpr (impl::is_memcmp_comparable_v<InputIterator1, InputIterator2> && std::is_same_v<Compare, std::compare_three_way>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            return impl::_memcmp_three_way(first1, static_cast<std::size_t>(last1 - first1), first2, static_cast<std::size_t>(last2 - first2));
+        }
+    }
     bool exhaust1 = (first1 == last1);
     bool exhaust2 = (first2 == last2);
     for (; !exhaust1 && !exhaust2; exhaust1 = (++first1 == last1), exhaust2 = (++first2 == last2))
@@ -2663,6 +2721,165 @@ constexpr bool prev_permutation(BidirectionalIterator first, BidirectionalIterat
     }
 }
 
+// ======================================== word-at-a-time algorithms on bits of vector<bool> ======================================================
+// overloads of count, find, find_first_of, fill, fill_n, copy and copy_backward for bit iterators,
+// which work on 64 bits at a time by popcount/countr_zero and masks.
+
+// complexity: O((last-first)/64)
+template<bool IsConst, typename T>
+constexpr std::ptrdiff_t count(impl::bit_iterator<IsConst> first, impl::bit_iterator<IsConst> last, const T& value)
+{
+    std::ptrdiff_t ones = impl::_bit_count(first, last);
+    return (value == true ? ones : 0) + (value == false ? (last - first) - ones : 0);
+}
+
+// complexity: O((last-first)/64)
+template<bool IsConst, typename T>
+constexpr impl::bit_iterator<IsConst> find(impl::bit_iterator<IsConst> first, impl::bit_iterator<IsConst> last, const T& value)
+{
+    if (value == true)
+    {
+        return impl::_bit_find(first, last, true);
+    }
+    if (value == false)
+    {
+        return impl::_bit_find(first, last, false);
+    }
+    return last;
+}
+
+// complexity: O(s_last-s_first + (last-first)/64)
+template<bool IsConst, typename ForwardIterator>
+constexpr impl::bit_iterator<IsConst> find_first_of(impl::bit_iterator<IsConst> first, impl::bit_iterator<IsConst> last, ForwardIterator s_first, ForwardIterator s_last)
+{
+    bool has_true = false;
+    bool has_false = false;
+    for (; s_first != s_last && !(has_true && has_false); ++s_first)
+    {
+        has_true = has_true || true == *s_first;
+        has_false = has_false || false == *s_first;
+    }
+    if (has_true && has_false)
+    {
+        return first;
+    }
+    if (has_true || has_false)
+    {
+        return impl::_bit_find(first, last, has_true);
+    }
+    return last;
+}
+
+// complexity: O((last-first)/64)
+template<typename T>
+constexpr void fill(impl::bit_iterator<false> first, impl::bit_iterator<false> last, const T& value)
+{
+    impl::_bit_fill(first, last, static_cast<bool>(value));
+}
+
+// complexity: O(count/64)
+template<typename Size, typename T>
+constexpr impl::bit_iterator<false> fill_n(impl::bit_iterator<false> first, Size count, const T& value)
+{
+    if (count <= 0)
+    {
+        return first;
+    }
+    impl::_bit_fill(first, first + count, static_cast<bool>(value));
+    return first + count;
+}
+
+// complexity: O((last-first)/64)
+template<bool IsConst>
+constexpr impl::bit_iterator<false> copy(impl::bit_iterator<IsConst> first, impl::bit_iterator<IsConst> last, impl::bit_iterator<false> d_first)
+{
+    return impl::_bit_copy(first, last, d_first);
+}
+
+// complexity: O((last-first)/64)
+template<bool IsConst>
+constexpr impl::bit_iterator<false> copy_backward(impl::bit_iterator<IsConst> first, impl::bit_iterator<IsConst> last, impl::bit_iterator<false> d_last)
+{
+    return impl::_bit_copy_backward(first, last, d_last);
+}
+
+// ======================================== algorithms on segmented iterators ======================================================
+// overloads of for_each, count, find, copy and fill for segmented iterators (e.g. iterators of tstd::deque),
+// which run a plain loop on every segment, the loops on pointers could then be vectorized or lowered to memmove/memset.
+
+// complexity: exactly last-first applications of f
+template<segmented_iterator InputIterator, typename UnaryFunction>
+constexpr UnaryFunction for_each(InputIterator first, InputIterator last, UnaryFunction f)
+{
+    impl::_for_each_segment(first, last, [&f](auto local_first, auto local_last) {
+        for (; local_first != local_last; ++local_first)
+        {
+            f(*local_first);
+        }
+    });
+    return f;
+}
+
+// complexity: exactly last-first comparisons
+template<segmented_iterator InputIterator, typename T>
+constexpr typename std::iterator_traits<InputIterator>::difference_type count(InputIterator first, InputIterator last, const T& value)
+{
+    typename std::iterator_traits<InputIterator>::difference_type ret = 0;
+    impl::_for_each_segment(first, last, [&ret, &value](auto local_first, auto local_last) {
+        ret += tstd::count(local_first, local_last, value);
+    });
+    return ret;
+}
+
+// complexity: at most last-first applications of operator==
+template<segmented_iterator InputIterator, typename T>
+constexpr InputIterator find(InputIterator first, InputIterator last, const T& value)
+{
+    return impl::_search_segments(first, last, [&value](auto local_first, auto local_last) {
+        return tstd::find(local_first, local_last, value);
+    });
+}
+
+// complexity: exactly last-first assignments
+template<segmented_iterator ForwardIterator, typename T>
+constexpr void fill(ForwardIterator first, ForwardIterator last, const T& value)
+{
+    impl::_for_each_segment(first, last, [&value](auto local_first, auto local_last) {
+        tstd::fill(local_first, local_last, value);
+    });
+}
+
+// copy to segmented destination: the source is split by the room left in every destination segment
+// complexity: exactly last-first assignments
+template<typename InputIterator, segmented_iterator OutputIterator>
+    requires (!segmented_iterator<InputIterator> && tstd::is_random_access_iterator_v<InputIterator>)
+constexpr OutputIterator copy(InputIterator first, InputIterator last, OutputIterator d_first)
+{
+    auto n = last - first;
+    while (n > 0)
+    {
+        auto seg = d_first.segment();
+        auto local = d_first.local();
+        auto len = tstd::min<decltype(n)>(n, OutputIterator::segment_end(seg) - local);
+        local = tstd::copy(first, first + len, local);
+        first += len;
+        n -= len;
+        d_first = OutputIterator::compose(seg, local);
+    }
+    return d_first;
+}
+
+// copy from segmented source: every segment is copied as a contiguous range
+// complexity: exactly last-first assignments
+template<segmented_iterator InputIterator, typename OutputIterator>
+constexpr OutputIterator copy(InputIterator first, InputIterator last, OutputIterator d_first)
+{
+    impl::_for_each_segment(first, last, [&d_first](auto local_first, auto local_last) {
+        d_first = tstd::copy(local_first, local_last, d_first);
+    });
+    return d_first;
+}
+
 } // namespace tstd
 
 #endif // TALGORITHM_HPP
\ No newline at end of file
@@ -169,6 +169,14 @@ public:
 template<typename T, std::size_t N>
 constexpr int _cmp_array(const tstd::array<T, N>& lhs, const tstd::array<T, N>& rhs)
 {
+    if constexpr (impl::is_memcmp_comparable_v<const T*, const T*>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            auto cmp = impl::_memcmp_three_way(lhs.begin(), N, rhs.begin(), N);
+            return cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+        }
+    }
     for (std::size_t i = 0; i < N; ++i)
     {
         if (lhs[i] == rhs[i])
@@ -184,12 +192,26 @@ constexpr int _cmp_array(const tstd::array<T, N>& lhs, const tstd::array<T, N>&
 template<typename T, std::size_t N>
 constexpr bool operator==(const tstd::array<T, N>& lhs, const tstd::array<T, N>& rhs)
 {
-    return _cmp_array(lhs, rhs) == 0;
+    if constexpr (impl::is_memcmp_comparable_v<const T*, const T*>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            return impl::_memequal_n(lhs.begin(), rhs.begin(), N);
+        }
+    }
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (!(lhs[i] == rhs[i]))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 template<typename T, std::size_t N>
 constexpr bool operator!=(const tstd::array<T, N>& lhs, const tstd::array<T, N>& rhs)
 {
-    return _cmp_array(lhs, rhs) != 0;
+    return !(lhs == rhs);
 }
 template<typename T, std::size_t N>
 constexpr bool operator<(const tstd::array<T, N>& lhs, const tstd::array<T, N>& rhs)
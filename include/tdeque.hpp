@@ -2,6 +2,7 @@
 #define TDEQUE_HPP
 
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <tstl_uninitialized.hpp>
 #include <titerator.hpp>
 #include <tutility.hpp>
@@ -9,17 +10,33 @@
 #include <type_traits>
 #include <talgorithm.hpp>
 #include <cassert>
+#include <bit>
 
 namespace tstd
 {
 
-template<typename T, typename Allocator = tstd::allocator<T>>
+namespace impl
+{
+// default bytes of one deque buffer
+inline constexpr std::size_t deque_default_block_bytes = 4096;
+
+// elements in one deque buffer: the largest power of 2 that fits in BlockBytes, at least 1
+template<typename T, std::size_t BlockBytes>
+inline constexpr std::size_t deque_block_elements = std::bit_floor(BlockBytes / sizeof(T) > 1 ? BlockBytes / sizeof(T) : std::size_t(1));
+} // namespace impl
+
+// BlockBytes: bytes of one buffer, elements in a buffer are rounded down to a power of 2,
+// so locating an element by index is a shift and a mask.
+template<typename T, typename Allocator = tstd::allocator<T>, std::size_t BlockBytes = impl::deque_default_block_bytes>
 class deque
 {
 private:
     // inline static varaible does not need definition outside class, constexpr static variable is implicitly inline
-    inline constexpr static std::size_t ElemSize = 64; // elements in one buffer
+    inline constexpr static std::size_t ElemSize = impl::deque_block_elements<T, BlockBytes>; // elements in one buffer
+    inline constexpr static std::size_t ElemShift = std::countr_zero(ElemSize);
+    inline constexpr static std::size_t ElemMask = ElemSize - 1;
     inline constexpr static std::size_t initial_map_size = 8; // minimum map size
+    inline constexpr static std::size_t max_spare_nodes = 2; // buffers kept for reuse instead of being freed
     // iterator
     template<typename T2, typename Ref, typename Ptr, std::size_t _ElemSize>
     struct __deque_iterator
@@ -59,6 +76,40 @@ private:
             first = *new_node;
             last = first + _ElemSize;
         }
+        // segmented iterator protocol, buffers are the segments
+        using segment_iterator = map_pointer;
+        using local_iterator = Ptr;
+        segment_iterator segment() const
+        {
+            return node;
+        }
+        local_iterator local() const
+        {
+            return cur;
+        }
+        static local_iterator segment_begin(segment_iterator seg)
+        {
+            return *seg;
+        }
+        static local_iterator segment_end(segment_iterator seg)
+        {
+            return *seg + _ElemSize;
+        }
+        static self compose(segment_iterator seg, local_iterator local)
+        {
+            self iter;
+            if (local == segment_end(seg)) // end of a buffer is represented by the begin of next buffer
+            {
+                iter.set_node(seg + 1);
+                iter.cur = iter.first;
+            }
+            else
+            {
+                iter.set_node(seg);
+                iter.cur = const_cast<T*>(local);
+            }
+            return iter;
+        }
         reference operator*() const
         {
             return *cur;
@@ -115,12 +166,12 @@ private:
             // not in same buffer
             else
             {
-                difference_type node_offset = offset > 0 ? offset / difference_type(_ElemSize)
-                    : - difference_type((-offset - 1) / _ElemSize) - 1; // -ElemSize -> -1, -ElemSize-1 -> -2
+                // _ElemSize is a power of 2, arithmetic shift rounds down: -ElemSize -> -1, -ElemSize-1 -> -2
+                difference_type node_offset = offset >> std::countr_zero(_ElemSize);
                 // switch to correct buffer
                 set_node(node + node_offset);
                 // switch to correct element
-                cur = first + (offset - node_offset * difference_type(_ElemSize));
+                cur = first + (offset & difference_type(_ElemSize - 1));
             }
             return *this;
         }
@@ -189,24 +240,47 @@ private:
     iterator start, finish;     // begin() and end() iterator
     allocator_type alloc;       // allocator of elements
     map_allocator map_alloc;    // allocator of map
+    // buffers freed by pop_front/pop_back/erase are cached and handed out to the next allocate_node of either end,
+    // a queue with steady length allocates nothing after warming up
+    pointer spare_nodes[max_spare_nodes] = {};
+    size_type spare_count = 0;
 private:
     // auxiliary functions
-    // allocate one buffer
+    // allocate one buffer, reuse a cached one if any
     pointer allocate_node()
     {
+        if (spare_count > 0)
+        {
+            return spare_nodes[--spare_count];
+        }
         return alloc.allocate(ElemSize);
     }
+    // free one buffer, keep it in cache if cache is not full
     void deallocate_node(pointer p)
     {
+        if (spare_count < max_spare_nodes)
+        {
+            spare_nodes[spare_count++] = p;
+            return;
+        }
         alloc.deallocate(p, ElemSize);
     }
+    // free all cached buffers
+    void release_spare_nodes()
+    {
+        for (; spare_count > 0; --spare_count)
+        {
+            alloc.deallocate(spare_nodes[spare_count - 1], ElemSize);
+        }
+    }
     // get ready for all memory
     void create_map_and_nodes(size_type num_elements)
     {
-        size_type num_nodes = num_elements / ElemSize + 1;
-        map_size = tstd::max(initial_map_size, num_nodes + 2);
-        map = map_alloc.allocate(map_size);
-        for (int i = 0; i < map_size; ++i)
+        size_type num_nodes = (num_elements >> ElemShift) + 1;
+        auto result = impl::_allocate_at_least(map_alloc, tstd::max(initial_map_size, num_nodes + 2));
+        map = result.ptr;
+        map_size = result.count; // spare slots of the block are used by the map
+        for (size_type i = 0; i < map_size; ++i)
         {
             map[i] = nullptr;
         }
@@ -220,7 +294,7 @@ private:
         start.set_node(node_start);
         finish.set_node(node_finish);
         start.cur = start.first;
-        finish.cur = finish.first + num_elements % ElemSize;
+        finish.cur = finish.first + (num_elements & ElemMask);
     }
     // get ready for memory and fill all values
     void fill_initialize(size_type n, const value_type& value)
@@ -254,8 +328,11 @@ private:
         map_size = other.map_size;
         start = other.start;
         finish = other.finish;
+        tstd::copy_n(other.spare_nodes, other.spare_count, spare_nodes);
+        spare_count = other.spare_count;
         other.map = nullptr;
         other.map_size = 0;
+        other.spare_count = 0;
         other.create_map_and_nodes(0); // keep other in a valid state
     }
     template<typename InputIterator>
@@ -280,7 +357,7 @@ private:
             reallocate_map(nodes_to_add, true);
         }
     }
-    // reallocate map: allocate new map, copy and release old map
+    // reallocate map: recentre nodes in old map if it is at least double of nodes, otherwise allocate new map, copy and release old map
     // every time new map size should be at least double of current number of nodes
     void reallocate_map(size_type nodes_to_add, bool add_at_front)
     {
@@ -290,21 +367,15 @@ private:
         if (map_size > 2 * new_num_nodes) // use old map
         {
             new_start = map + (map_size - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
-            if (new_start < start.node)
-            {
-                tstd::copy(start.node, finish.node + 1, new_start);
-            }
-            else
-            {
-                tstd::copy_backward(start.node, finish.node + 1, new_start + old_num_nodes);
-            }
+            impl::_memmove_n(start.node, old_num_nodes, new_start); // nodes are pointers, memmove handles overlapping
         }
         else // allocate a new map
         {
-            size_type new_map_size = map_size + tstd::max(map_size, nodes_to_add) + 2;
-            map_pointer new_map = map_alloc.allocate(new_map_size);
+            auto result = impl::_allocate_at_least(map_alloc, map_size + tstd::max(map_size, nodes_to_add) + 2);
+            size_type new_map_size = result.count;
+            map_pointer new_map = result.ptr;
             new_start = new_map + (new_map_size - new_num_nodes) / 2 + (add_at_front ? nodes_to_add : 0);
-            tstd::copy(start.node, finish.node + 1, new_start);
+            impl::_memmove_n(start.node, old_num_nodes, new_start);
             map_alloc.deallocate(map, map_size);
             map = new_map;
             map_size = new_map_size;
@@ -323,6 +394,7 @@ private:
             }
             map_alloc.deallocate(map, map_size);
         }
+        release_spare_nodes();
         map = nullptr;
         map_size = 0;
     }
@@ -347,7 +419,7 @@ private:
         iterator insert_pos = const_iterator_to_iterator(pos);
         if (index < size() / 2) // insert to front
         {
-            size_type nodes_to_add = (elems_num - (start.cur - start.first) - 1 + ElemSize) / ElemSize;
+            size_type nodes_to_add = (elems_num - (start.cur - start.first) - 1 + ElemSize) >> ElemShift;
             reserve_map_at_front(nodes_to_add);
             for (map_pointer node = start.node - nodes_to_add; node < start.node; ++node)
             {
@@ -360,7 +432,7 @@ private:
         }
         else // insert to back
         {
-            size_type nodes_to_add = (elems_num - (finish.last - finish.cur) + ElemSize) / ElemSize;
+            size_type nodes_to_add = (elems_num - (finish.last - finish.cur) + ElemSize) >> ElemShift;
             reserve_map_at_back(nodes_to_add);
             for (map_pointer node = finish.node + nodes_to_add; node > finish.node; --node)
             {
@@ -373,6 +445,12 @@ private:
         }
         return insert_pos;
     }
+    // element of index pos, offset from the first buffer is split by a shift and a mask
+    reference element_at(size_type pos) const
+    {
+        size_type offset = pos + static_cast<size_type>(start.cur - start.first);
+        return start.node[offset >> ElemShift][offset & ElemMask];
+    }
     // convert const_iterator to iterator
     iterator const_iterator_to_iterator(const_iterator iter)
     {
@@ -490,7 +568,15 @@ public:
     {
         clear_elements();
         release_map();
-        move_from(std::move(other));
+        if (alloc == other.alloc)
+        {
+            move_from(std::move(other));
+        }
+        else // buffers of other could not be freed by alloc, move every element
+        {
+            move_initialize(other.size(), other.begin(), other.end());
+            other.clear();
+        }
         return *this;
     }
     deque& operator=(std::initializer_list<T> il) // 3
@@ -533,26 +619,26 @@ public:
         {
             throw std::out_of_range("deque::at : input index is out of bounds");
         }
-        return *(start + pos);
+        return element_at(pos);
     }
     const_reference at(size_type pos) const
     {
         assert(pos < size());
-        if (pos >= size)
+        if (pos >= size())
         {
             throw std::out_of_range("deque::at : input index is out of bounds");
         }
-        return *(start + pos);
+        return element_at(pos);
     }
     reference operator[](size_type pos)
     {
         assert(pos < size());
-        return *(start + pos);
+        return element_at(pos);
     }
     const_reference operator[](size_type pos) const
     {
         assert(pos < size());
-        return *(start + pos);
+        return element_at(pos);
     }
     reference front()
     {
@@ -638,7 +724,13 @@ public:
     }
     void shrink_to_fit()
     {
-        // buffers are freed dynamically, so do nothing.
+        // buffers are freed dynamically, only cached buffers need to be freed.
+        release_spare_nodes();
+    }
+    // non-standard: buffers kept for reuse
+    size_type spare_buffers() const noexcept
+    {
+        return spare_count;
     }
     // modifiers
     void clear() noexcept
@@ -706,6 +798,10 @@ public:
     {
         iterator _first = const_iterator_to_iterator(first);
         iterator _last = const_iterator_to_iterator(last);
+        if (_first == _last) // nothing to erase, moving elements onto themselves would be self-move-assignment
+        {
+            return _first;
+        }
         if (_first == start && _last == finish) // erase all elements
         {
             clear();
@@ -753,7 +849,7 @@ public:
             alloc.construct(finish.cur, value);
             ++finish.cur;
         }
-        else // only one element space left in last buffer
+        else [[unlikely]] // only one element space left in last buffer
         {
             reserve_map_at_back();
             *(finish.node + 1) = allocate_node();
@@ -769,7 +865,7 @@ public:
             alloc.construct(finish.cur, std::move(value));
             ++finish.cur;
         }
-        else // only one element space left in last buffer
+        else [[unlikely]] // only one element space left in last buffer
         {
             reserve_map_at_back();
             *(finish.node + 1) = allocate_node();
@@ -786,7 +882,7 @@ public:
             alloc.construct(finish.cur, std::forward<Args>(args)...);
             ++finish.cur;
         }
-        else // only one element space left in last buffer
+        else [[unlikely]] // only one element space left in last buffer
         {
             reserve_map_at_back();
             *(finish.node + 1) = allocate_node();
@@ -804,7 +900,7 @@ public:
             --finish.cur;
             alloc.destroy(finish.cur);
         }
-        else // only one element in last buffer
+        else [[unlikely]] // only one element in last buffer
         {
             deallocate_node(finish.first);
             finish.set_node(finish.node - 1);
@@ -814,13 +910,12 @@ public:
     }
     void push_front(const T& value) // 1
     {
-        assert(!empty());
         if (start.cur > start.first) // first buffer is not full
         {
             alloc.construct(start.cur - 1, value);
             --start.cur;
         }
-        else // first buffer is full
+        else [[unlikely]] // first buffer is full
         {
             reserve_map_at_front();
             *(start.node - 1) = allocate_node();
@@ -836,7 +931,7 @@ public:
             alloc.construct(start.cur - 1, std::move(value));
             --start.cur;
         }
-        else // first buffer is full
+        else [[unlikely]] // first buffer is full
         {
             reserve_map_at_front();
             *(start.node - 1) = allocate_node();
@@ -853,7 +948,7 @@ public:
             alloc.construct(start.cur - 1, std::forward<Args>(args)...);
             --start.cur;
         }
-        else // first buffer is full
+        else [[unlikely]] // first buffer is full
         {
             reserve_map_at_front();
             *(start.node - 1) = allocate_node();
@@ -871,7 +966,7 @@ public:
             alloc.destroy(start.cur);
             ++start.cur;
         }
-        else // only one element in first buffer
+        else [[unlikely]] // only one element in first buffer
         {
             alloc.destroy(start.cur);
             deallocate_node(start.first);
@@ -913,14 +1008,16 @@ public:
         tstd::swap(map_size, other.map_size);
         tstd::swap(start, other.start);
         tstd::swap(finish, other.finish);
+        tstd::swap_ranges(spare_nodes, spare_nodes + max_spare_nodes, other.spare_nodes);
+        tstd::swap(spare_count, other.spare_count);
     }
 };
 
 // non-member operations
 // a non-standard compare function for tstd::deque
 // equal 0 less -1 greater 1
-template<typename T, typename Allocator>
-constexpr int _cmp_deque(const tstd::deque<T, Allocator>& lhs, const tstd::deque<T, Allocator>& rhs)
+template<typename T, typename Allocator, std::size_t BlockBytes>
+constexpr int _cmp_deque(const tstd::deque<T, Allocator, BlockBytes>& lhs, const tstd::deque<T, Allocator, BlockBytes>& rhs)
 {
     auto iter1 = lhs.begin();
     auto iter2 = rhs.begin();
@@ -944,44 +1041,54 @@ constexpr int _cmp_deque(const tstd::deque<T, Allocator>& lhs, const tstd::deque
 }
 
 // comparisons
-template<typename T, typename Allocator>
-constexpr bool operator==(const tstd::deque<T, Allocator>& lhs, const tstd::deque<T, Allocator>& rhs)
+template<typename T, typename Allocator, std::size_t BlockBytes>
+constexpr bool operator==(const tstd::deque<T, Allocator, BlockBytes>& lhs, const tstd::deque<T, Allocator, BlockBytes>& rhs)
 {
-    return _cmp_deque(lhs, rhs) == 0;
+    return lhs.size() == rhs.size() && tstd::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
-template<typename T, typename Allocator>
-constexpr bool operator!=(const tstd::deque<T, Allocator>& lhs, const tstd::deque<T, Allocator>& rhs)
+template<typename T, typename Allocator, std::size_t BlockBytes>
+constexpr bool operator!=(const tstd::deque<T, Allocator, BlockBytes>& lhs, const tstd::deque<T, Allocator, BlockBytes>& rhs)
 {
-    return _cmp_deque(lhs, rhs) != 0;
+    return !(lhs == rhs);
 }
-template<typename T, typename Allocator>
-constexpr bool operator<(const tstd::deque<T, Allocator>& lhs, const tstd::deque<T, Allocator>& rhs)
+template<typename T, typename Allocator, std::size_t BlockBytes>
+constexpr bool operator<(const tstd::deque<T, Allocator, BlockBytes>& lhs, const tstd::deque<T, Allocator, BlockBytes>& rhs)
 {
     return _cmp_deque(lhs, rhs) < 0;
 }
-template<typename T, typename Allocator>
-constexpr bool operator<=(const tstd::deque<T, Allocator>& lhs, const tstd::deque<T, Allocator>& rhs)
+template<typename T, typename Allocator, std::size_t BlockBytes>
+constexpr bool operator<=(const tstd::deque<T, Allocator, BlockBytes>& lhs, const tstd::deque<T, Allocator, BlockBytes>& rhs)
 {
     return _cmp_deque(lhs, rhs) <= 0;
 }
-template<typename T, typename Allocator>
-constexpr bool operator>(const tstd::deque<T, Allocator>& lhs, const tstd::deque<T, Allocator>& rhs)
+template<typename T, typename Allocator, std::size_t BlockBytes>
+constexpr bool operator>(const tstd::deque<T, Allocator, BlockBytes>& lhs, const tstd::deque<T, Allocator, BlockBytes>& rhs)
 {
     return _cmp_deque(lhs, rhs) > 0;
 }
-template<typename T, typename Allocator>
-constexpr bool operator>=(const tstd::deque<T, Allocator>& lhs, const tstd::deque<T, Allocator>& rhs)
+template<typename T, typename Allocator, std::size_t BlockBytes>
+constexpr bool operator>=(const tstd::deque<T, Allocator, BlockBytes>& lhs, const tstd::deque<T, Allocator, BlockBytes>& rhs)
 {
     return _cmp_deque(lhs, rhs) >= 0;
 }
 
 // global swap for tstd::deque
-template<typename T, typename Allocator>
-constexpr void swap(tstd::deque<T, Allocator>& lhs, tstd::deque<T, Allocator>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template<typename T, typename Allocator, std::size_t BlockBytes>
+constexpr void swap(tstd::deque<T, Allocator, BlockBytes>& lhs, tstd::deque<T, Allocator, BlockBytes>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
 
+// deque only holds pointers to its heap storage, could be relocated bitwise if its allocator could.
+template<typename T, typename Allocator, std::size_t BlockBytes>
+struct is_trivially_relocatable<tstd::deque<T, Allocator, BlockBytes>> : is_trivially_relocatable<Allocator> {};
+
+namespace pmr
+{
+template<typename T>
+using deque = tstd::deque<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
 } // namespace tstd
 
 
@@ -2,6 +2,7 @@
 #define TFORWROD_LIST_HPP
 
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <cstddef>
 #include <initializer_list>
 #include <type_traits>
@@ -373,7 +374,17 @@ public:
     forward_list& operator=(forward_list&& other) // 2
     {
         free_all_elements();
-        move_from(std::move(other));
+        if (alloc == other.alloc)
+        {
+            move_from(std::move(other));
+        }
+        else // nodes of other could not be freed by node_alloc, move every element
+        {
+            link_type first = nullptr, last = nullptr;
+            construct_a_link(first, last, tstd::make_move_iterator(other.begin()), tstd::make_move_iterator(other.end()));
+            insert_after_impl(node, first, last);
+            other.clear();
+        }
         return *this;
     }
     forward_list& operator=(std::initializer_list<T> il) // 3
@@ -859,6 +870,12 @@ constexpr void swap(tstd::forward_list<T, Allocator>& lhs, tstd::forward_list<T,
     lhs.swap(rhs);
 }
 
+namespace pmr
+{
+template<typename T>
+using forward_list = tstd::forward_list<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
 } // namespace tstd
 
 
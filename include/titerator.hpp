@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <iterator>
+#include <concepts>
 
 namespace tstd
 {
@@ -452,7 +453,7 @@ constexpr void advance(InputIterator& it, Distance n)
 }
 
 template<typename InputIterator>
-typename std::iterator_traits<InputIterator>::difference_type distance(InputIterator first, InputIterator last)
+constexpr typename std::iterator_traits<InputIterator>::difference_type distance(InputIterator first, InputIterator last)
 {
     using category = typename std::iterator_traits<InputIterator>::iterator_category;
     static_assert(std::is_base_of_v<std::input_iterator_tag, category>);
@@ -632,6 +633,65 @@ constexpr const E* data(std::initializer_list<E> il) noexcept
     return il.begin();
 }
 
+// segmented iterators
+// An iterator over a sequence of contiguous segments (e.g. buffers of tstd::deque) exposes them by:
+//   Iterator::segment_iterator, Iterator::local_iterator: iterator of segments and iterator inside one segment,
+//   it.segment(), it.local(): segment of it and its position in the segment,
+//   Iterator::segment_begin(seg), Iterator::segment_end(seg): range of the whole segment,
+//   Iterator::compose(seg, local): iterator of position local in segment seg, local may be segment_end(seg).
+// Algorithms use it to run a plain loop over every segment instead of checking segment boundary in every ++.
+template<typename Iterator>
+concept segmented_iterator = requires(const Iterator& it, typename Iterator::segment_iterator seg, typename Iterator::local_iterator local)
+{
+    { it.segment() } -> std::same_as<typename Iterator::segment_iterator>;
+    { it.local() } -> std::same_as<typename Iterator::local_iterator>;
+    { Iterator::segment_begin(seg) } -> std::same_as<typename Iterator::local_iterator>;
+    { Iterator::segment_end(seg) } -> std::same_as<typename Iterator::local_iterator>;
+    { Iterator::compose(seg, local) } -> std::same_as<Iterator>;
+};
+
+namespace impl
+{
+// call f(local_first, local_last) for every piece of segments in [first, last)
+template<tstd::segmented_iterator Iterator, typename Function>
+constexpr void _for_each_segment(Iterator first, Iterator last, Function f)
+{
+    auto seg_first = first.segment();
+    auto seg_last = last.segment();
+    if (seg_first == seg_last)
+    {
+        f(first.local(), last.local());
+        return;
+    }
+    f(first.local(), Iterator::segment_end(seg_first));
+    for (++seg_first; seg_first != seg_last; ++seg_first)
+    {
+        f(Iterator::segment_begin(seg_first), Iterator::segment_end(seg_first));
+    }
+    f(Iterator::segment_begin(seg_last), last.local());
+}
+
+// find the first position in [first, last) where search(local_first, local_last) does not return local_last
+template<tstd::segmented_iterator Iterator, typename Search>
+constexpr Iterator _search_segments(Iterator first, Iterator last, Search search)
+{
+    auto seg_first = first.segment();
+    auto seg_last = last.segment();
+    auto local_first = first.local();
+    while (seg_first != seg_last)
+    {
+        auto local_last = Iterator::segment_end(seg_first);
+        auto iter = search(local_first, local_last);
+        if (iter != local_last)
+        {
+            return Iterator::compose(seg_first, iter);
+        }
+        local_first = Iterator::segment_begin(++seg_first);
+    }
+    return Iterator::compose(seg_last, search(local_first, last.local()));
+}
+} // namespace impl
+
 } // namespace tstd
 
 
@@ -2,6 +2,7 @@
 #define TLIST_HPP
 
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <tstl_uninitialized.hpp>
 #include <titerator.hpp>
 #include <tutility.hpp>
@@ -20,10 +21,13 @@ class list
 private:
     // nested classes
     // list node
+    struct list_node;
+    // links are Allocator::pointer rebound to node, could be fancy pointers (e.g. 32-bit slab_ptr of slab_allocator)
+    using link_type = typename std::pointer_traits<typename std::allocator_traits<Allocator>::pointer>::template rebind<list_node>;
     struct list_node
     {
-        list_node* next;
-        list_node* prev;
+        link_type next;
+        link_type prev;
         T data;
     };
     // iterator
@@ -39,7 +43,6 @@ private:
         using iterator = __list_iterator<T2, T2&, T2*>;
         using self = __list_iterator<T2, Ref, Ptr>;
         using size_type = std::size_t;
-        using link_type = list_node*;
         link_type node; // pointer to node of linked list
 
         __list_iterator(link_type _node) : node(_node) {}
@@ -98,7 +101,6 @@ public:
     using reverse_iterator = tstd::reverse_iterator<iterator>;
     using const_reverse_iterator = tstd::reverse_iterator<const_iterator>;
 private:
-    using link_type = list_node*;
     using node_allocator_type = typename Allocator::template rebind<list_node>::other;
     // cyclic doubly linked list, next point to first element, prev point to last element(and node represent end()), only one pointer could represent the whole list
     link_type node;
@@ -404,7 +406,17 @@ public:
     list& operator=(list&& other) noexcept(std::allocator_traits<Allocator>::is_always_equal::value)
     {
         free_all_elements();
-        move_from(std::move(other));
+        if (alloc == other.alloc)
+        {
+            move_from(std::move(other));
+        }
+        else // nodes of other could not be freed by node_alloc, move every element
+        {
+            link_type first = nullptr, last = nullptr;
+            construct_a_link(first, last, tstd::make_move_iterator(other.begin()), tstd::make_move_iterator(other.end()));
+            insert_before(node, first, last);
+            other.clear();
+        }
         return *this;
     }
     list& operator=(std::initializer_list<T> il)
@@ -975,6 +987,12 @@ constexpr void swap(tstd::list<T, Allocator>& lhs, tstd::list<T, Allocator>& rhs
     lhs.swap(rhs);
 }
 
+namespace pmr
+{
+template<typename T>
+using list = tstd::list<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
 } // namespace tstd
 
 #endif // TLIST_HPP
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <tuple>
 #include <stdexcept>
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <titerator.hpp>
 #include <tstl_bst.hpp>
 #include <tstl_rbtree.hpp>
@@ -571,6 +572,12 @@ void swap(tstd::map<Key, T, Compare, Allocator, UnderlyingTree>& lhs, tstd::map<
     lhs.swap(rhs);
 }
 
+namespace pmr
+{
+template<typename Key, typename T, typename Compare = std::less<Key>>
+using map = tstd::map<Key, T, Compare, polymorphic_allocator<std::pair<const Key, T>>>;
+} // namespace pmr
+
 } // namespace tstd
 
 
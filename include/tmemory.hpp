@@ -2,6 +2,17 @@
 #define TMEMORY_HPP
 
 #include <tstl_allocator.hpp>
+#include <tstl_pool_allocator.hpp>
+#include <tstl_thread_cache_allocator.hpp>
+#include <tstl_aligned_allocator.hpp>
+#include <tstl_mmap_allocator.hpp>
+#include <tstl_slab_allocator.hpp>
+#include <tstl_mapped_file_allocator.hpp>
+#include <tstl_inline_arena_allocator.hpp>
+#include <tstl_counting_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <tstl_uninitialized.hpp>
+#include <tstl_unique_ptr.hpp>
+#include <tstl_shared_ptr.hpp>
 
 #endif
\ No newline at end of file
@@ -0,0 +1,640 @@
+#ifndef TMEMORY_RESOURCE_HPP
+#define TMEMORY_RESOURCE_HPP
+
+#include <tstl_allocator.hpp>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace tstd
+{
+
+namespace pmr
+{
+
+// memory_resource: abstract interface of memory resources
+class memory_resource
+{
+private:
+    inline constexpr static std::size_t max_align = alignof(std::max_align_t);
+public:
+    memory_resource() = default;
+    memory_resource(const memory_resource&) = default;
+    virtual ~memory_resource() = default;
+    memory_resource& operator=(const memory_resource&) = default;
+
+    [[nodiscard]] void* allocate(std::size_t bytes, std::size_t alignment = max_align)
+    {
+        return do_allocate(bytes, alignment);
+    }
+    void deallocate(void* p, std::size_t bytes, std::size_t alignment = max_align)
+    {
+        do_deallocate(p, bytes, alignment);
+    }
+    bool is_equal(const memory_resource& other) const noexcept
+    {
+        return do_is_equal(other);
+    }
+private:
+    virtual void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+    virtual void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) = 0;
+    virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+};
+
+inline bool operator==(const memory_resource& a, const memory_resource& b) noexcept
+{
+    return &a == &b || a.is_equal(b);
+}
+inline bool operator!=(const memory_resource& a, const memory_resource& b) noexcept
+{
+    return !(a == b);
+}
+
+namespace impl
+{
+
+// resource of new_delete_resource()
+class new_delete_memory_resource : public memory_resource
+{
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+        return ::operator new(bytes);
+    }
+    void do_deallocate(void* p, [[maybe_unused]] std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            ::operator delete(p, std::align_val_t(alignment));
+        }
+        else
+        {
+            ::operator delete(p);
+        }
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+// resource of null_memory_resource()
+class null_memory_resource : public memory_resource
+{
+private:
+    void* do_allocate([[maybe_unused]] std::size_t bytes, [[maybe_unused]] std::size_t alignment) override
+    {
+        throw std::bad_alloc();
+    }
+    void do_deallocate([[maybe_unused]] void* p, [[maybe_unused]] std::size_t bytes, [[maybe_unused]] std::size_t alignment) override
+    {
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+constexpr std::size_t align_up(std::size_t n, std::size_t alignment) noexcept
+{
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace impl
+
+// a resource that uses ::operator new and ::operator delete
+inline memory_resource* new_delete_resource() noexcept
+{
+    static impl::new_delete_memory_resource resource;
+    return &resource;
+}
+
+// a resource that does not allocate, always throw std::bad_alloc
+inline memory_resource* null_memory_resource() noexcept
+{
+    static impl::null_memory_resource resource;
+    return &resource;
+}
+
+namespace impl
+{
+
+inline std::atomic<memory_resource*>& default_resource() noexcept
+{
+    static std::atomic<memory_resource*> resource(new_delete_resource());
+    return resource;
+}
+
+} // namespace impl
+
+// set default resource, nullptr means new_delete_resource(), return the previous one
+inline memory_resource* set_default_resource(memory_resource* r) noexcept
+{
+    if (r == nullptr)
+    {
+        r = new_delete_resource();
+    }
+    return impl::default_resource().exchange(r);
+}
+
+inline memory_resource* get_default_resource() noexcept
+{
+    return impl::default_resource().load();
+}
+
+// polymorphic_allocator: allocate memory from a memory_resource
+// Unlike std::pmr::polymorphic_allocator it is assignable, because containers of tstd propagate allocators on assignment.
+template<typename T>
+class polymorphic_allocator
+{
+    template<typename U> friend class polymorphic_allocator;
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    template<typename U> struct rebind {
+        using other = polymorphic_allocator<U>;
+    };
+
+    polymorphic_allocator() noexcept
+        : mem_resource(get_default_resource())
+    {
+    }
+    polymorphic_allocator(memory_resource* r)
+        : mem_resource(r)
+    {
+    }
+    polymorphic_allocator(const polymorphic_allocator& other) = default;
+    template<typename U>
+    polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept
+        : mem_resource(other.mem_resource)
+    {
+    }
+    polymorphic_allocator& operator=(const polymorphic_allocator& other) = default;
+
+    [[nodiscard]] T* allocate(size_type n)
+    {
+        if (n > max_size())
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(mem_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, size_type n)
+    {
+        mem_resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+    // uses-allocator construction: pass the allocator to elements that accept it (nested pmr containers)
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        if constexpr (std::uses_allocator_v<U, polymorphic_allocator> && std::is_constructible_v<U, Args..., const polymorphic_allocator&>)
+        {
+            ::new (static_cast<void*>(p)) U(std::forward<Args>(args)..., *this);
+        }
+        else
+        {
+            tstd::impl::_construct(p, std::forward<Args>(args)...);
+        }
+    }
+    template<typename U>
+    void destroy(U* p)
+    {
+        tstd::impl::_destroy(p);
+    }
+    size_type max_size() const noexcept
+    {
+        return static_cast<size_type>(std::numeric_limits<size_t>::max() / sizeof(T));
+    }
+    // copy of a container get the default resource
+    polymorphic_allocator select_on_container_copy_construction() const
+    {
+        return polymorphic_allocator();
+    }
+    memory_resource* resource() const noexcept
+    {
+        return mem_resource;
+    }
+private:
+    memory_resource* mem_resource;
+};
+
+template<typename T1, typename T2>
+bool operator==(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs) noexcept
+{
+    return *lhs.resource() == *rhs.resource();
+}
+template<typename T1, typename T2>
+bool operator!=(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// options of pool resources
+struct pool_options
+{
+    std::size_t max_blocks_per_chunk = 0;           // 0 means implementation-defined default
+    std::size_t largest_required_pool_block = 0;    // 0 means implementation-defined default
+};
+
+// monotonic_buffer_resource: allocate from a buffer by bumping a pointer, deallocation does nothing,
+// all memory is freed at once when it is destroyed or release() is called.
+// When the buffer is exhausted, a new buffer (geometrically larger) is got from upstream.
+class monotonic_buffer_resource : public memory_resource
+{
+private:
+    inline constexpr static std::size_t default_buffer_size = 1024;
+    inline constexpr static std::size_t growth_factor = 2;
+    // header of buffers got from upstream, located at the end of buffer
+    struct chunk
+    {
+        chunk* next;
+        void* base;
+        std::size_t size;
+        std::size_t alignment;
+    };
+public:
+    explicit monotonic_buffer_resource(memory_resource* _upstream)
+        : upstream(_upstream)
+    {
+    }
+    monotonic_buffer_resource(std::size_t _initial_size, memory_resource* _upstream)
+        : next_buffer_size(_initial_size > 0 ? _initial_size : 1)
+        , upstream(_upstream)
+    {
+    }
+    monotonic_buffer_resource(void* buffer, std::size_t buffer_size, memory_resource* _upstream)
+        : initial_buffer(buffer)
+        , initial_size(buffer_size)
+        , current(static_cast<char*>(buffer))
+        , space(buffer_size)
+        , next_buffer_size(buffer_size * growth_factor > 0 ? buffer_size * growth_factor : 1)
+        , upstream(_upstream)
+    {
+    }
+    monotonic_buffer_resource()
+        : monotonic_buffer_resource(get_default_resource())
+    {
+    }
+    explicit monotonic_buffer_resource(std::size_t _initial_size)
+        : monotonic_buffer_resource(_initial_size, get_default_resource())
+    {
+    }
+    monotonic_buffer_resource(void* buffer, std::size_t buffer_size)
+        : monotonic_buffer_resource(buffer, buffer_size, get_default_resource())
+    {
+    }
+    monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+    monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+    ~monotonic_buffer_resource() override
+    {
+        release();
+    }
+    // free all buffers got from upstream, reuse the initial buffer
+    void release()
+    {
+        while (chunks)
+        {
+            chunk* next = chunks->next;
+            upstream->deallocate(chunks->base, chunks->size, chunks->alignment);
+            chunks = next;
+        }
+        current = static_cast<char*>(initial_buffer);
+        space = initial_size;
+    }
+    memory_resource* upstream_resource() const
+    {
+        return upstream;
+    }
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        if (bytes == 0)
+        {
+            bytes = 1;
+        }
+        void* p = current;
+        if (std::align(alignment, bytes, p, space) == nullptr)
+        {
+            new_buffer(bytes, alignment);
+            p = current;
+            std::align(alignment, bytes, p, space);
+        }
+        current = static_cast<char*>(p) + bytes;
+        space -= bytes;
+        return p;
+    }
+    void do_deallocate([[maybe_unused]] void* p, [[maybe_unused]] std::size_t bytes, [[maybe_unused]] std::size_t alignment) override
+    {
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+    // get a new buffer that could hold at least bytes with alignment
+    void new_buffer(std::size_t bytes, std::size_t alignment)
+    {
+        std::size_t buffer_alignment = alignment > alignof(chunk) ? alignment : alignof(chunk);
+        std::size_t usable = next_buffer_size;
+        if (usable < bytes)
+        {
+            usable = bytes;
+        }
+        usable = impl::align_up(usable, alignof(chunk));
+        std::size_t size = usable + sizeof(chunk);
+        void* base = upstream->allocate(size, buffer_alignment);
+        chunk* c = ::new (static_cast<char*>(base) + usable) chunk{chunks, base, size, buffer_alignment};
+        chunks = c;
+        current = static_cast<char*>(base);
+        space = usable;
+        next_buffer_size = usable * growth_factor;
+    }
+private:
+    void* initial_buffer = nullptr;
+    std::size_t initial_size = 0;
+    char* current = nullptr;    // start of free space of current buffer
+    std::size_t space = 0;      // size of free space of current buffer
+    std::size_t next_buffer_size = default_buffer_size;
+    chunk* chunks = nullptr;    // buffers got from upstream
+    memory_resource* upstream;
+};
+
+// unsynchronized_pool_resource: pools of different block sizes (power of 2), every pool is a free list of
+// blocks carved from chunks got from upstream, chunks grow geometrically until max_blocks_per_chunk.
+// Blocks larger than largest_required_pool_block are allocated from upstream directly.
+// Deallocation of a block puts it back to its pool, all memory is returned to upstream on release().
+class unsynchronized_pool_resource : public memory_resource
+{
+private:
+    inline constexpr static std::size_t min_block_size = 8;
+    inline constexpr static std::size_t default_largest_block = 4096;
+    inline constexpr static std::size_t max_largest_block = std::size_t(1) << 20;
+    inline constexpr static std::size_t default_max_blocks = 1024;
+    inline constexpr static std::size_t initial_blocks = 16;
+    inline constexpr static std::size_t max_pool_count = 64;
+    struct free_block
+    {
+        free_block* next;
+    };
+    // header of chunks, located at the end of chunk
+    struct chunk
+    {
+        chunk* next;
+        void* base;
+        std::size_t size;
+        std::size_t alignment;
+    };
+    struct pool
+    {
+        std::size_t block_size = 0;
+        std::size_t next_blocks = initial_blocks; // blocks of next chunk
+        free_block* free_list = nullptr;
+        chunk* chunks = nullptr;
+    };
+    // header of large blocks (double linked list), located at the start of block
+    struct large_block
+    {
+        large_block* prev;
+        large_block* next;
+        void* base;
+        std::size_t size;
+        std::size_t alignment;
+    };
+public:
+    unsynchronized_pool_resource(const pool_options& _opts, memory_resource* _upstream)
+        : opts(normalize(_opts))
+        , upstream(_upstream)
+    {
+        for (std::size_t size = min_block_size; size <= opts.largest_required_pool_block; size *= 2)
+        {
+            pools[pool_count++].block_size = size;
+        }
+    }
+    unsynchronized_pool_resource()
+        : unsynchronized_pool_resource(pool_options(), get_default_resource())
+    {
+    }
+    explicit unsynchronized_pool_resource(memory_resource* _upstream)
+        : unsynchronized_pool_resource(pool_options(), _upstream)
+    {
+    }
+    explicit unsynchronized_pool_resource(const pool_options& _opts)
+        : unsynchronized_pool_resource(_opts, get_default_resource())
+    {
+    }
+    unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+    unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+    ~unsynchronized_pool_resource() override
+    {
+        release();
+    }
+    // return all memory to upstream
+    void release()
+    {
+        for (std::size_t i = 0; i < pool_count; ++i)
+        {
+            pool& p = pools[i];
+            while (p.chunks)
+            {
+                chunk* next = p.chunks->next;
+                upstream->deallocate(p.chunks->base, p.chunks->size, p.chunks->alignment);
+                p.chunks = next;
+            }
+            p.free_list = nullptr;
+            p.next_blocks = initial_blocks;
+        }
+        while (large_blocks)
+        {
+            large_block* next = large_blocks->next;
+            upstream->deallocate(large_blocks->base, large_blocks->size, large_blocks->alignment);
+            large_blocks = next;
+        }
+    }
+    memory_resource* upstream_resource() const
+    {
+        return upstream;
+    }
+    pool_options options() const
+    {
+        return opts;
+    }
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        pool* p = find_pool(bytes, alignment);
+        if (p == nullptr)
+        {
+            return allocate_large(bytes, alignment);
+        }
+        if (p->free_list == nullptr)
+        {
+            refill(*p);
+        }
+        free_block* block = p->free_list;
+        p->free_list = block->next;
+        return block;
+    }
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        pool* p = find_pool(bytes, alignment);
+        if (p == nullptr)
+        {
+            deallocate_large(ptr);
+            return;
+        }
+        free_block* block = static_cast<free_block*>(ptr);
+        block->next = p->free_list;
+        p->free_list = block;
+    }
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+private:
+    static pool_options normalize(pool_options _opts)
+    {
+        if (_opts.max_blocks_per_chunk == 0)
+        {
+            _opts.max_blocks_per_chunk = default_max_blocks;
+        }
+        if (_opts.largest_required_pool_block == 0)
+        {
+            _opts.largest_required_pool_block = default_largest_block;
+        }
+        if (_opts.largest_required_pool_block > max_largest_block)
+        {
+            _opts.largest_required_pool_block = max_largest_block;
+        }
+        // round up to power of 2
+        std::size_t size = min_block_size;
+        while (size < _opts.largest_required_pool_block)
+        {
+            size *= 2;
+        }
+        _opts.largest_required_pool_block = size;
+        return _opts;
+    }
+    // block size is a power of 2 that is not less than alignment, so every block is aligned
+    pool* find_pool(std::size_t bytes, std::size_t alignment)
+    {
+        std::size_t size = bytes > alignment ? bytes : alignment;
+        if (size > opts.largest_required_pool_block)
+        {
+            return nullptr;
+        }
+        std::size_t index = 0;
+        while (pools[index].block_size < size)
+        {
+            ++index;
+        }
+        return &pools[index];
+    }
+    // get a new chunk from upstream and split it into blocks
+    void refill(pool& p)
+    {
+        std::size_t blocks = p.next_blocks;
+        std::size_t usable = blocks * p.block_size;
+        std::size_t size = usable + sizeof(chunk);
+        std::size_t alignment = p.block_size > alignof(chunk) ? p.block_size : alignof(chunk);
+        char* base = static_cast<char*>(upstream->allocate(size, alignment));
+        p.chunks = ::new (base + usable) chunk{p.chunks, base, size, alignment};
+        for (std::size_t i = blocks; i > 0; --i)
+        {
+            free_block* block = reinterpret_cast<free_block*>(base + (i - 1) * p.block_size);
+            block->next = p.free_list;
+            p.free_list = block;
+        }
+        p.next_blocks = blocks * 2 < opts.max_blocks_per_chunk ? blocks * 2 : opts.max_blocks_per_chunk;
+    }
+    // large blocks are prefixed with a header, header size is a multiple of alignment
+    static std::size_t large_header_size(std::size_t alignment)
+    {
+        return impl::align_up(sizeof(large_block), alignment > alignof(large_block) ? alignment : alignof(large_block));
+    }
+    void* allocate_large(std::size_t bytes, std::size_t alignment)
+    {
+        std::size_t header = large_header_size(alignment);
+        std::size_t block_alignment = alignment > alignof(large_block) ? alignment : alignof(large_block);
+        std::size_t size = header + bytes;
+        char* base = static_cast<char*>(upstream->allocate(size, block_alignment));
+        large_block* block = ::new (base + header - sizeof(large_block)) large_block{nullptr, large_blocks, base, size, block_alignment};
+        if (large_blocks)
+        {
+            large_blocks->prev = block;
+        }
+        large_blocks = block;
+        return base + header;
+    }
+    void deallocate_large(void* ptr)
+    {
+        large_block* block = reinterpret_cast<large_block*>(static_cast<char*>(ptr) - sizeof(large_block));
+        if (block->prev)
+        {
+            block->prev->next = block->next;
+        }
+        else
+        {
+            large_blocks = block->next;
+        }
+        if (block->next)
+        {
+            block->next->prev = block->prev;
+        }
+        upstream->deallocate(block->base, block->size, block->alignment);
+    }
+private:
+    pool_options opts;
+    memory_resource* upstream;
+    pool pools[max_pool_count];
+    std::size_t pool_count = 0;
+    large_block* large_blocks = nullptr;
+};
+
+// synchronized_pool_resource: thread-safe version of unsynchronized_pool_resource
+class synchronized_pool_resource : public unsynchronized_pool_resource
+{
+public:
+    using unsynchronized_pool_resource::unsynchronized_pool_resource;
+    synchronized_pool_resource()
+        : unsynchronized_pool_resource()
+    {
+    }
+    void release()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        unsynchronized_pool_resource::release();
+    }
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return unsynchronized_pool_resource::do_allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        unsynchronized_pool_resource::do_deallocate(p, bytes, alignment);
+    }
+private:
+    std::mutex lock;
+};
+
+} // namespace pmr
+
+} // namespace tstd
+
+#endif // TMEMORY_RESOURCE_HPP
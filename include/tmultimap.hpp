@@ -8,6 +8,7 @@
 #include <limits>
 #include <utility>
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <titerator.hpp>
 #include <tstl_bst.hpp>
 #include <tstl_rbtree.hpp>
@@ -454,6 +455,12 @@ void swap(tstd::multimap<Key, T, Compare, Allocator, UnderlyingTree>& lhs, tstd:
     lhs.swap(rhs);
 }
 
+namespace pmr
+{
+template<typename Key, typename T, typename Compare = std::less<Key>>
+using multimap = tstd::multimap<Key, T, Compare, polymorphic_allocator<std::pair<const Key, T>>>;
+} // namespace pmr
+
 } // namespace tstd
 
 
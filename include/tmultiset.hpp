@@ -8,6 +8,7 @@
 #include <limits>
 #include <utility>
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <titerator.hpp>
 #include <tstl_bst.hpp>
 #include <tstl_rbtree.hpp>
@@ -431,6 +432,12 @@ void swap(tstd::multiset<Key, Compare, Allocator, UnderlyingTree>& lhs, tstd::mu
     lhs.swap(rhs);
 }
 
+namespace pmr
+{
+template<typename Key, typename Compare = std::less<Key>>
+using multiset = tstd::multiset<Key, Compare, polymorphic_allocator<Key>>;
+} // namespace pmr
+
 } // namespace tstd
 
 #endif // TMULTISET_HPP
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <type_traits>
 #include <tstl_heap.hpp>
 #include <tutility.hpp>
+#include <titerator.hpp>
 
 namespace tstd
 {
@@ -42,6 +43,26 @@ constexpr T accumulate(InputIterator first, InputIterator last, T init, BinaryOp
     }
     return init;
 }
+// segmented iterators (e.g. iterators of tstd::deque): accumulate every segment by a plain loop
+template<segmented_iterator InputIterator, typename T>
+constexpr T accumulate(InputIterator first, InputIterator last, T init) // 1
+{
+    impl::_for_each_segment(first, last, [&init](auto local_first, auto local_last) {
+        init = tstd::accumulate(local_first, local_last, std::move(init));
+    });
+    return init;
+}
+template<segmented_iterator InputIterator, typename T, typename BinaryOperation>
+constexpr T accumulate(InputIterator first, InputIterator last, T init, BinaryOperation op) // 2
+{
+    impl::_for_each_segment(first, last, [&init, &op](auto local_first, auto local_last) {
+        for (; local_first != local_last; ++local_first)
+        {
+            init = op(std::move(init), *local_first);
+        }
+    });
+    return init;
+}
 
 // inner_product: compute the inner product of range [first1, last1) and the range begin at first2
 // complexity: last1-first1 appliation of multiply and addition / op1 and op2 and assgnment
@@ -0,0 +1,685 @@
+#ifndef TSEGMENTED_VECTOR_HPP
+#define TSEGMENTED_VECTOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <tstl_uninitialized.hpp>
+#include <titerator.hpp>
+#include <tutility.hpp>
+#include <talgorithm.hpp>
+#include <initializer_list>
+#include <cstddef>
+#include <type_traits>
+#include <limits>
+#include <bit>
+#include <stdexcept> // for std::out_of_range
+#include <iterator>
+#include <cassert>
+
+namespace tstd
+{
+
+namespace impl
+{
+
+// default elements of a chunk: a power of 2 near 4KB chunks, at least 16
+template<typename T>
+inline constexpr std::size_t segmented_vector_chunk_size = std::bit_floor(4096 / sizeof(T) > 16 ? 4096 / sizeof(T) : std::size_t(16));
+
+// random access iterator of segmented_vector: slot of the chunk in the chunk table and current element
+template<typename T, bool IsConst, std::size_t ChunkSize>
+class segmented_vector_iterator
+{
+    template<typename U, bool C, std::size_t S> friend class segmented_vector_iterator;
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const T*, T*>;
+    using reference = std::conditional_t<IsConst, const T&, T&>;
+private:
+    T* const* node;
+    T* cur;
+public:
+    segmented_vector_iterator() noexcept
+        : node(nullptr)
+        , cur(nullptr)
+    {
+    }
+    segmented_vector_iterator(T* const* _node, T* _cur) noexcept
+        : node(_node)
+        , cur(_cur)
+    {
+    }
+    // iterator to const_iterator
+    template<bool C>
+        requires (IsConst && !C)
+    segmented_vector_iterator(const segmented_vector_iterator<T, C, ChunkSize>& other) noexcept
+        : node(other.node)
+        , cur(other.cur)
+    {
+    }
+    // segmented iterator protocol, chunks are the segments
+    using segment_iterator = T* const*;
+    using local_iterator = pointer;
+    segment_iterator segment() const noexcept
+    {
+        return node;
+    }
+    local_iterator local() const noexcept
+    {
+        return cur;
+    }
+    static local_iterator segment_begin(segment_iterator seg) noexcept
+    {
+        return *seg;
+    }
+    static local_iterator segment_end(segment_iterator seg) noexcept
+    {
+        return *seg + ChunkSize;
+    }
+    static segmented_vector_iterator compose(segment_iterator seg, local_iterator local) noexcept
+    {
+        // end of a chunk is represented by the begin of next chunk, slot of end() may be an unallocated chunk
+        if (*seg && local == segment_end(seg))
+        {
+            return segmented_vector_iterator(seg + 1, seg[1]);
+        }
+        return segmented_vector_iterator(seg, const_cast<T*>(local));
+    }
+    reference operator*() const noexcept
+    {
+        return *cur;
+    }
+    pointer operator->() const noexcept
+    {
+        return cur;
+    }
+    reference operator[](difference_type n) const noexcept
+    {
+        return *(*this + n);
+    }
+    segmented_vector_iterator& operator++() noexcept
+    {
+        if (++cur == *node + ChunkSize)
+        {
+            cur = *++node;
+        }
+        return *this;
+    }
+    segmented_vector_iterator operator++(int) noexcept
+    {
+        segmented_vector_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    segmented_vector_iterator& operator--() noexcept
+    {
+        if (cur == *node)
+        {
+            cur = *--node + ChunkSize;
+        }
+        --cur;
+        return *this;
+    }
+    segmented_vector_iterator operator--(int) noexcept
+    {
+        segmented_vector_iterator tmp = *this;
+        --*this;
+        return tmp;
+    }
+    segmented_vector_iterator& operator+=(difference_type n) noexcept
+    {
+        difference_type offset = (cur - *node) + n; // offset relative to the start of current chunk
+        if (offset >= 0 && offset < difference_type(ChunkSize))
+        {
+            cur += n;
+        }
+        else
+        {
+            difference_type node_offset = offset > 0 ? offset / difference_type(ChunkSize)
+                : -difference_type((-offset - 1) / difference_type(ChunkSize)) - 1;
+            node += node_offset;
+            cur = *node + (offset - node_offset * difference_type(ChunkSize));
+        }
+        return *this;
+    }
+    segmented_vector_iterator& operator-=(difference_type n) noexcept
+    {
+        return *this += -n;
+    }
+    friend segmented_vector_iterator operator+(segmented_vector_iterator iter, difference_type n) noexcept
+    {
+        return iter += n;
+    }
+    friend segmented_vector_iterator operator+(difference_type n, segmented_vector_iterator iter) noexcept
+    {
+        return iter += n;
+    }
+    friend segmented_vector_iterator operator-(segmented_vector_iterator iter, difference_type n) noexcept
+    {
+        return iter -= n;
+    }
+    friend difference_type operator-(const segmented_vector_iterator& lhs, const segmented_vector_iterator& rhs) noexcept
+    {
+        return (lhs.node - rhs.node) * difference_type(ChunkSize) + (lhs.cur - *lhs.node) - (rhs.cur - *rhs.node);
+    }
+    friend bool operator==(const segmented_vector_iterator& lhs, const segmented_vector_iterator& rhs) noexcept
+    {
+        return lhs.node == rhs.node && lhs.cur == rhs.cur;
+    }
+    friend std::strong_ordering operator<=>(const segmented_vector_iterator& lhs, const segmented_vector_iterator& rhs) noexcept
+    {
+        if (auto cmp = lhs.node <=> rhs.node; cmp != 0)
+        {
+            return cmp;
+        }
+        return lhs.cur <=> rhs.cur;
+    }
+};
+
+} // namespace impl
+
+// Segmented vector (stable vector): elements live in chunks of ChunkSize elements, found through a table of chunks
+// like tstd::deque, so indexing is O(1) (a shift and a mask). Growing only allocates a new chunk and at times a bigger
+// chunk table, elements are never moved: pointers and references stay valid until the element is removed,
+// and there is no peak of old and new buffers as in the reallocation of tstd::vector.
+// Elements are only added and removed at the back. Removed chunks are kept as capacity until shrink_to_fit.
+template<typename T, std::size_t ChunkSize = impl::segmented_vector_chunk_size<T>, typename Allocator = tstd::allocator<T>>
+class segmented_vector
+{
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of 2");
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = impl::segmented_vector_iterator<T, false, ChunkSize>;
+    using const_iterator = impl::segmented_vector_iterator<T, true, ChunkSize>;
+    using reverse_iterator = tstd::reverse_iterator<iterator>;
+    using const_reverse_iterator = tstd::reverse_iterator<const_iterator>;
+    inline constexpr static size_type chunk_size = ChunkSize;
+private:
+    using map_pointer = pointer*;
+    using map_allocator = typename Allocator::template rebind<pointer>::other;
+    inline constexpr static size_type initial_map_size = 8;
+    inline constexpr static unsigned chunk_shift = std::countr_zero(ChunkSize);
+    inline constexpr static size_type chunk_mask = ChunkSize - 1;
+    // chunk table of empty containers, iterators always read the slot they point to
+    inline static pointer empty_map[1] = {nullptr};
+
+    map_pointer map;            // chunk table, [0, chunks) are allocated, [chunks, map_size) are null
+    size_type map_size;         // slots of chunk table, at least chunks + 1
+    size_type chunks;           // allocated chunks
+    size_type count;            // elements
+    allocator_type alloc;       // allocator of elements
+    map_allocator map_alloc;    // allocator of chunk table
+private:
+    pointer* table() const noexcept
+    {
+        return map ? map : empty_map;
+    }
+    pointer address(size_type pos) const noexcept
+    {
+        return map[pos >> chunk_shift] + (pos & chunk_mask);
+    }
+    // make the chunk table hold at least slots slots, only chunk pointers are copied
+    void reserve_map(size_type slots)
+    {
+        if (slots <= map_size)
+        {
+            return;
+        }
+        auto result = impl::_allocate_at_least(map_alloc, tstd::max({slots, 2 * map_size, initial_map_size}));
+        impl::_memmove_n(map, chunks, result.ptr);
+        for (size_type i = chunks; i < result.count; ++i)
+        {
+            result.ptr[i] = nullptr;
+        }
+        if (map)
+        {
+            map_alloc.deallocate(map, map_size);
+        }
+        map = result.ptr;
+        map_size = result.count;
+    }
+    // allocate chunks until there are n
+    void reserve_chunks(size_type n)
+    {
+        if (n <= chunks)
+        {
+            return;
+        }
+        reserve_map(n + 1);
+        for (; chunks < n; ++chunks)
+        {
+            map[chunks] = alloc.allocate(ChunkSize);
+        }
+    }
+    static size_type chunks_for(size_type n) noexcept
+    {
+        return (n + chunk_mask) >> chunk_shift;
+    }
+    // destroy elements [n, count)
+    void destroy_to(size_type n) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_type pos = count; pos > n; --pos)
+            {
+                alloc.destroy(address(pos - 1));
+            }
+        }
+        count = n;
+    }
+    // free all chunks and the chunk table, elements must be destroyed
+    void release() noexcept
+    {
+        for (size_type i = 0; i < chunks; ++i)
+        {
+            alloc.deallocate(map[i], ChunkSize);
+        }
+        if (map)
+        {
+            map_alloc.deallocate(map, map_size);
+        }
+        map = nullptr;
+        map_size = 0;
+        chunks = 0;
+    }
+    // copy elements of other chunk by chunk, capacity must be enough
+    void copy_from(const segmented_vector& other)
+    {
+        for (size_type i = 0; count < other.count; ++i)
+        {
+            size_type n = tstd::min(ChunkSize, other.count - count);
+            tstd::uninitialized_copy(other.map[i], other.map[i] + n, map[i]);
+            count += n;
+        }
+    }
+public:
+    // constructors
+    segmented_vector() noexcept(noexcept(Allocator()))
+        : segmented_vector(Allocator())
+    {
+    }
+    explicit segmented_vector(const Allocator& _alloc) noexcept
+        : map(nullptr)
+        , map_size(0)
+        , chunks(0)
+        , count(0)
+        , alloc(_alloc)
+        , map_alloc(_alloc)
+    {
+    }
+    segmented_vector(size_type n, const T& value, const Allocator& _alloc = Allocator())
+        : segmented_vector(_alloc)
+    {
+        resize(n, value);
+    }
+    explicit segmented_vector(size_type n, const Allocator& _alloc = Allocator())
+        : segmented_vector(_alloc)
+    {
+        resize(n);
+    }
+    template<typename InputIterator>
+        requires (!std::is_integral_v<InputIterator>)
+    segmented_vector(InputIterator first, InputIterator last, const Allocator& _alloc = Allocator())
+        : segmented_vector(_alloc)
+    {
+        if constexpr (tstd::is_forward_iterator_v<InputIterator>)
+        {
+            reserve(static_cast<size_type>(tstd::distance(first, last)));
+        }
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+    }
+    segmented_vector(const segmented_vector& other)
+        : segmented_vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc))
+    {
+        reserve(other.count);
+        copy_from(other);
+    }
+    segmented_vector(segmented_vector&& other) noexcept
+        : map(other.map)
+        , map_size(other.map_size)
+        , chunks(other.chunks)
+        , count(other.count)
+        , alloc(other.alloc)
+        , map_alloc(other.map_alloc)
+    {
+        other.map = nullptr;
+        other.map_size = 0;
+        other.chunks = 0;
+        other.count = 0;
+    }
+    segmented_vector(std::initializer_list<T> ilist, const Allocator& _alloc = Allocator())
+        : segmented_vector(ilist.begin(), ilist.end(), _alloc)
+    {
+    }
+    ~segmented_vector()
+    {
+        destroy_to(0);
+        release();
+    }
+
+    // assignment
+    segmented_vector& operator=(const segmented_vector& other)
+    {
+        if (this != &other)
+        {
+            destroy_to(0);
+            reserve(other.count); // chunks are reused
+            copy_from(other);
+        }
+        return *this;
+    }
+    segmented_vector& operator=(segmented_vector&& other) noexcept
+    {
+        segmented_vector tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+    segmented_vector& operator=(std::initializer_list<T> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+    void assign(size_type n, const T& value)
+    {
+        destroy_to(0);
+        resize(n, value);
+    }
+    template<typename InputIterator>
+        requires (!std::is_integral_v<InputIterator>)
+    void assign(InputIterator first, InputIterator last)
+    {
+        destroy_to(0);
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+    }
+    void assign(std::initializer_list<T> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+    allocator_type get_allocator() const noexcept
+    {
+        return alloc;
+    }
+
+    // element access
+    reference at(size_type pos)
+    {
+        if (pos >= count)
+        {
+            throw std::out_of_range("segmented_vector::at : input index is out of bounds");
+        }
+        return *address(pos);
+    }
+    const_reference at(size_type pos) const
+    {
+        if (pos >= count)
+        {
+            throw std::out_of_range("segmented_vector::at : input index is out of bounds");
+        }
+        return *address(pos);
+    }
+    reference operator[](size_type pos) noexcept
+    {
+        assert(pos < count);
+        return *address(pos);
+    }
+    const_reference operator[](size_type pos) const noexcept
+    {
+        assert(pos < count);
+        return *address(pos);
+    }
+    reference front() noexcept
+    {
+        return *address(0);
+    }
+    const_reference front() const noexcept
+    {
+        return *address(0);
+    }
+    reference back() noexcept
+    {
+        return *address(count - 1);
+    }
+    const_reference back() const noexcept
+    {
+        return *address(count - 1);
+    }
+
+    // iterators
+    iterator begin() noexcept
+    {
+        return iterator(table(), *table());
+    }
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(table(), *table());
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    iterator end() noexcept
+    {
+        pointer* node = table() + (count >> chunk_shift);
+        return iterator(node, *node + (count & chunk_mask));
+    }
+    const_iterator end() const noexcept
+    {
+        pointer* node = table() + (count >> chunk_shift);
+        return const_iterator(node, *node + (count & chunk_mask));
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+    const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+
+    // capacity
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+    size_type size() const noexcept
+    {
+        return count;
+    }
+    size_type max_size() const noexcept
+    {
+        return static_cast<size_type>(std::numeric_limits<difference_type>::max() / sizeof(T));
+    }
+    void reserve(size_type new_cap)
+    {
+        if (new_cap > max_size())
+        {
+            throw std::length_error("segmented_vector: size exceeds max_size()");
+        }
+        reserve_chunks(chunks_for(new_cap));
+    }
+    size_type capacity() const noexcept
+    {
+        return chunks * ChunkSize;
+    }
+    // free chunks without elements, the chunk table is kept
+    void shrink_to_fit() noexcept
+    {
+        size_type used = chunks_for(count);
+        for (; chunks > used; --chunks)
+        {
+            alloc.deallocate(map[chunks - 1], ChunkSize);
+            map[chunks - 1] = nullptr;
+        }
+    }
+
+    // modifiers
+    void clear() noexcept
+    {
+        destroy_to(0);
+    }
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+    // elements never move, so arguments referring to elements stay valid while a chunk is added
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (count == chunks * ChunkSize)
+        {
+            reserve_chunks(chunks + 1);
+        }
+        pointer p = address(count);
+        alloc.construct(p, std::forward<Args>(args)...);
+        ++count;
+        return *p;
+    }
+    void pop_back() noexcept
+    {
+        assert(count > 0);
+        destroy_to(count - 1);
+    }
+    void resize(size_type n)
+    {
+        if (n <= count)
+        {
+            destroy_to(n);
+            return;
+        }
+        reserve(n);
+        while (count < n)
+        {
+            emplace_back();
+        }
+    }
+    void resize(size_type n, const T& value)
+    {
+        if (n <= count)
+        {
+            destroy_to(n);
+            return;
+        }
+        reserve(n);
+        while (count < n)
+        {
+            emplace_back(value);
+        }
+    }
+    void swap(segmented_vector& other) noexcept
+    {
+        tstd::swap(map, other.map);
+        tstd::swap(map_size, other.map_size);
+        tstd::swap(chunks, other.chunks);
+        tstd::swap(count, other.count);
+        tstd::swap(alloc, other.alloc);
+        tstd::swap(map_alloc, other.map_alloc);
+    }
+};
+
+// non-member functions
+// a non-standard compare function for tstd::segmented_vector
+// equal 0 less -1 greater 1
+template<typename T, std::size_t ChunkSize, typename Allocator>
+int _cmp_segmented_vector(const tstd::segmented_vector<T, ChunkSize, Allocator>& lhs, const tstd::segmented_vector<T, ChunkSize, Allocator>& rhs)
+{
+    auto iter1 = lhs.begin();
+    auto iter2 = rhs.begin();
+    for (; iter1 != lhs.end() && iter2 != rhs.end(); ++iter1, ++iter2)
+    {
+        if (*iter1 == *iter2)
+        {
+            continue;
+        }
+        return *iter1 > *iter2 ? 1 : -1;
+    }
+    if (iter1 != lhs.end())
+    {
+        return 1;
+    }
+    if (iter2 != rhs.end())
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// comparisons
+template<typename T, std::size_t ChunkSize, typename Allocator>
+bool operator==(const tstd::segmented_vector<T, ChunkSize, Allocator>& lhs, const tstd::segmented_vector<T, ChunkSize, Allocator>& rhs)
+{
+    return lhs.size() == rhs.size() && tstd::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+template<typename T, std::size_t ChunkSize, typename Allocator>
+bool operator!=(const tstd::segmented_vector<T, ChunkSize, Allocator>& lhs, const tstd::segmented_vector<T, ChunkSize, Allocator>& rhs)
+{
+    return !(lhs == rhs);
+}
+template<typename T, std::size_t ChunkSize, typename Allocator>
+bool operator<(const tstd::segmented_vector<T, ChunkSize, Allocator>& lhs, const tstd::segmented_vector<T, ChunkSize, Allocator>& rhs)
+{
+    return _cmp_segmented_vector(lhs, rhs) < 0;
+}
+template<typename T, std::size_t ChunkSize, typename Allocator>
+bool operator<=(const tstd::segmented_vector<T, ChunkSize, Allocator>& lhs, const tstd::segmented_vector<T, ChunkSize, Allocator>& rhs)
+{
+    return _cmp_segmented_vector(lhs, rhs) <= 0;
+}
+template<typename T, std::size_t ChunkSize, typename Allocator>
+bool operator>(const tstd::segmented_vector<T, ChunkSize, Allocator>& lhs, const tstd::segmented_vector<T, ChunkSize, Allocator>& rhs)
+{
+    return _cmp_segmented_vector(lhs, rhs) > 0;
+}
+template<typename T, std::size_t ChunkSize, typename Allocator>
+bool operator>=(const tstd::segmented_vector<T, ChunkSize, Allocator>& lhs, const tstd::segmented_vector<T, ChunkSize, Allocator>& rhs)
+{
+    return _cmp_segmented_vector(lhs, rhs) >= 0;
+}
+
+// global swap for tstd::segmented_vector
+template<typename T, std::size_t ChunkSize, typename Allocator>
+void swap(tstd::segmented_vector<T, ChunkSize, Allocator>& lhs, tstd::segmented_vector<T, ChunkSize, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace tstd
+
+#endif // TSEGMENTED_VECTOR_HPP
@@ -8,6 +8,7 @@
 #include <limits>
 #include <utility>
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <titerator.hpp>
 #include <tstl_bst.hpp>
 #include <tstl_rbtree.hpp>
@@ -434,6 +435,12 @@ void swap(tstd::set<Key, Compare, Allocator, UnderlyingTree>& lhs, tstd::set<Key
     lhs.swap(rhs);
 }
 
+namespace pmr
+{
+template<typename Key, typename Compare = std::less<Key>>
+using set = tstd::set<Key, Compare, polymorphic_allocator<Key>>;
+} // namespace pmr
+
 } // namespace tstd
 
 #endif // TSET_HPP
\ No newline at end of file
@@ -0,0 +1,798 @@
+#ifndef TSMALL_VECTOR_HPP
+#define TSMALL_VECTOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
+#include <tstl_uninitialized.hpp>
+#include <titerator.hpp>
+#include <tutility.hpp>
+#include <talgorithm.hpp>
+#include <initializer_list>
+#include <cstddef>
+#include <type_traits>
+#include <limits>
+#include <stdexcept> // for std::out_of_range
+#include <iterator>
+#include <cassert>
+
+namespace tstd
+{
+
+// vector with inline storage of N elements: no allocation until size exceeds N, then elements spill to the heap
+// storage of Allocator like tstd::vector. Its interface is the same as tstd::vector.
+// Unlike tstd::vector, move and swap of inline elements move every element, and iterators are invalidated by them.
+template<typename T, std::size_t N, typename Allocator = tstd::allocator<T>>
+class small_vector
+{
+    static_assert(N > 0, "use tstd::vector if no inline storage is needed");
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type= std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = Allocator::pointer;
+    using const_pointer = Allocator::const_pointer;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = tstd::reverse_iterator<iterator>;
+    using const_reverse_iterator = tstd::reverse_iterator<const_iterator>;
+    inline constexpr static size_type inline_capacity = N;
+public:
+    // constructors
+    constexpr small_vector() noexcept(noexcept(Allocator())) // 1
+        : alloc()
+    {
+        reset_to_inline();
+    }
+    constexpr explicit small_vector(const Allocator& _alloc) noexcept // 2
+        : alloc(_alloc)
+    {
+        reset_to_inline();
+    }
+    constexpr small_vector(size_type count, const T& value, const Allocator& _alloc = Allocator()) // 3
+        : alloc(_alloc)
+    {
+        reset_to_inline();
+        init_capacity(count);
+        finish = tstd::uninitialized_fill_n(start, count, value);
+    }
+    constexpr explicit small_vector(size_type count, const Allocator& _alloc = Allocator()) // 4
+        : alloc(_alloc)
+    {
+        reset_to_inline();
+        init_capacity(count);
+        finish = tstd::uninitialized_fill_n(start, count, T());
+    }
+    template<typename InputIterator,
+        typename = std::enable_if_t<std::is_base_of_v<typename std::input_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>>>
+    constexpr small_vector(InputIterator first, InputIterator last, const Allocator& _alloc = Allocator()) // 5
+        : alloc(_alloc)
+    {
+        reset_to_inline();
+        insert(end(), first, last);
+    }
+    constexpr small_vector(const small_vector& other) // 6
+        : alloc(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc))
+    {
+        reset_to_inline();
+        init_capacity(other.size());
+        finish = tstd::uninitialized_copy(other.begin(), other.end(), start);
+    }
+    constexpr small_vector(const small_vector& other, const Allocator& _alloc) // 7
+        : alloc(_alloc)
+    {
+        reset_to_inline();
+        init_capacity(other.size());
+        finish = tstd::uninitialized_copy(other.begin(), other.end(), start);
+    }
+    constexpr small_vector(small_vector&& other) noexcept // 8
+        : alloc(std::move(other.alloc))
+    {
+        reset_to_inline();
+        take_over(other);
+    }
+    constexpr small_vector(small_vector&& other, const Allocator& _alloc) // 9
+        : alloc(_alloc)
+    {
+        reset_to_inline();
+        if (alloc == other.alloc)
+        {
+            take_over(other);
+        }
+        else
+        {
+            init_capacity(other.size());
+            finish = impl::_relocate(other.start, other.finish, start);
+            other.finish = other.start;
+        }
+    }
+    constexpr small_vector(std::initializer_list<T> il, const Allocator& _alloc = Allocator()) // 10
+        : alloc(_alloc)
+    {
+        reset_to_inline();
+        init_capacity(il.size());
+        finish = tstd::uninitialized_copy(il.begin(), il.end(), start);
+    }
+    // destructor
+    constexpr ~small_vector()
+    {
+        clear();
+        free_all_spaces();
+    }
+    // operator =
+    constexpr small_vector& operator=(const small_vector& rhs) // 1
+    {
+        if (this != &rhs)
+        {
+            assign(rhs.begin(), rhs.end());
+        }
+        return *this;
+    }
+    constexpr small_vector& operator=(small_vector&& rhs) noexcept(std::allocator_traits<Allocator>::is_always_equal::value) // 2
+    {
+        if (this != &rhs)
+        {
+            clear();
+            if (!rhs.is_inline() && alloc == rhs.alloc) // take over the heap buffer
+            {
+                free_all_spaces();
+                take_over(rhs);
+            }
+            else // inline elements or buffer of rhs could not be freed by alloc, relocate every element
+            {
+                if (rhs.size() > capacity())
+                {
+                    free_all_spaces();
+                    init_capacity(rhs.size());
+                }
+                finish = impl::_relocate(rhs.start, rhs.finish, start);
+                rhs.finish = rhs.start;
+            }
+        }
+        return *this;
+    }
+    constexpr small_vector& operator=(std::initializer_list<T> il) // 3
+    {
+        assign(il);
+        return *this;
+    }
+    // assign
+    constexpr void assign(size_type count, const T& value) // 1
+    {
+        clear();
+        if (count > capacity())
+        {
+            free_all_spaces();
+            init_capacity(count);
+        }
+        finish = tstd::uninitialized_fill_n(start, count, value);
+    }
+    template<typename InputIterator,
+        typename = std::enable_if_t<std::is_base_of_v<typename std::input_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>>>
+    constexpr void assign(InputIterator first, InputIterator last) // 2
+    {
+        clear();
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>)
+        {
+            size_type count = static_cast<size_type>(std::distance(first, last));
+            if (count > capacity())
+            {
+                free_all_spaces();
+                init_capacity(count);
+            }
+            finish = tstd::uninitialized_copy(first, last, start);
+        }
+        else
+        {
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+    }
+    constexpr void assign(std::initializer_list<T> il) // 3
+    {
+        assign(il.begin(), il.end());
+    }
+    // allocator
+    constexpr allocator_type get_allocator() const noexcept
+    {
+        return alloc;
+    }
+
+    // element access
+    constexpr reference at(size_type pos)
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("small_vector::at : input index is out of bounds");
+        }
+        return *(begin() + pos);
+    }
+    constexpr const_reference at(size_type pos) const
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("small_vector::at : input index is out of bounds");
+        }
+        return *(begin() + pos);
+    }
+    constexpr reference operator[](size_type pos)
+    {
+        assert(pos < size());
+        return *(begin() + pos);
+    }
+    constexpr const_reference operator[](size_type pos) const
+    {
+        assert(pos < size());
+        return *(begin() + pos);
+    }
+    constexpr reference front()
+    {
+        assert(!empty());
+        return *begin();
+    }
+    constexpr const_reference front() const
+    {
+        assert(!empty());
+        return *begin();
+    }
+    constexpr reference back()
+    {
+        assert(!empty());
+        return *(end() - 1);
+    }
+    constexpr const_reference back() const
+    {
+        assert(!empty());
+        return *(end() - 1);
+    }
+    constexpr T* data() noexcept
+    {
+        return start;
+    }
+    constexpr const T* data() const noexcept
+    {
+        return start;
+    }
+
+    // iterators
+    constexpr iterator begin() noexcept
+    {
+        return start;
+    }
+    constexpr const_iterator begin() const noexcept
+    {
+        return start;
+    }
+    constexpr const_iterator cbegin() const noexcept
+    {
+        return start;
+    }
+    constexpr iterator end() noexcept
+    {
+        return finish;
+    }
+    constexpr const_iterator end() const noexcept
+    {
+        return finish;
+    }
+    constexpr const_iterator cend() const noexcept
+    {
+        return finish;
+    }
+    constexpr reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+    constexpr const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+    constexpr const_reverse_iterator crbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+    constexpr reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+    constexpr const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+    constexpr const_reverse_iterator crend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    // size and capacity
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return begin() == end();
+    }
+    constexpr size_type size() const noexcept
+    {
+        return size_type(end() - begin());
+    }
+    constexpr size_type max_size() const noexcept
+    {
+        return std::numeric_limits<difference_type>::max();
+    }
+    constexpr void reserve(size_type new_cap)
+    {
+        if (new_cap > capacity())
+        {
+            reallocate(new_cap);
+        }
+    }
+    constexpr size_type capacity() const noexcept
+    {
+        return end_of_storage - start;
+    }
+    // whether elements are in the inline storage
+    constexpr bool is_inline() const noexcept
+    {
+        return start == inline_data();
+    }
+    // move elements back to inline storage if they fit, otherwise shrink heap storage to size()
+    constexpr void shrink_to_fit()
+    {
+        if (!is_inline() && capacity() > size())
+        {
+            reallocate(size());
+        }
+    }
+
+    // modifiers
+    constexpr void clear() noexcept
+    {
+        erase_range(start, finish);
+        finish = start;
+    }
+    constexpr iterator insert(const_iterator pos, const T& value) // 1
+    {
+        return emplace(pos, value);
+    }
+    constexpr iterator insert(const_iterator pos, T&& value) // 2
+    {
+        return emplace(pos, std::move(value));
+    }
+    constexpr iterator insert(const_iterator pos, size_type count, const T& value) // 3
+    {
+        size_type idx = (size_type)(pos - start);
+        if (count > 0)
+        {
+            T copy(value); // value may be an element
+            insert_gap(idx, count, [&](T* gap) { tstd::uninitialized_fill_n(gap, count, copy); });
+        }
+        return start + idx;
+    }
+    template<typename InputIterator,
+        typename = std::enable_if_t<std::is_base_of_v<typename std::input_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>>>
+    constexpr iterator insert(const_iterator pos, InputIterator first, InputIterator last) // 4
+    {
+        size_type idx = (size_type)(pos - start);
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>)
+        {
+            size_type count = static_cast<size_type>(std::distance(first, last));
+            if (count > 0)
+            {
+                insert_gap(idx, count, [&](T* gap) { tstd::uninitialized_copy(first, last, gap); });
+            }
+        }
+        else
+        {
+            for (size_type i = idx; first != last; ++first, ++i)
+            {
+                emplace(start + i, *first);
+            }
+        }
+        return start + idx;
+    }
+    constexpr iterator insert(const_iterator pos, std::initializer_list<T> il) // 5
+    {
+        return insert(pos, il.begin(), il.end());
+    }
+    template<typename... Args>
+    constexpr iterator emplace(const_iterator pos, Args&&... args)
+    {
+        size_type idx = (size_type)(pos - start);
+        if (idx == size())
+        {
+            emplace_back(std::forward<Args>(args)...);
+        }
+        else
+        {
+            T tmp(std::forward<Args>(args)...); // args may refer to elements
+            insert_gap(idx, 1, [&](T* gap) { alloc.construct(gap, std::move(tmp)); });
+        }
+        return start + idx;
+    }
+    constexpr iterator erase(const_iterator pos) // 1
+    {
+        move_forward(pos + 1, 1);
+        return (iterator)pos;
+    }
+    constexpr iterator erase(const_iterator first, const_iterator last) // 2
+    {
+        if (first != last)
+        {
+            move_forward(last, last - first);
+        }
+        return (iterator)first;
+    }
+    constexpr void push_back(const T& value) // 1
+    {
+        emplace_back(value);
+    }
+    constexpr void push_back(T&& value) // 2
+    {
+        emplace_back(std::move(value));
+    }
+    template<typename... Args>
+    constexpr reference emplace_back(Args&&... args)
+    {
+        if (finish == end_of_storage)
+        {
+            return grow_and_emplace_back(std::forward<Args>(args)...);
+        }
+        alloc.construct(finish, std::forward<Args>(args)...);
+        ++finish;
+        return back();
+    }
+    // non-standard: append without checking capacity, size() < capacity() is required
+    constexpr void push_back_unchecked(const T& value) // 1
+    {
+        emplace_back_unchecked(value);
+    }
+    constexpr void push_back_unchecked(T&& value) // 2
+    {
+        emplace_back_unchecked(std::move(value));
+    }
+    template<typename... Args>
+    constexpr reference emplace_back_unchecked(Args&&... args)
+    {
+        assert(finish != end_of_storage);
+        alloc.construct(finish, std::forward<Args>(args)...);
+        ++finish;
+        return back();
+    }
+    constexpr void pop_back()
+    {
+        assert(!empty());
+        alloc.destroy(finish - 1);
+        --finish;
+    }
+    // non-standard: like resize, but new elements are default-initialized
+    constexpr void resize_for_overwrite(size_type count)
+    {
+        if (count <= size())
+        {
+            erase_range(start + count, finish);
+            finish = start + count;
+            return;
+        }
+        if (count > capacity())
+        {
+            reallocate(tstd::max(2 * size(), count));
+        }
+        tstd::uninitialized_default_construct(finish, start + count);
+        finish = start + count;
+    }
+    constexpr void resize(size_type count) // 1
+    {
+        resize(count, T());
+    }
+    constexpr void resize(size_type count, const value_type& value) // 2
+    {
+        if (count < size())
+        {
+            erase_range(start + count, finish);
+            finish = start + count;
+        }
+        else if (count > size())
+        {
+            if (count > capacity())
+            {
+                T copy(value); // value may be an element
+                reallocate(tstd::max(2 * size(), count));
+                finish = tstd::uninitialized_fill_n(finish, count - size(), copy);
+            }
+            else
+            {
+                finish = tstd::uninitialized_fill_n(finish, count - size(), value);
+            }
+        }
+    }
+    constexpr void swap(small_vector& other) noexcept(std::allocator_traits<Allocator>::is_always_equal::value && std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this == &other)
+        {
+            return;
+        }
+        if (!is_inline() && !other.is_inline())
+        {
+            tstd::swap(alloc, other.alloc);
+            tstd::swap(start, other.start);
+            tstd::swap(finish, other.finish);
+            tstd::swap(end_of_storage, other.end_of_storage);
+        }
+        else
+        {
+            small_vector tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+    }
+private:
+    // auxiliary functions
+    T* inline_data() noexcept
+    {
+        return reinterpret_cast<T*>(buffer);
+    }
+    const T* inline_data() const noexcept
+    {
+        return reinterpret_cast<const T*>(buffer);
+    }
+    void reset_to_inline() noexcept
+    {
+        start = finish = inline_data();
+        end_of_storage = start + N;
+    }
+    // make room for count elements in an empty small_vector
+    void init_capacity(size_type count)
+    {
+        if (count > capacity())
+        {
+            auto result = impl::_allocate_at_least(alloc, count);
+            start = finish = result.ptr;
+            end_of_storage = start + result.count;
+        }
+    }
+    // take over elements of other, other becomes empty
+    void take_over(small_vector& other) noexcept
+    {
+        if (other.is_inline())
+        {
+            finish = impl::_relocate(other.start, other.finish, start);
+            other.finish = other.start;
+        }
+        else
+        {
+            start = other.start;
+            finish = other.finish;
+            end_of_storage = other.end_of_storage;
+            other.reset_to_inline();
+        }
+    }
+    // move from front to back
+    void move_range(const_iterator first, const_iterator last, iterator dest)
+    {
+        for (; first != last; ++first, ++dest)
+        {
+            *dest = std::move(*first);
+        }
+    }
+    // destroy a range of elements in reverse order.
+    void erase_range(iterator first, iterator last)
+    {
+        for (auto iter = last; iter != first;)
+        {
+            alloc.destroy(&*(--iter));
+        }
+    }
+    // free heap storage and go back to the inline storage, elements must be destroyed already
+    void free_all_spaces()
+    {
+        if (!is_inline())
+        {
+            alloc.deallocate(start, capacity());
+        }
+        reset_to_inline();
+    }
+    // relocate elements to new storage of at least new_cap elements, the inline storage is used if it's enough.
+    // new_cap must be greater than or equal to size()
+    void reallocate(size_type new_cap)
+    {
+        T* new_start = inline_data();
+        T* new_end_of_storage = new_start + N;
+        if (new_cap > N)
+        {
+            auto result = impl::_allocate_at_least(alloc, new_cap);
+            new_start = result.ptr;
+            new_end_of_storage = new_start + result.count;
+        }
+        else if (is_inline())
+        {
+            return;
+        }
+        T* new_finish = impl::_relocate(start, finish, new_start);
+        if (!is_inline())
+        {
+            alloc.deallocate(start, capacity());
+        }
+        start = new_start;
+        finish = new_finish;
+        end_of_storage = new_end_of_storage;
+    }
+    // the new element is constructed before elements are relocated, args may refer to an element
+    template<typename... Args>
+    reference grow_and_emplace_back(Args&&... args)
+    {
+        size_type count = size();
+        auto result = impl::_allocate_at_least(alloc, 2 * count);
+        try
+        {
+            alloc.construct(result.ptr + count, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            alloc.deallocate(result.ptr, result.count);
+            throw;
+        }
+        impl::_relocate(start, finish, result.ptr);
+        if (!is_inline())
+        {
+            alloc.deallocate(start, capacity());
+        }
+        start = result.ptr;
+        finish = start + count + 1;
+        end_of_storage = start + result.count;
+        return back();
+    }
+    // open a gap of count elements at idx and construct them by construct(gap), adjust capacity if necessary.
+    // construct must destroy what it has constructed before throwing, then the tail is shifted back.
+    template<typename Construct>
+    void insert_gap(size_type idx, size_type count, Construct construct)
+    {
+        if (size() + count > capacity())
+        {
+            reallocate(tstd::max(2 * size(), size() + count));
+        }
+        if constexpr (tstd::is_trivially_relocatable_v<T>)
+        {
+            // relocate the tail as a whole
+            impl::_memmove_n(start + idx, size() - idx, start + idx + count);
+        }
+        else
+        {
+            // relocate the tail one by one from back to front
+            for (iterator iter = finish; iter != start + idx;)
+            {
+                --iter;
+                alloc.construct(iter + count, std::move(*iter));
+                alloc.destroy(iter);
+            }
+        }
+        // finish is only advanced after the gap is constructed
+        try
+        {
+            construct(start + idx);
+        }
+        catch (...)
+        {
+            if constexpr (tstd::is_trivially_relocatable_v<T>)
+            {
+                impl::_memmove_n(start + idx + count, size() - idx, start + idx);
+            }
+            else
+            {
+                for (iterator iter = start + idx; iter != finish; ++iter)
+                {
+                    alloc.construct(iter, std::move(*(iter + count)));
+                    alloc.destroy(iter + count);
+                }
+            }
+            throw;
+        }
+        finish += count;
+    }
+    // move elements forward
+    // called after erasing
+    void move_forward(const_iterator first, size_type count)
+    {
+        if constexpr (tstd::is_trivially_relocatable_v<T>)
+        {
+            // destroy erased elements, then relocate the tail as a whole
+            erase_range((iterator)(first - count), (iterator)first);
+            impl::_memmove_n(first, finish - first, (iterator)(first - count));
+        }
+        else
+        {
+            move_range(first, finish, (iterator)(first - count));
+            erase_range(finish - count, finish);
+        }
+        finish -= count;
+    }
+private:
+    Allocator alloc;
+    T* start;
+    T* finish; // off the end
+    T* end_of_storage; // off the capacity
+    alignas(T) unsigned char buffer[N * sizeof(T)]; // inline storage
+};
+
+// non-member operations
+// a non-standard compare function for tstd::small_vector
+// equal 0 less -1 greater 1
+template<typename T, std::size_t N, typename Allocator>
+constexpr int _cmp_small_vector(const tstd::small_vector<T, N, Allocator>& lhs, const tstd::small_vector<T, N, Allocator>& rhs)
+{
+    using const_iterator = typename tstd::small_vector<T, N, Allocator>::const_iterator;
+    if constexpr (impl::is_memcmp_comparable_v<const_iterator, const_iterator>)
+    {
+        auto cmp = tstd::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        return cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+    }
+    auto iter1 = lhs.begin();
+    auto iter2 = rhs.begin();
+    for (; iter1 != lhs.end() && iter2 != rhs.end(); ++iter1, ++iter2)
+    {
+        if (*iter1 == *iter2)
+        {
+            continue;
+        }
+        return *iter1 > *iter2 ? 1 : -1;
+    }
+    if (iter1 != lhs.end())
+    {
+        return 1;
+    }
+    if (iter2 != rhs.end())
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// comparisons
+template<typename T, std::size_t N, typename Allocator>
+constexpr bool operator==(const tstd::small_vector<T, N, Allocator>& lhs, const tstd::small_vector<T, N, Allocator>& rhs)
+{
+    return lhs.size() == rhs.size() && tstd::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+template<typename T, std::size_t N, typename Allocator>
+constexpr bool operator!=(const tstd::small_vector<T, N, Allocator>& lhs, const tstd::small_vector<T, N, Allocator>& rhs)
+{
+    return !(lhs == rhs);
+}
+template<typename T, std::size_t N, typename Allocator>
+constexpr bool operator<(const tstd::small_vector<T, N, Allocator>& lhs, const tstd::small_vector<T, N, Allocator>& rhs)
+{
+    return _cmp_small_vector(lhs, rhs) < 0;
+}
+template<typename T, std::size_t N, typename Allocator>
+constexpr bool operator<=(const tstd::small_vector<T, N, Allocator>& lhs, const tstd::small_vector<T, N, Allocator>& rhs)
+{
+    return _cmp_small_vector(lhs, rhs) <= 0;
+}
+template<typename T, std::size_t N, typename Allocator>
+constexpr bool operator>(const tstd::small_vector<T, N, Allocator>& lhs, const tstd::small_vector<T, N, Allocator>& rhs)
+{
+    return _cmp_small_vector(lhs, rhs) > 0;
+}
+template<typename T, std::size_t N, typename Allocator>
+constexpr bool operator>=(const tstd::small_vector<T, N, Allocator>& lhs, const tstd::small_vector<T, N, Allocator>& rhs)
+{
+    return _cmp_small_vector(lhs, rhs) >= 0;
+}
+
+// global swap for tstd::small_vector
+template<typename T, std::size_t N, typename Allocator>
+constexpr void swap(tstd::small_vector<T, N, Allocator>& lhs, tstd::small_vector<T, N, Allocator>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+namespace pmr
+{
+template<typename T, std::size_t N>
+using small_vector = tstd::small_vector<T, N, polymorphic_allocator<T>>;
+} // namespace pmr
+
+} // namespace tstd
+
+#endif // TSMALL_VECTOR_HPP
@@ -0,0 +1,724 @@
+#ifndef TSOA_VECTOR_HPP
+#define TSOA_VECTOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <tstl_uninitialized.hpp>
+#include <titerator.hpp>
+#include <tutility.hpp>
+#include <talgorithm.hpp>
+#include <initializer_list>
+#include <cstddef>
+#include <type_traits>
+#include <tuple>
+#include <span>
+#include <utility>
+#include <compare>
+#include <limits>
+#include <stdexcept> // for std::out_of_range
+#include <iterator>
+#include <cassert>
+
+namespace tstd
+{
+
+namespace impl
+{
+
+// proxy reference to a row of soa_vector: references to the field of the row in every column.
+// assigning to it assigns the fields, it converts to the row value (a std::tuple), and it is tuple-like,
+// so structured bindings work: auto [id, price] = vec[i];
+template<typename... Ts>
+class soa_reference
+{
+    template<typename... Us> friend class soa_reference;
+public:
+    using value_type = std::tuple<std::remove_const_t<Ts>...>;
+private:
+    std::tuple<Ts&...> refs;
+
+    template<typename Tuple, std::size_t... I>
+    constexpr void assign(Tuple&& t, std::index_sequence<I...>) const
+    {
+        ((std::get<I>(refs) = std::get<I>(std::forward<Tuple>(t))), ...);
+    }
+    template<std::size_t... I>
+    static constexpr void swap_fields(const soa_reference& lhs, const soa_reference& rhs, std::index_sequence<I...>)
+    {
+        using tstd::swap;
+        (swap(std::get<I>(lhs.refs), std::get<I>(rhs.refs)), ...);
+    }
+public:
+    constexpr explicit soa_reference(Ts&... fields) noexcept
+        : refs(fields...)
+    {
+    }
+    constexpr soa_reference(const soa_reference& other) noexcept = default;
+    // assign through, like tstd::vector<bool>::reference
+    constexpr const soa_reference& operator=(const soa_reference& other) const
+    {
+        assign(other.refs, std::index_sequence_for<Ts...>{});
+        return *this;
+    }
+    template<typename... Us>
+        requires (sizeof...(Us) == sizeof...(Ts))
+    constexpr const soa_reference& operator=(const soa_reference<Us...>& other) const
+    {
+        assign(other.refs, std::index_sequence_for<Ts...>{});
+        return *this;
+    }
+    constexpr const soa_reference& operator=(const value_type& value) const
+    {
+        assign(value, std::index_sequence_for<Ts...>{});
+        return *this;
+    }
+    constexpr const soa_reference& operator=(value_type&& value) const
+    {
+        assign(std::move(value), std::index_sequence_for<Ts...>{});
+        return *this;
+    }
+    constexpr operator value_type() const
+    {
+        return value_type(refs);
+    }
+    template<std::size_t I>
+    constexpr auto& get() const noexcept
+    {
+        return std::get<I>(refs);
+    }
+    friend constexpr bool operator==(const soa_reference& lhs, const soa_reference& rhs)
+    {
+        return lhs.refs == rhs.refs;
+    }
+    friend constexpr bool operator==(const soa_reference& lhs, const value_type& rhs)
+    {
+        return lhs.refs == rhs;
+    }
+    friend constexpr auto operator<=>(const soa_reference& lhs, const soa_reference& rhs)
+    {
+        return lhs.refs <=> rhs.refs;
+    }
+    friend constexpr auto operator<=>(const soa_reference& lhs, const value_type& rhs)
+    {
+        return lhs.refs <=> rhs;
+    }
+    // proxies are prvalues, swap them through ADL (tstd::iter_swap), field by field
+    friend constexpr void swap(const soa_reference& lhs, const soa_reference& rhs)
+    {
+        swap_fields(lhs, rhs, std::index_sequence_for<Ts...>{});
+    }
+};
+
+// found by ADL, so generic code could write: using std::get; get<I>(row) for both rows and row values
+template<std::size_t I, typename... Ts>
+constexpr auto& get(const soa_reference<Ts...>& ref) noexcept
+{
+    return ref.template get<I>();
+}
+
+// random access iterator of rows, zipping the columns: column pointers and row index
+template<bool IsConst, typename... Ts>
+class soa_iterator
+{
+    template<bool C, typename... Us> friend class soa_iterator;
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::tuple<Ts...>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = soa_reference<std::conditional_t<IsConst, const Ts, Ts>...>;
+private:
+    std::tuple<Ts*...> cols;
+    difference_type idx;
+
+    template<std::size_t... I>
+    constexpr reference row(difference_type i, std::index_sequence<I...>) const noexcept
+    {
+        return reference(std::get<I>(cols)[i]...);
+    }
+public:
+    constexpr soa_iterator() noexcept
+        : cols()
+        , idx(0)
+    {
+    }
+    constexpr soa_iterator(const std::tuple<Ts*...>& _cols, difference_type _idx) noexcept
+        : cols(_cols)
+        , idx(_idx)
+    {
+    }
+    // iterator to const_iterator
+    template<bool C>
+        requires (IsConst && !C)
+    constexpr soa_iterator(const soa_iterator<C, Ts...>& other) noexcept
+        : cols(other.cols)
+        , idx(other.idx)
+    {
+    }
+    // row index in the container
+    constexpr difference_type index() const noexcept
+    {
+        return idx;
+    }
+    constexpr reference operator*() const noexcept
+    {
+        return row(idx, std::index_sequence_for<Ts...>{});
+    }
+    constexpr reference operator[](difference_type n) const noexcept
+    {
+        return row(idx + n, std::index_sequence_for<Ts...>{});
+    }
+    constexpr soa_iterator& operator++() noexcept
+    {
+        ++idx;
+        return *this;
+    }
+    constexpr soa_iterator operator++(int) noexcept
+    {
+        soa_iterator tmp = *this;
+        ++idx;
+        return tmp;
+    }
+    constexpr soa_iterator& operator--() noexcept
+    {
+        --idx;
+        return *this;
+    }
+    constexpr soa_iterator operator--(int) noexcept
+    {
+        soa_iterator tmp = *this;
+        --idx;
+        return tmp;
+    }
+    constexpr soa_iterator& operator+=(difference_type n) noexcept
+    {
+        idx += n;
+        return *this;
+    }
+    constexpr soa_iterator& operator-=(difference_type n) noexcept
+    {
+        idx -= n;
+        return *this;
+    }
+    friend constexpr soa_iterator operator+(soa_iterator iter, difference_type n) noexcept
+    {
+        return iter += n;
+    }
+    friend constexpr soa_iterator operator+(difference_type n, soa_iterator iter) noexcept
+    {
+        return iter += n;
+    }
+    friend constexpr soa_iterator operator-(soa_iterator iter, difference_type n) noexcept
+    {
+        return iter -= n;
+    }
+    friend constexpr difference_type operator-(const soa_iterator& lhs, const soa_iterator& rhs) noexcept
+    {
+        return lhs.idx - rhs.idx;
+    }
+    friend constexpr bool operator==(const soa_iterator& lhs, const soa_iterator& rhs) noexcept
+    {
+        return lhs.idx == rhs.idx;
+    }
+    friend constexpr std::strong_ordering operator<=>(const soa_iterator& lhs, const soa_iterator& rhs) noexcept
+    {
+        return lhs.idx <=> rhs.idx;
+    }
+};
+
+} // namespace impl
+
+// Structure of arrays: every field of the rows is stored in its own contiguous column, all columns live in one block.
+// Algorithms touching few fields only load those columns, use column<I>() to run them on a single field,
+// or the zip iterators (rows as proxy references) to run them on whole rows, e.g. tstd::sort reorders all columns.
+// Reallocation and erasing invalidate iterators like tstd::vector.
+template<typename... Ts>
+class soa_vector
+{
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one field");
+    static_assert(((std::is_object_v<Ts> && !std::is_const_v<Ts>) && ...), "fields of soa_vector must be non-const object types");
+public:
+    using value_type = std::tuple<Ts...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = impl::soa_reference<Ts...>;
+    using const_reference = impl::soa_reference<const Ts...>;
+    using iterator = impl::soa_iterator<false, Ts...>;
+    using const_iterator = impl::soa_iterator<true, Ts...>;
+    using reverse_iterator = tstd::reverse_iterator<iterator>;
+    using const_reverse_iterator = tstd::reverse_iterator<const_iterator>;
+    template<std::size_t I>
+    using field_type = std::tuple_element_t<I, value_type>;
+private:
+    using columns_type = std::tuple<Ts*...>;
+    inline constexpr static std::size_t alignment = tstd::max({alignof(Ts)...});
+    inline constexpr static std::size_t row_bytes = (sizeof(Ts) + ...);
+
+    columns_type cols; // column 0 is at the start of the block
+    size_type count;
+    size_type cap;
+
+    static constexpr std::size_t align_up(std::size_t n, std::size_t align) noexcept
+    {
+        return (n + (align - 1)) & ~(align - 1);
+    }
+    // offset of column I in the block of n rows
+    template<std::size_t I>
+    static constexpr std::size_t column_offset(size_type n) noexcept
+    {
+        std::size_t offset = 0;
+        std::size_t i = 0;
+        ((offset = (i++ < I ? align_up(offset, alignof(Ts)) + n * sizeof(Ts) : offset)), ...);
+        return align_up(offset, alignof(field_type<I>));
+    }
+    static constexpr std::size_t block_bytes(size_type n) noexcept
+    {
+        constexpr std::size_t last = sizeof...(Ts) - 1;
+        return column_offset<last>(n) + n * sizeof(field_type<last>);
+    }
+    template<std::size_t... I>
+    static columns_type layout(void* block, size_type n, std::index_sequence<I...>) noexcept
+    {
+        unsigned char* p = static_cast<unsigned char*>(block);
+        return columns_type(reinterpret_cast<Ts*>(p + column_offset<I>(n))...);
+    }
+    template<typename F>
+    void for_each_column(F&& f)
+    {
+        std::apply([&f](auto*... col) { (f(col), ...); }, cols);
+    }
+    void release() noexcept
+    {
+        if (cap > 0)
+        {
+            impl::_deallocate_bytes(std::get<0>(cols), alignment);
+        }
+    }
+    // reallocate to new_cap >= count rows, elements are relocated column by column
+    void reallocate(size_type new_cap)
+    {
+        assert(new_cap >= count);
+        columns_type new_cols{};
+        if (new_cap > 0)
+        {
+            new_cols = layout(impl::_allocate_bytes(block_bytes(new_cap), alignment), new_cap, std::index_sequence_for<Ts...>{});
+            relocate_columns(new_cols, std::index_sequence_for<Ts...>{});
+        }
+        release();
+        cols = new_cols;
+        cap = new_cap;
+    }
+    template<std::size_t... I>
+    void relocate_columns(const columns_type& dest, std::index_sequence<I...>)
+    {
+        if (count > 0)
+        {
+            (impl::_relocate(std::get<I>(cols), std::get<I>(cols) + count, std::get<I>(dest)), ...);
+        }
+    }
+    // construct row idx of columns target from one argument per field, the constructed fields are destroyed if one throws
+    template<std::size_t... I, typename... Args>
+    static void construct_row(const columns_type& target, size_type idx, std::index_sequence<I...>, Args&&... args)
+    {
+        std::size_t constructed = 0;
+        try
+        {
+            ((impl::_construct(std::get<I>(target) + idx, std::forward<Args>(args)), ++constructed), ...);
+        }
+        catch (...)
+        {
+            ((I < constructed ? impl::_destroy(std::get<I>(target) + idx) : void()), ...);
+            throw;
+        }
+    }
+    template<std::size_t... I>
+    void value_construct_back(std::index_sequence<I...>)
+    {
+        emplace_back(field_type<I>()...);
+    }
+    void destroy_range(size_type first, size_type last) noexcept
+    {
+        for_each_column([first, last](auto* col) { tstd::destroy(col + first, col + last); });
+    }
+public:
+    // constructors
+    soa_vector() noexcept
+        : cols()
+        , count(0)
+        , cap(0)
+    {
+    }
+    explicit soa_vector(size_type n)
+        : soa_vector()
+    {
+        resize(n);
+    }
+    soa_vector(size_type n, const value_type& value)
+        : soa_vector()
+    {
+        resize(n, value);
+    }
+    soa_vector(std::initializer_list<value_type> ilist)
+        : soa_vector()
+    {
+        reserve(ilist.size());
+        for (const value_type& value : ilist)
+        {
+            push_back(value);
+        }
+    }
+    soa_vector(const soa_vector& other)
+        : soa_vector()
+    {
+        reserve(other.count);
+        copy_columns(other, std::index_sequence_for<Ts...>{});
+        count = other.count;
+    }
+    soa_vector(soa_vector&& other) noexcept
+        : cols(std::exchange(other.cols, columns_type()))
+        , count(std::exchange(other.count, 0))
+        , cap(std::exchange(other.cap, 0))
+    {
+    }
+    ~soa_vector()
+    {
+        clear();
+        release();
+    }
+private:
+    // copy column by column, the finished columns are destroyed if one throws
+    template<std::size_t... I>
+    void copy_columns(const soa_vector& other, std::index_sequence<I...>)
+    {
+        std::size_t copied = 0;
+        try
+        {
+            ((tstd::uninitialized_copy(std::get<I>(other.cols), std::get<I>(other.cols) + other.count, std::get<I>(cols)), ++copied), ...);
+        }
+        catch (...)
+        {
+            ((I < copied ? tstd::destroy(std::get<I>(cols), std::get<I>(cols) + other.count) : void()), ...);
+            throw;
+        }
+    }
+public:
+    // assignment
+    soa_vector& operator=(const soa_vector& rhs)
+    {
+        if (this != &rhs)
+        {
+            soa_vector tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+    soa_vector& operator=(soa_vector&& rhs) noexcept
+    {
+        soa_vector tmp(std::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+    soa_vector& operator=(std::initializer_list<value_type> ilist)
+    {
+        soa_vector tmp(ilist);
+        swap(tmp);
+        return *this;
+    }
+
+    // element access
+    reference at(size_type pos)
+    {
+        if (pos >= count)
+        {
+            throw std::out_of_range("soa_vector::at : input index is out of bounds");
+        }
+        return begin()[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        if (pos >= count)
+        {
+            throw std::out_of_range("soa_vector::at : input index is out of bounds");
+        }
+        return begin()[pos];
+    }
+    reference operator[](size_type pos) noexcept
+    {
+        return begin()[pos];
+    }
+    const_reference operator[](size_type pos) const noexcept
+    {
+        return begin()[pos];
+    }
+    reference front() noexcept
+    {
+        return *begin();
+    }
+    const_reference front() const noexcept
+    {
+        return *begin();
+    }
+    reference back() noexcept
+    {
+        return begin()[count - 1];
+    }
+    const_reference back() const noexcept
+    {
+        return begin()[count - 1];
+    }
+    // column I as a contiguous array
+    template<std::size_t I>
+    field_type<I>* data() noexcept
+    {
+        return std::get<I>(cols);
+    }
+    template<std::size_t I>
+    const field_type<I>* data() const noexcept
+    {
+        return std::get<I>(cols);
+    }
+    template<std::size_t I>
+    std::span<field_type<I>> column() noexcept
+    {
+        return std::span<field_type<I>>(std::get<I>(cols), count);
+    }
+    template<std::size_t I>
+    std::span<const field_type<I>> column() const noexcept
+    {
+        return std::span<const field_type<I>>(std::get<I>(cols), count);
+    }
+
+    // iterators
+    iterator begin() noexcept
+    {
+        return iterator(cols, 0);
+    }
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(cols, 0);
+    }
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    iterator end() noexcept
+    {
+        return iterator(cols, static_cast<difference_type>(count));
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator(cols, static_cast<difference_type>(count));
+    }
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+    reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator crbegin() const noexcept
+    {
+        return rbegin();
+    }
+    reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+    const_reverse_iterator crend() const noexcept
+    {
+        return rend();
+    }
+
+    // capacity
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+    size_type size() const noexcept
+    {
+        return count;
+    }
+    size_type max_size() const noexcept
+    {
+        return (static_cast<size_type>(std::numeric_limits<difference_type>::max()) - sizeof...(Ts) * alignment) / row_bytes;
+    }
+    void reserve(size_type new_cap)
+    {
+        if (new_cap > cap)
+        {
+            if (new_cap > max_size())
+            {
+                throw std::length_error("soa_vector: size exceeds max_size()");
+            }
+            reallocate(new_cap);
+        }
+    }
+    size_type capacity() const noexcept
+    {
+        return cap;
+    }
+    void shrink_to_fit()
+    {
+        if (cap > count)
+        {
+            reallocate(count);
+        }
+    }
+
+    // modifiers
+    void clear() noexcept
+    {
+        destroy_range(0, count);
+        count = 0;
+    }
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        difference_type idx = pos - cbegin();
+        push_back(value);
+        tstd::rotate(begin() + idx, end() - 1, end());
+        return begin() + idx;
+    }
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        difference_type idx = pos - cbegin();
+        push_back(std::move(value));
+        tstd::rotate(begin() + idx, end() - 1, end());
+        return begin() + idx;
+    }
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        size_type idx = static_cast<size_type>(first - cbegin());
+        size_type n = static_cast<size_type>(last - first);
+        if (n > 0)
+        {
+            size_type old_count = count;
+            for_each_column([idx, n, old_count](auto* col) { tstd::move(col + idx + n, col + old_count, col + idx); });
+            destroy_range(old_count - n, old_count);
+            count = old_count - n;
+        }
+        return begin() + idx;
+    }
+    void push_back(const value_type& value)
+    {
+        std::apply([this](const Ts&... fields) { emplace_back(fields...); }, value);
+    }
+    void push_back(value_type&& value)
+    {
+        std::apply([this](Ts&... fields) { emplace_back(std::move(fields)...); }, value);
+    }
+    // one argument per field
+    template<typename... Args>
+        requires (sizeof...(Args) == sizeof...(Ts))
+    reference emplace_back(Args&&... args)
+    {
+        if (count < cap)
+        {
+            construct_row(cols, count, std::index_sequence_for<Ts...>{}, std::forward<Args>(args)...);
+        }
+        else
+        {
+            if (count >= max_size())
+            {
+                throw std::length_error("soa_vector: size exceeds max_size()");
+            }
+            // construct the new row before relocating, arguments may refer to the old rows
+            size_type new_cap = 2 * cap > count + 1 ? 2 * cap : count + 1;
+            void* block = impl::_allocate_bytes(block_bytes(new_cap), alignment);
+            columns_type new_cols = layout(block, new_cap, std::index_sequence_for<Ts...>{});
+            try
+            {
+                construct_row(new_cols, count, std::index_sequence_for<Ts...>{}, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                impl::_deallocate_bytes(block, alignment);
+                throw;
+            }
+            relocate_columns(new_cols, std::index_sequence_for<Ts...>{});
+            release();
+            cols = new_cols;
+            cap = new_cap;
+        }
+        ++count;
+        return back();
+    }
+    void pop_back() noexcept
+    {
+        assert(count > 0);
+        destroy_range(count - 1, count);
+        --count;
+    }
+    void resize(size_type n)
+    {
+        if (n < count)
+        {
+            destroy_range(n, count);
+            count = n;
+            return;
+        }
+        reserve(n);
+        while (count < n)
+        {
+            value_construct_back(std::index_sequence_for<Ts...>{});
+        }
+    }
+    void resize(size_type n, const value_type& value)
+    {
+        if (n < count)
+        {
+            destroy_range(n, count);
+            count = n;
+            return;
+        }
+        reserve(n);
+        while (count < n)
+        {
+            push_back(value);
+        }
+    }
+    void swap(soa_vector& other) noexcept
+    {
+        std::swap(cols, other.cols);
+        std::swap(count, other.count);
+        std::swap(cap, other.cap);
+    }
+};
+
+// non-member functions
+template<typename... Ts>
+bool operator==(const soa_vector<Ts...>& lhs, const soa_vector<Ts...>& rhs)
+{
+    return lhs.size() == rhs.size() && tstd::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<typename... Ts>
+void swap(soa_vector<Ts...>& lhs, soa_vector<Ts...>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace tstd
+
+// soa_vector rows are tuple-like
+template<typename... Ts>
+struct std::tuple_size<tstd::impl::soa_reference<Ts...>> : std::integral_constant<std::size_t, sizeof...(Ts)> {};
+
+template<std::size_t I, typename... Ts>
+struct std::tuple_element<I, tstd::impl::soa_reference<Ts...>>
+{
+    using type = std::tuple_element_t<I, std::tuple<Ts...>>&;
+};
+
+#endif // TSOA_VECTOR_HPP
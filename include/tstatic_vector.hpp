@@ -0,0 +1,588 @@
+#ifndef TSTATIC_VECTOR_HPP
+#define TSTATIC_VECTOR_HPP
+
+#include <tstl_uninitialized.hpp>
+#include <titerator.hpp>
+#include <tutility.hpp>
+#include <talgorithm.hpp>
+#include <initializer_list>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <memory>    // for std::construct_at/std::destroy_at
+#include <new>       // for std::bad_alloc
+#include <stdexcept> // for std::out_of_range
+#include <iterator>
+#include <cassert>
+
+namespace tstd
+{
+
+namespace impl
+{
+
+// storage of N elements inside the object: trivial elements live in a plain array, like tstd::array,
+// which makes static_vector usable in constant expressions; others are constructed in raw bytes.
+template<typename T, std::size_t N, bool Trivial = std::is_trivial_v<T>>
+struct static_vector_storage
+{
+    T elems[N];
+    constexpr T* data() noexcept
+    {
+        return elems;
+    }
+    constexpr const T* data() const noexcept
+    {
+        return elems;
+    }
+};
+template<typename T, std::size_t N>
+struct static_vector_storage<T, N, false>
+{
+    alignas(T) unsigned char bytes[N * sizeof(T)];
+    T* data() noexcept
+    {
+        return reinterpret_cast<T*>(bytes);
+    }
+    const T* data() const noexcept
+    {
+        return reinterpret_cast<const T*>(bytes);
+    }
+};
+
+// smallest unsigned type that holds N
+template<std::size_t N>
+using static_vector_size_t = std::conditional_t<N <= UINT8_MAX, std::uint8_t,
+    std::conditional_t<N <= UINT16_MAX, std::uint16_t,
+    std::conditional_t<N <= UINT32_MAX, std::uint32_t, std::size_t>>>;
+
+} // namespace impl
+
+// vector with fixed capacity N inside the object (inplace_vector): never allocates, the size is stored in the smallest
+// unsigned type that holds N. Its interface is the same as tstd::vector, growing beyond N throws std::bad_alloc,
+// try_push_back/try_emplace_back return nullptr instead, push_back_unchecked/emplace_back_unchecked only assert.
+// With trivial T, it's usable in constant expressions.
+// Could be the container of tstd::stack and tstd::priority_queue.
+template<typename T, std::size_t N>
+class static_vector
+{
+    static_assert(N > 0, "capacity of static_vector must be positive");
+public:
+    using value_type = T;
+    using size_type= std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = tstd::reverse_iterator<iterator>;
+    using const_reverse_iterator = tstd::reverse_iterator<const_iterator>;
+public:
+    // constructors
+    constexpr static_vector() noexcept // 1
+        : sz(0)
+    {
+    }
+    constexpr static_vector(size_type count, const T& value) // 2
+        : sz(0)
+    {
+        assign(count, value);
+    }
+    constexpr explicit static_vector(size_type count) // 3
+        : sz(0)
+    {
+        check_capacity(count);
+        while (sz < count)
+        {
+            construct_back();
+        }
+    }
+    template<typename InputIterator,
+        typename = std::enable_if_t<std::is_base_of_v<typename std::input_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>>>
+    constexpr static_vector(InputIterator first, InputIterator last) // 4
+        : sz(0)
+    {
+        assign(first, last);
+    }
+    constexpr static_vector(const static_vector& other) // 5
+        : sz(0)
+    {
+        assign(other.begin(), other.end());
+    }
+    constexpr static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) // 6
+        : sz(0)
+    {
+        assign(tstd::make_move_iterator(other.begin()), tstd::make_move_iterator(other.end()));
+    }
+    constexpr static_vector(std::initializer_list<T> il) // 7
+        : sz(0)
+    {
+        assign(il.begin(), il.end());
+    }
+    // destructor, trivial for trivially destructible elements
+    constexpr ~static_vector() requires std::is_trivially_destructible_v<T> = default;
+    constexpr ~static_vector()
+    {
+        clear();
+    }
+    // operator =
+    constexpr static_vector& operator=(const static_vector& rhs) // 1
+    {
+        if (this != &rhs)
+        {
+            assign(rhs.begin(), rhs.end());
+        }
+        return *this;
+    }
+    constexpr static_vector& operator=(static_vector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) // 2
+    {
+        if (this != &rhs)
+        {
+            assign(tstd::make_move_iterator(rhs.begin()), tstd::make_move_iterator(rhs.end()));
+        }
+        return *this;
+    }
+    constexpr static_vector& operator=(std::initializer_list<T> il) // 3
+    {
+        assign(il.begin(), il.end());
+        return *this;
+    }
+    // assign
+    constexpr void assign(size_type count, const T& value) // 1
+    {
+        check_capacity(count);
+        T copy(value); // value may be an element
+        clear();
+        while (sz < count)
+        {
+            construct_back(copy);
+        }
+    }
+    template<typename InputIterator,
+        typename = std::enable_if_t<std::is_base_of_v<typename std::input_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>>>
+    constexpr void assign(InputIterator first, InputIterator last) // 2
+    {
+        if constexpr (tstd::is_forward_iterator_v<InputIterator>)
+        {
+            check_capacity(static_cast<size_type>(tstd::distance(first, last)));
+        }
+        clear();
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+    }
+    constexpr void assign(std::initializer_list<T> il) // 3
+    {
+        assign(il.begin(), il.end());
+    }
+
+    // element access
+    constexpr reference at(size_type pos)
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("static_vector::at : input index is out of bounds");
+        }
+        return data()[pos];
+    }
+    constexpr const_reference at(size_type pos) const
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("static_vector::at : input index is out of bounds");
+        }
+        return data()[pos];
+    }
+    constexpr reference operator[](size_type pos)
+    {
+        assert(pos < size());
+        return data()[pos];
+    }
+    constexpr const_reference operator[](size_type pos) const
+    {
+        assert(pos < size());
+        return data()[pos];
+    }
+    constexpr reference front()
+    {
+        assert(!empty());
+        return data()[0];
+    }
+    constexpr const_reference front() const
+    {
+        assert(!empty());
+        return data()[0];
+    }
+    constexpr reference back()
+    {
+        assert(!empty());
+        return data()[sz - 1];
+    }
+    constexpr const_reference back() const
+    {
+        assert(!empty());
+        return data()[sz - 1];
+    }
+    constexpr T* data() noexcept
+    {
+        return storage.data();
+    }
+    constexpr const T* data() const noexcept
+    {
+        return storage.data();
+    }
+
+    // iterators
+    constexpr iterator begin() noexcept
+    {
+        return data();
+    }
+    constexpr const_iterator begin() const noexcept
+    {
+        return data();
+    }
+    constexpr const_iterator cbegin() const noexcept
+    {
+        return data();
+    }
+    constexpr iterator end() noexcept
+    {
+        return data() + sz;
+    }
+    constexpr const_iterator end() const noexcept
+    {
+        return data() + sz;
+    }
+    constexpr const_iterator cend() const noexcept
+    {
+        return data() + sz;
+    }
+    constexpr reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+    constexpr const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+    constexpr const_reverse_iterator crbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+    constexpr reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+    constexpr const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+    constexpr const_reverse_iterator crend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    // size and capacity
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return sz == 0;
+    }
+    constexpr size_type size() const noexcept
+    {
+        return sz;
+    }
+    static constexpr size_type max_size() noexcept
+    {
+        return N;
+    }
+    static constexpr size_type capacity() noexcept
+    {
+        return N;
+    }
+    // nothing to reserve, throw std::bad_alloc if new_cap > N
+    constexpr void reserve(size_type new_cap)
+    {
+        check_capacity(new_cap);
+    }
+    constexpr void shrink_to_fit() noexcept
+    {
+    }
+
+    // modifiers
+    constexpr void clear() noexcept
+    {
+        while (sz > 0)
+        {
+            destroy_back();
+        }
+    }
+    constexpr iterator insert(const_iterator pos, const T& value) // 1
+    {
+        return emplace(pos, value);
+    }
+    constexpr iterator insert(const_iterator pos, T&& value) // 2
+    {
+        return emplace(pos, std::move(value));
+    }
+    constexpr iterator insert(const_iterator pos, size_type count, const T& value) // 3
+    {
+        size_type idx = size_type(pos - begin());
+        check_capacity(size() + count);
+        T copy(value); // value may be an element
+        for (size_type i = 0; i < count; ++i)
+        {
+            construct_back(copy);
+        }
+        tstd::rotate(begin() + idx, end() - count, end());
+        return begin() + idx;
+    }
+    template<typename InputIterator,
+        typename = std::enable_if_t<std::is_base_of_v<typename std::input_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>>>
+    constexpr iterator insert(const_iterator pos, InputIterator first, InputIterator last) // 4
+    {
+        size_type idx = size_type(pos - begin());
+        size_type old_size = size();
+        if constexpr (tstd::is_forward_iterator_v<InputIterator>)
+        {
+            check_capacity(size() + static_cast<size_type>(tstd::distance(first, last)));
+        }
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+        tstd::rotate(begin() + idx, begin() + old_size, end());
+        return begin() + idx;
+    }
+    constexpr iterator insert(const_iterator pos, std::initializer_list<T> il) // 5
+    {
+        return insert(pos, il.begin(), il.end());
+    }
+    template<typename... Args>
+    constexpr iterator emplace(const_iterator pos, Args&&... args)
+    {
+        size_type idx = size_type(pos - begin());
+        check_capacity(size() + 1);
+        construct_back(std::forward<Args>(args)...);
+        tstd::rotate(begin() + idx, end() - 1, end());
+        return begin() + idx;
+    }
+    constexpr iterator erase(const_iterator pos) // 1
+    {
+        return erase(pos, pos + 1);
+    }
+    constexpr iterator erase(const_iterator first, const_iterator last) // 2
+    {
+        iterator dest = begin() + (first - begin());
+        if (first == last)
+        {
+            return dest;
+        }
+        iterator new_end = tstd::move(dest + (last - first), end(), dest);
+        while (end() != new_end)
+        {
+            destroy_back();
+        }
+        return dest;
+    }
+    constexpr void push_back(const T& value) // 1
+    {
+        emplace_back(value);
+    }
+    constexpr void push_back(T&& value) // 2
+    {
+        emplace_back(std::move(value));
+    }
+    template<typename... Args>
+    constexpr reference emplace_back(Args&&... args)
+    {
+        check_capacity(size() + 1);
+        construct_back(std::forward<Args>(args)...);
+        return back();
+    }
+    // non-standard: append if not full, return pointer to the new element, or nullptr if full
+    constexpr T* try_push_back(const T& value) // 1
+    {
+        return try_emplace_back(value);
+    }
+    constexpr T* try_push_back(T&& value) // 2
+    {
+        return try_emplace_back(std::move(value));
+    }
+    template<typename... Args>
+    constexpr T* try_emplace_back(Args&&... args)
+    {
+        if (sz == N)
+        {
+            return nullptr;
+        }
+        construct_back(std::forward<Args>(args)...);
+        return &back();
+    }
+    // non-standard: append without checking capacity, size() < capacity() is required
+    constexpr void push_back_unchecked(const T& value) // 1
+    {
+        emplace_back_unchecked(value);
+    }
+    constexpr void push_back_unchecked(T&& value) // 2
+    {
+        emplace_back_unchecked(std::move(value));
+    }
+    template<typename... Args>
+    constexpr reference emplace_back_unchecked(Args&&... args)
+    {
+        assert(sz < N);
+        construct_back(std::forward<Args>(args)...);
+        return back();
+    }
+    constexpr void pop_back()
+    {
+        assert(!empty());
+        destroy_back();
+    }
+    constexpr void resize(size_type count) // 1
+    {
+        check_capacity(count);
+        while (sz > count)
+        {
+            destroy_back();
+        }
+        while (sz < count)
+        {
+            construct_back();
+        }
+    }
+    constexpr void resize(size_type count, const value_type& value) // 2
+    {
+        check_capacity(count);
+        while (sz > count)
+        {
+            destroy_back();
+        }
+        if (sz < count)
+        {
+            T copy(value); // value may be an element
+            while (sz < count)
+            {
+                construct_back(copy);
+            }
+        }
+    }
+    constexpr void swap(static_vector& other) noexcept(std::is_nothrow_swappable_v<T> && std::is_nothrow_move_constructible_v<T>)
+    {
+        static_vector& longer = size() < other.size() ? other : *this;
+        static_vector& shorter = size() < other.size() ? *this : other;
+        size_type common = shorter.size();
+        tstd::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+        for (size_type i = common; i < longer.size(); ++i)
+        {
+            shorter.construct_back(std::move(longer[i]));
+        }
+        while (longer.size() > common)
+        {
+            longer.destroy_back();
+        }
+    }
+private:
+    // auxiliary functions
+    static constexpr void check_capacity(size_type count)
+    {
+        if (count > N)
+        {
+            throw std::bad_alloc();
+        }
+    }
+    // construct an element at end, there must be room for it
+    template<typename... Args>
+    constexpr void construct_back(Args&&... args)
+    {
+        std::construct_at(data() + sz, std::forward<Args>(args)...);
+        ++sz;
+    }
+    constexpr void destroy_back() noexcept
+    {
+        --sz;
+        std::destroy_at(data() + sz);
+    }
+private:
+    impl::static_vector_storage<T, N> storage;
+    impl::static_vector_size_t<N> sz;
+};
+
+// non-member operations
+// a non-standard compare function for tstd::static_vector
+// equal 0 less -1 greater 1
+template<typename T, std::size_t N>
+constexpr int _cmp_static_vector(const tstd::static_vector<T, N>& lhs, const tstd::static_vector<T, N>& rhs)
+{
+    using const_iterator = typename tstd::static_vector<T, N>::const_iterator;
+    if constexpr (impl::is_memcmp_comparable_v<const_iterator, const_iterator>)
+    {
+        auto cmp = tstd::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        return cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+    }
+    auto iter1 = lhs.begin();
+    auto iter2 = rhs.begin();
+    for (; iter1 != lhs.end() && iter2 != rhs.end(); ++iter1, ++iter2)
+    {
+        if (*iter1 == *iter2)
+        {
+            continue;
+        }
+        return *iter1 > *iter2 ? 1 : -1;
+    }
+    if (iter1 != lhs.end())
+    {
+        return 1;
+    }
+    if (iter2 != rhs.end())
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// comparisons
+template<typename T, std::size_t N>
+constexpr bool operator==(const tstd::static_vector<T, N>& lhs, const tstd::static_vector<T, N>& rhs)
+{
+    return lhs.size() == rhs.size() && tstd::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+template<typename T, std::size_t N>
+constexpr bool operator!=(const tstd::static_vector<T, N>& lhs, const tstd::static_vector<T, N>& rhs)
+{
+    return !(lhs == rhs);
+}
+template<typename T, std::size_t N>
+constexpr bool operator<(const tstd::static_vector<T, N>& lhs, const tstd::static_vector<T, N>& rhs)
+{
+    return _cmp_static_vector(lhs, rhs) < 0;
+}
+template<typename T, std::size_t N>
+constexpr bool operator<=(const tstd::static_vector<T, N>& lhs, const tstd::static_vector<T, N>& rhs)
+{
+    return _cmp_static_vector(lhs, rhs) <= 0;
+}
+template<typename T, std::size_t N>
+constexpr bool operator>(const tstd::static_vector<T, N>& lhs, const tstd::static_vector<T, N>& rhs)
+{
+    return _cmp_static_vector(lhs, rhs) > 0;
+}
+template<typename T, std::size_t N>
+constexpr bool operator>=(const tstd::static_vector<T, N>& lhs, const tstd::static_vector<T, N>& rhs)
+{
+    return _cmp_static_vector(lhs, rhs) >= 0;
+}
+
+// global swap for tstd::static_vector
+template<typename T, std::size_t N>
+constexpr void swap(tstd::static_vector<T, N>& lhs, tstd::static_vector<T, N>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+} // namespace tstd
+
+#endif // TSTATIC_VECTOR_HPP
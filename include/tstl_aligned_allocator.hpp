@@ -0,0 +1,92 @@
+#ifndef TSTL_ALIGNED_ALLOCATOR_HPP
+#define TSTL_ALIGNED_ALLOCATOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <new>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace tstd
+{
+
+// size of a cache line, for aligning hot buffers and avoiding false sharing.
+inline constexpr std::size_t cache_line_size = 64;
+
+// aligned allocator: every block is aligned to at least Align bytes (and alignof(T)).
+// e.g. tstd::vector<float, tstd::aligned_allocator<float>> put its storage on cache line boundaries,
+// deque blocks and hash table bucket arrays are aligned too since they use rebound allocators.
+template<typename T, std::size_t Align = cache_line_size>
+class aligned_allocator
+{
+    static_assert(Align > 0 && (Align & (Align - 1)) == 0, "alignment must be a power of 2");
+public:
+    inline constexpr static std::size_t alignment = Align > alignof(T) ? Align : alignof(T);
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    template<typename U> struct rebind {
+        using other = aligned_allocator<U, Align>;
+    };
+    using is_always_equal = std::true_type;
+
+    constexpr aligned_allocator() noexcept = default;
+    constexpr aligned_allocator(const aligned_allocator& other) noexcept = default;
+    template<typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, Align>& other) noexcept {}
+
+    [[nodiscard]] T* allocate(size_type n)
+    {
+        if (n > max_size())
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(impl::_allocate_bytes(n * sizeof(T), alignment));
+    }
+    void deallocate(T* p, [[maybe_unused]] size_type n)
+    {
+        impl::_deallocate_bytes(p, alignment);
+    }
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        impl::_construct(p, std::forward<Args>(args)...);
+    }
+    template<typename U>
+    void destroy(U* p)
+    {
+        impl::_destroy(p);
+    }
+    size_type max_size() const noexcept
+    {
+        return static_cast<size_type>(std::numeric_limits<size_t>::max() / sizeof(T));
+    }
+    pointer address(reference x) const noexcept
+    {
+        return static_cast<pointer>(&x);
+    }
+    const_pointer address(const_reference x) const noexcept
+    {
+        return static_cast<const_pointer>(&x);
+    }
+};
+
+template<typename T1, typename T2, std::size_t Align>
+constexpr bool operator==(const aligned_allocator<T1, Align>& lhs, const aligned_allocator<T2, Align>& rhs) noexcept
+{
+    return true;
+}
+template<typename T1, typename T2, std::size_t Align>
+constexpr bool operator!=(const aligned_allocator<T1, Align>& lhs, const aligned_allocator<T2, Align>& rhs) noexcept
+{
+    return false;
+}
+
+} // namespace tstd
+
+#endif // TSTL_ALIGNED_ALLOCATOR_HPP
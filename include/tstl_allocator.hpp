@@ -5,30 +5,93 @@
 #include <cstddef> // for ptrdiff_t size_t
 #include <limits>  // for numeric_limits
 #include <type_traits>
+#include <concepts>
+#include <utility> // for std::forward
+#include <cstdlib> // for malloc free
+#if defined(__GLIBC__)
+#include <malloc.h> // for malloc_usable_size
+#endif
 
 namespace tstd
 {
 
+// result of allocate_at_least: a block of count elements, count >= requested number
+template<typename Pointer, typename SizeType = std::size_t>
+struct allocation_result
+{
+    Pointer ptr;
+    SizeType count;
+};
+
 namespace impl
 {
 
 // auxiliary global functions for allocator
-template<typename T>
-inline T* _allocate(ptrdiff_t size, [[maybe_unused]] T*)
+// Blocks of default alignment come from malloc (like the first level allocator of SGI STL),
+// so that the real usable size of a block could be queried by malloc_usable_size on glibc.
+// Like ::operator new, calls new-handler on failure and throws std::bad_alloc if there is none.
+inline void* _malloc_bytes(size_t bytes)
+{
+    for (;;)
+    {
+        if (void* p = std::malloc(bytes > 0 ? bytes : 1))
+        {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+        {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+// allocate bytes aligned to alignment, alignment must be a power of 2.
+// alignment stricter than __STDCPP_DEFAULT_NEW_ALIGNMENT__ uses aligned ::operator new.
+inline void* _allocate_bytes(size_t bytes, size_t alignment = alignof(std::max_align_t))
 {
-    std::set_new_handler(nullptr);
-    T* tmp = static_cast<T*>(::operator new(static_cast<size_t>(size * sizeof(T))));
-    if (tmp == 0)
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
     {
-        throw std::bad_alloc();
+        return ::operator new(bytes, std::align_val_t(alignment));
     }
-    return tmp;
+    return _malloc_bytes(bytes);
+}
+
+// alignment must be the same as the one passed to _allocate_bytes
+inline void _deallocate_bytes(void* p, size_t alignment = alignof(std::max_align_t))
+{
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+    else
+    {
+        std::free(p);
+    }
+}
+
+// usable size of block p of bytes got from _allocate_bytes with default alignment, at least bytes
+inline size_t _usable_size([[maybe_unused]] void* p, size_t bytes)
+{
+#if defined(__GLIBC__)
+    size_t usable = ::malloc_usable_size(p);
+    return usable > bytes ? usable : bytes;
+#else
+    return bytes;
+#endif
+}
+
+template<typename T>
+inline T* _allocate(ptrdiff_t size, [[maybe_unused]] T*)
+{
+    return static_cast<T*>(_allocate_bytes(static_cast<size_t>(size * sizeof(T)), alignof(T)));
 }
 
 template<typename T>
 inline void _deallocate(T* buffer)
 {
-    ::operator delete(buffer);
+    _deallocate_bytes(buffer, alignof(T));
 }
 
 template<typename T1, typename... Args>
@@ -46,6 +109,35 @@ inline void _destroy(T* ptr)
     }
 }
 
+// allocators that could tell the real size of a block provide
+// tstd::allocation_result<T*> allocate_at_least(size_type n), the block must be deallocated with the returned count.
+template<typename Allocator>
+inline constexpr bool has_allocate_at_least_v = requires(Allocator& alloc, std::size_t n) {
+    alloc.allocate_at_least(n);
+};
+
+// allocators that could resize a block keeping its bytes (e.g. by mremap) provide
+// T* try_reallocate(T* p, size_type old_n, size_type new_n), which returns nullptr on failure.
+template<typename Allocator>
+inline constexpr bool has_try_reallocate_v = requires(Allocator& alloc, typename Allocator::value_type* p, std::size_t n) {
+    { alloc.try_reallocate(p, n, n) } -> std::same_as<typename Allocator::value_type*>;
+};
+
+// allocate at least n elements by alloc, return the real number of elements
+template<typename Allocator>
+inline allocation_result<typename Allocator::value_type*> _allocate_at_least(Allocator& alloc, std::size_t n)
+{
+    if constexpr (has_allocate_at_least_v<Allocator>)
+    {
+        auto result = alloc.allocate_at_least(n);
+        return {result.ptr, result.count};
+    }
+    else
+    {
+        return {alloc.allocate(n), n};
+    }
+}
+
 } // namespace impl
 
 // allocator
@@ -77,9 +169,9 @@ public:
     constexpr allocator(const allocator<U>& other) noexcept {}
 
     // deprecated in C++17, removed in C++20
-    T* allocate(size_type n, const void* hint)
+    T* allocate(size_type n, [[maybe_unused]] const void* hint)
     {
-        return impl::_allocate(static_cast<difference_type>(n), hint);
+        return impl::_allocate(static_cast<difference_type>(n), (T*)nullptr);
     }
 
     [[nodiscard]] constexpr T* allocate(size_type n)
@@ -87,6 +179,20 @@ public:
         return impl::_allocate(static_cast<difference_type>(n), (T*)nullptr);
     }
 
+    // the block may be larger than n elements, the real count is returned
+    [[nodiscard]] allocation_result<T*> allocate_at_least(size_type n)
+    {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return {allocate(n), n};
+        }
+        else
+        {
+            T* p = allocate(n);
+            return {p, impl::_usable_size(p, n * sizeof(T)) / sizeof(T)};
+        }
+    }
+
     constexpr void deallocate(T* p, [[maybe_unused]] size_type n)
     {
         impl::_deallocate(p);
@@ -0,0 +1,381 @@
+#ifndef TSTL_BIT_ITERATOR_HPP
+#define TSTL_BIT_ITERATOR_HPP
+
+// bit references and iterators of tstd::vector<bool>, and word-at-a-time kernels of algorithms on them
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <compare>
+#include <type_traits>
+#include <bit>
+
+namespace tstd
+{
+
+namespace impl
+{
+
+using bit_word = std::uint64_t;
+inline constexpr unsigned bit_word_bits = 64;
+
+// mask of the low n bits, 0 <= n <= 64
+constexpr bit_word _low_mask(unsigned n) noexcept
+{
+    return n >= bit_word_bits ? ~bit_word(0) : (bit_word(1) << n) - 1;
+}
+
+// proxy reference to a bit
+class bit_reference
+{
+private:
+    bit_word* p;
+    bit_word mask;
+public:
+    constexpr bit_reference(bit_word* _p, unsigned offset) noexcept
+        : p(_p)
+        , mask(bit_word(1) << offset)
+    {
+    }
+    constexpr bit_reference(const bit_reference& other) noexcept = default;
+    constexpr operator bool() const noexcept
+    {
+        return (*p & mask) != 0;
+    }
+    constexpr bit_reference& operator=(bool x) noexcept
+    {
+        if (x)
+        {
+            *p |= mask;
+        }
+        else
+        {
+            *p &= ~mask;
+        }
+        return *this;
+    }
+    constexpr bit_reference& operator=(const bit_reference& other) noexcept
+    {
+        return *this = bool(other);
+    }
+    constexpr bool operator~() const noexcept
+    {
+        return !bool(*this);
+    }
+    constexpr void flip() noexcept
+    {
+        *p ^= mask;
+    }
+    friend constexpr bool operator==(const bit_reference& lhs, const bit_reference& rhs) noexcept
+    {
+        return bool(lhs) == bool(rhs);
+    }
+    // proxies are prvalues, swap them through ADL (tstd::iter_swap)
+    friend constexpr void swap(bit_reference lhs, bit_reference rhs) noexcept
+    {
+        bool tmp = lhs;
+        lhs = bool(rhs);
+        rhs = tmp;
+    }
+    friend constexpr void swap(bit_reference lhs, bool& rhs) noexcept
+    {
+        bool tmp = lhs;
+        lhs = rhs;
+        rhs = tmp;
+    }
+    friend constexpr void swap(bool& lhs, bit_reference rhs) noexcept
+    {
+        bool tmp = lhs;
+        lhs = bool(rhs);
+        rhs = tmp;
+    }
+};
+
+// random access iterator of bits: word pointer and bit offset in the word [0, 64)
+template<bool IsConst>
+class bit_iterator
+{
+    template<bool C> friend class bit_iterator;
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = bool;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = std::conditional_t<IsConst, bool, bit_reference>;
+private:
+    bit_word* p;
+    unsigned offset;
+public:
+    constexpr bit_iterator() noexcept
+        : p(nullptr)
+        , offset(0)
+    {
+    }
+    constexpr bit_iterator(bit_word* _p, unsigned _offset) noexcept
+        : p(_p)
+        , offset(_offset)
+    {
+    }
+    // iterator to const_iterator
+    template<bool C>
+        requires (IsConst && !C)
+    constexpr bit_iterator(const bit_iterator<C>& other) noexcept
+        : p(other.p)
+        , offset(other.offset)
+    {
+    }
+    constexpr bit_word* word() const noexcept
+    {
+        return p;
+    }
+    constexpr unsigned bit_offset() const noexcept
+    {
+        return offset;
+    }
+    constexpr reference operator*() const noexcept
+    {
+        if constexpr (IsConst)
+        {
+            return (*p >> offset) & 1;
+        }
+        else
+        {
+            return bit_reference(p, offset);
+        }
+    }
+    constexpr reference operator[](difference_type n) const noexcept
+    {
+        return *(*this + n);
+    }
+    constexpr bit_iterator& operator++() noexcept
+    {
+        if (++offset == bit_word_bits)
+        {
+            offset = 0;
+            ++p;
+        }
+        return *this;
+    }
+    constexpr bit_iterator operator++(int) noexcept
+    {
+        bit_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    constexpr bit_iterator& operator--() noexcept
+    {
+        if (offset-- == 0)
+        {
+            offset = bit_word_bits - 1;
+            --p;
+        }
+        return *this;
+    }
+    constexpr bit_iterator operator--(int) noexcept
+    {
+        bit_iterator tmp = *this;
+        --*this;
+        return tmp;
+    }
+    constexpr bit_iterator& operator+=(difference_type n) noexcept
+    {
+        difference_type pos = static_cast<difference_type>(offset) + n;
+        difference_type words = pos >= 0 ? pos / difference_type(bit_word_bits) : -((-pos + difference_type(bit_word_bits) - 1) / difference_type(bit_word_bits));
+        p += words;
+        offset = static_cast<unsigned>(pos - words * difference_type(bit_word_bits));
+        return *this;
+    }
+    constexpr bit_iterator& operator-=(difference_type n) noexcept
+    {
+        return *this += -n;
+    }
+    friend constexpr bit_iterator operator+(bit_iterator iter, difference_type n) noexcept
+    {
+        return iter += n;
+    }
+    friend constexpr bit_iterator operator+(difference_type n, bit_iterator iter) noexcept
+    {
+        return iter += n;
+    }
+    friend constexpr bit_iterator operator-(bit_iterator iter, difference_type n) noexcept
+    {
+        return iter -= n;
+    }
+    friend constexpr difference_type operator-(const bit_iterator& lhs, const bit_iterator& rhs) noexcept
+    {
+        return (lhs.p - rhs.p) * difference_type(bit_word_bits) + static_cast<difference_type>(lhs.offset) - static_cast<difference_type>(rhs.offset);
+    }
+    friend constexpr bool operator==(const bit_iterator& lhs, const bit_iterator& rhs) noexcept
+    {
+        return lhs.p == rhs.p && lhs.offset == rhs.offset;
+    }
+    friend constexpr std::strong_ordering operator<=>(const bit_iterator& lhs, const bit_iterator& rhs) noexcept
+    {
+        if (auto cmp = lhs.p <=> rhs.p; cmp != 0)
+        {
+            return cmp;
+        }
+        return lhs.offset <=> rhs.offset;
+    }
+};
+
+// low n bits starting at bit off of p, 0 < n <= 64, may read 2 words
+constexpr bit_word _read_bits(const bit_word* p, unsigned off, unsigned n) noexcept
+{
+    bit_word bits = p[0] >> off;
+    if (off + n > bit_word_bits)
+    {
+        bits |= p[1] << (bit_word_bits - off);
+    }
+    return bits & _low_mask(n);
+}
+
+// write low n bits of bits to bits [off, off + n) of *p, off + n <= 64
+constexpr void _write_bits(bit_word* p, unsigned off, unsigned n, bit_word bits) noexcept
+{
+    bit_word mask = _low_mask(n) << off;
+    *p = (*p & ~mask) | ((bits << off) & mask);
+}
+
+// number of set bits in [first, last)
+template<bool IsConst>
+constexpr std::ptrdiff_t _bit_count(bit_iterator<IsConst> first, bit_iterator<IsConst> last) noexcept
+{
+    if (first == last)
+    {
+        return 0;
+    }
+    const bit_word* p = first.word();
+    const bit_word* lp = last.word();
+    if (p == lp)
+    {
+        return std::popcount(*p & _low_mask(last.bit_offset()) & ~_low_mask(first.bit_offset()));
+    }
+    std::ptrdiff_t result = std::popcount(*p & ~_low_mask(first.bit_offset()));
+    for (++p; p != lp; ++p)
+    {
+        result += std::popcount(*p);
+    }
+    if (last.bit_offset() != 0)
+    {
+        result += std::popcount(*lp & _low_mask(last.bit_offset()));
+    }
+    return result;
+}
+
+// first bit equal to value in [first, last)
+template<bool IsConst>
+constexpr bit_iterator<IsConst> _bit_find(bit_iterator<IsConst> first, bit_iterator<IsConst> last, bool value) noexcept
+{
+    if (first == last)
+    {
+        return last;
+    }
+    bit_word flip = value ? 0 : ~bit_word(0); // search set bits of the flipped words
+    bit_word* p = first.word();
+    bit_word* lp = last.word();
+    bit_word bits = (*p ^ flip) & ~_low_mask(first.bit_offset());
+    if (p == lp)
+    {
+        bits &= _low_mask(last.bit_offset());
+        return bits ? bit_iterator<IsConst>(p, std::countr_zero(bits)) : last;
+    }
+    while (!bits)
+    {
+        if (++p == lp)
+        {
+            if (last.bit_offset() == 0)
+            {
+                return last;
+            }
+            bits = (*p ^ flip) & _low_mask(last.bit_offset());
+            return bits ? bit_iterator<IsConst>(p, std::countr_zero(bits)) : last;
+        }
+        bits = *p ^ flip;
+    }
+    return bit_iterator<IsConst>(p, std::countr_zero(bits));
+}
+
+// set bits in [first, last) to value
+constexpr void _bit_fill(bit_iterator<false> first, bit_iterator<false> last, bool value) noexcept
+{
+    if (first == last)
+    {
+        return;
+    }
+    bit_word* p = first.word();
+    bit_word* lp = last.word();
+    auto fill_masked = [value](bit_word* w, bit_word mask) {
+        *w = value ? (*w | mask) : (*w & ~mask);
+    };
+    if (p == lp)
+    {
+        fill_masked(p, _low_mask(last.bit_offset()) & ~_low_mask(first.bit_offset()));
+        return;
+    }
+    fill_masked(p, ~_low_mask(first.bit_offset()));
+    bit_word word = value ? ~bit_word(0) : 0;
+    for (++p; p != lp; ++p)
+    {
+        *p = word;
+    }
+    if (last.bit_offset() != 0)
+    {
+        fill_masked(lp, _low_mask(last.bit_offset()));
+    }
+}
+
+// copy [first, last) to d_first, d_first must not be in (first, last)
+// every destination word is written once, from 1 or 2 source words
+template<bool IsConst>
+constexpr bit_iterator<false> _bit_copy(bit_iterator<IsConst> first, bit_iterator<IsConst> last, bit_iterator<false> d_first) noexcept
+{
+    std::ptrdiff_t n = last - first;
+    const bit_word* p = first.word();
+    unsigned off = first.bit_offset();
+    bit_word* dp = d_first.word();
+    unsigned doff = d_first.bit_offset();
+    while (n > 0)
+    {
+        unsigned chunk = bit_word_bits - doff;
+        if (static_cast<std::ptrdiff_t>(chunk) > n)
+        {
+            chunk = static_cast<unsigned>(n);
+        }
+        _write_bits(dp, doff, chunk, _read_bits(p, off, chunk));
+        n -= chunk;
+        off += chunk;
+        p += off / bit_word_bits;
+        off %= bit_word_bits;
+        doff += chunk;
+        dp += doff / bit_word_bits;
+        doff %= bit_word_bits;
+    }
+    return bit_iterator<false>(dp, doff);
+}
+
+// copy [first, last) backward to the range ending at d_last, d_last must not be in (first, last)
+template<bool IsConst>
+constexpr bit_iterator<false> _bit_copy_backward(bit_iterator<IsConst> first, bit_iterator<IsConst> last, bit_iterator<false> d_last) noexcept
+{
+    std::ptrdiff_t n = last - first;
+    while (n > 0)
+    {
+        unsigned chunk = d_last.bit_offset() == 0 ? bit_word_bits : d_last.bit_offset();
+        if (static_cast<std::ptrdiff_t>(chunk) > n)
+        {
+            chunk = static_cast<unsigned>(n);
+        }
+        last -= chunk;
+        d_last -= chunk;
+        _write_bits(d_last.word(), d_last.bit_offset(), chunk, _read_bits(last.word(), last.bit_offset(), chunk));
+        n -= chunk;
+    }
+    return d_last;
+}
+
+} // namespace impl
+
+} // namespace tstd
+
+#endif // TSTL_BIT_ITERATOR_HPP
@@ -0,0 +1,249 @@
+#ifndef TSTL_COUNTING_ALLOCATOR_HPP
+#define TSTL_COUNTING_ALLOCATOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <cstddef>
+#include <limits>
+#include <atomic>
+#include <bit>
+#include <ostream>
+#include <type_traits>
+
+namespace tstd
+{
+
+// snapshot of allocation statistics of a counting_allocator tag
+struct allocation_stats
+{
+    // size class i counts blocks in (size_class_bound(i-1), size_class_bound(i)] bytes,
+    // the last class counts all blocks larger than size_class_bound(size_class_count - 2).
+    inline constexpr static std::size_t size_class_count = 16;
+
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t bytes_allocated = 0;
+    std::size_t bytes_deallocated = 0;
+    std::size_t live_bytes = 0;
+    std::size_t peak_live_bytes = 0;
+    std::size_t size_classes[size_class_count] = {};
+
+    static constexpr std::size_t size_class_bound(std::size_t i)
+    {
+        return std::size_t(8) << i;
+    }
+    static constexpr std::size_t size_class_of(std::size_t bytes)
+    {
+        if (bytes <= size_class_bound(0))
+        {
+            return 0;
+        }
+        std::size_t i = static_cast<std::size_t>(std::bit_width(bytes - 1)) - 3;
+        return i < size_class_count ? i : size_class_count - 1;
+    }
+};
+
+// allocation report: totals and non-empty size classes
+inline std::ostream& operator<<(std::ostream& os, const allocation_stats& stats)
+{
+    os << "allocations: " << stats.allocations << ", deallocations: " << stats.deallocations
+        << ", bytes allocated: " << stats.bytes_allocated << ", bytes deallocated: " << stats.bytes_deallocated
+        << ", live bytes: " << stats.live_bytes << ", peak live bytes: " << stats.peak_live_bytes;
+    for (std::size_t i = 0; i < allocation_stats::size_class_count; ++i)
+    {
+        if (stats.size_classes[i] == 0)
+        {
+            continue;
+        }
+        os << "\n\t";
+        if (i + 1 < allocation_stats::size_class_count)
+        {
+            os << "<= " << allocation_stats::size_class_bound(i);
+        }
+        else
+        {
+            os << "> " << allocation_stats::size_class_bound(i - 1);
+        }
+        os << " bytes: " << stats.size_classes[i];
+    }
+    return os;
+}
+
+namespace impl
+{
+// counters of a tag, shared by all counting allocators of the tag (whatever T is)
+template<typename Tag>
+class allocation_counter
+{
+private:
+    inline static std::atomic<std::size_t> allocations = 0;
+    inline static std::atomic<std::size_t> deallocations = 0;
+    inline static std::atomic<std::size_t> bytes_allocated = 0;
+    inline static std::atomic<std::size_t> bytes_deallocated = 0;
+    inline static std::atomic<std::size_t> live_bytes = 0;
+    inline static std::atomic<std::size_t> peak_live_bytes = 0;
+    inline static std::atomic<std::size_t> size_classes[allocation_stats::size_class_count] = {};
+public:
+    static void on_allocate(std::size_t bytes)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        std::size_t live = live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        std::size_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+        while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {
+        }
+        size_classes[allocation_stats::size_class_of(bytes)].fetch_add(1, std::memory_order_relaxed);
+    }
+    static void on_deallocate(std::size_t bytes)
+    {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        bytes_deallocated.fetch_add(bytes, std::memory_order_relaxed);
+        live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    static allocation_stats stats()
+    {
+        allocation_stats res;
+        res.allocations = allocations.load(std::memory_order_relaxed);
+        res.deallocations = deallocations.load(std::memory_order_relaxed);
+        res.bytes_allocated = bytes_allocated.load(std::memory_order_relaxed);
+        res.bytes_deallocated = bytes_deallocated.load(std::memory_order_relaxed);
+        res.live_bytes = live_bytes.load(std::memory_order_relaxed);
+        res.peak_live_bytes = peak_live_bytes.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < allocation_stats::size_class_count; ++i)
+        {
+            res.size_classes[i] = size_classes[i].load(std::memory_order_relaxed);
+        }
+        return res;
+    }
+    // reset all counters but live bytes, peak live bytes restart from current live bytes
+    static void reset()
+    {
+        allocations = 0;
+        deallocations = 0;
+        bytes_allocated = 0;
+        bytes_deallocated = 0;
+        peak_live_bytes = live_bytes.load();
+        for (auto& count : size_classes)
+        {
+            count = 0;
+        }
+    }
+};
+} // namespace impl
+
+// statistics of all counting allocators of Tag
+template<typename Tag>
+allocation_stats get_allocation_stats()
+{
+    return impl::allocation_counter<Tag>::stats();
+}
+
+template<typename Tag>
+void reset_allocation_stats()
+{
+    impl::allocation_counter<Tag>::reset();
+}
+
+// counting allocator: forward to Allocator and record allocations per Tag.
+// e.g. tstd::map<int, int, std::less<int>, tstd::counting_allocator<std::pair<const int, int>, struct MapTag>>
+// then tstd::get_allocation_stats<MapTag>() tells how many allocations the map did.
+template<typename T, typename Tag = void, typename Allocator = tstd::allocator<T>>
+class counting_allocator
+{
+    template<typename U, typename OtherTag, typename OtherAllocator> friend class counting_allocator;
+private:
+    using counter = impl::allocation_counter<Tag>;
+    using traits = std::allocator_traits<Allocator>;
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = typename traits::propagate_on_container_copy_assignment;
+    using propagate_on_container_move_assignment = typename traits::propagate_on_container_move_assignment;
+    using propagate_on_container_swap = typename traits::propagate_on_container_swap;
+    using is_always_equal = typename traits::is_always_equal;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    template<typename U> struct rebind {
+        using other = counting_allocator<U, Tag, typename traits::template rebind_alloc<U>>;
+    };
+
+    counting_allocator() = default;
+    counting_allocator(const Allocator& _alloc)
+        : alloc(_alloc)
+    {
+    }
+    counting_allocator(const counting_allocator& other) = default;
+    template<typename U, typename OtherAllocator>
+    counting_allocator(const counting_allocator<U, Tag, OtherAllocator>& other)
+        : alloc(other.alloc)
+    {
+    }
+    counting_allocator& operator=(const counting_allocator& other) = default;
+
+    [[nodiscard]] T* allocate(size_type n)
+    {
+        T* p = alloc.allocate(n);
+        counter::on_allocate(n * sizeof(T));
+        return p;
+    }
+    void deallocate(T* p, size_type n)
+    {
+        counter::on_deallocate(n * sizeof(T));
+        alloc.deallocate(p, n);
+    }
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        impl::_construct(p, std::forward<Args>(args)...);
+    }
+    template<typename U>
+    void destroy(U* p)
+    {
+        impl::_destroy(p);
+    }
+    size_type max_size() const noexcept
+    {
+        return static_cast<size_type>(std::numeric_limits<size_t>::max() / sizeof(T));
+    }
+    pointer address(reference x) const noexcept
+    {
+        return static_cast<pointer>(&x);
+    }
+    const_pointer address(const_reference x) const noexcept
+    {
+        return static_cast<const_pointer>(&x);
+    }
+    const Allocator& upstream() const noexcept
+    {
+        return alloc;
+    }
+
+    static allocation_stats stats()
+    {
+        return counter::stats();
+    }
+    static void reset_stats()
+    {
+        counter::reset();
+    }
+private:
+    Allocator alloc;
+};
+
+template<typename T1, typename T2, typename Tag, typename Allocator1, typename Allocator2>
+bool operator==(const counting_allocator<T1, Tag, Allocator1>& lhs, const counting_allocator<T2, Tag, Allocator2>& rhs)
+{
+    return lhs.upstream() == rhs.upstream();
+}
+template<typename T1, typename T2, typename Tag, typename Allocator1, typename Allocator2>
+bool operator!=(const counting_allocator<T1, Tag, Allocator1>& lhs, const counting_allocator<T2, Tag, Allocator2>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+} // namespace tstd
+
+#endif // TSTL_COUNTING_ALLOCATOR_HPP
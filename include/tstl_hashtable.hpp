@@ -9,7 +9,7 @@
 #include <talgorithm.hpp>
 #include <cmath>
 #include <tstl_allocator.hpp>
-#include <tvector.hpp>
+#include <tstl_uninitialized.hpp>
 #include <tutility.hpp>
 
 namespace tstd
@@ -25,9 +25,14 @@ class hash_table
 private:
     // list node
     template<typename _Value>
+    struct __hash_table_node;
+    // links are Allocator::pointer rebound to node, could be fancy pointers (e.g. 32-bit slab_ptr of slab_allocator)
+    template<typename _Value>
+    using __hash_table_link = typename std::pointer_traits<typename std::allocator_traits<Allocator>::pointer>::template rebind<__hash_table_node<_Value>>;
+    template<typename _Value>
     struct __hash_table_node
     {
-        __hash_table_node* next;
+        __hash_table_link<_Value> next;
         _Value data;
     };
     // iterator
@@ -44,12 +49,12 @@ private:
         using hash_table = HashTable;
         using iterator = __hash_table_iterator<_Value, std::remove_cv_t<HashTable>, _Value&, _Value*>;
         using self = __hash_table_iterator<_Value, HashTable, Ref, Ptr>;
-        using node = __hash_table_node<_Value>;
+        using link_type = __hash_table_link<_Value>;
 
-        node* cur;
+        link_type cur;
         hash_table* ht;
 
-        __hash_table_iterator(node* _n, hash_table* _tbl) : cur(_n), ht(_tbl) {}
+        __hash_table_iterator(link_type _n, hash_table* _tbl) : cur(_n), ht(_tbl) {}
         __hash_table_iterator() : cur(nullptr), ht(nullptr) {}
         __hash_table_iterator(const iterator& it) : cur(it.cur), ht(it.ht) {}
         reference operator*() const { return cur->data; }
@@ -60,7 +65,7 @@ private:
             {
                 return *this; // protection on end() iterator
             }
-            const node* old = cur;
+            link_type old = cur;
             cur = cur->next;
             if (cur == nullptr)
             {
@@ -100,11 +105,11 @@ private:
 
         using self = __hash_table_local_iterator<_Value, Ref, Ptr>;
         using local_iterator = __hash_table_local_iterator<_Value, _Value&, _Value*>;
-        using node = __hash_table_node<_Value>;
+        using link_type = __hash_table_link<_Value>;
 
-        node* cur;
+        link_type cur;
         __hash_table_local_iterator() : cur(nullptr) {} // end of local_iterator
-        __hash_table_local_iterator(node* p) : cur(p) {}
+        __hash_table_local_iterator(link_type p) : cur(p) {}
         __hash_table_local_iterator(const local_iterator& it) : cur(it.cur) {}
         reference operator*() { return cur->data; }
         pointer operator->() const { return &(operator*()); }
@@ -140,17 +145,115 @@ public:
     using const_reference = const value_type&;
     using pointer = Allocator::pointer;
     using const_pointer = Allocator::const_pointer;
-    using iterator = __hash_table_iterator<Value, hash_table, reference, pointer>;
-    using const_iterator = __hash_table_iterator<Value, const hash_table, const_reference, const_pointer>;
-    using local_iterator = __hash_table_local_iterator<value_type, reference, pointer>;
-    using const_local_iterator = __hash_table_local_iterator<value_type, const_reference, const_pointer>;
+    using iterator = __hash_table_iterator<Value, hash_table, reference, value_type*>;
+    using const_iterator = __hash_table_iterator<Value, const hash_table, const_reference, const value_type*>;
+    using local_iterator = __hash_table_local_iterator<value_type, reference, value_type*>;
+    using const_local_iterator = __hash_table_local_iterator<value_type, const_reference, const value_type*>;
     // node_type and insert_return_type are not supported
 private:
     using node = __hash_table_node<Value>;
-    using vec_allocator = Allocator::template rebind<node*>::other;
     using node_allocator = Allocator::template rebind<node>::other;
-    using link_type = node*;
-    using buckets_type = tstd::vector<link_type, vec_allocator>;
+    using link_type = __hash_table_link<Value>;
+    using link_allocator = typename Allocator::template rebind<link_type>::other;
+    // buckets need pointer arithmetic, which fancy pointers of node allocators may not provide (e.g. slab_ptr),
+    // then buckets are allocated by tstd::allocator.
+    using vec_allocator = std::conditional_t<requires (typename std::allocator_traits<link_allocator>::pointer p) { p + 1; },
+        link_allocator, tstd::allocator<link_type>>;
+    // bucket array, its storage is referred by vec_allocator::pointer,
+    // so buckets could live in the same memory as nodes (e.g. a file mapped by mapped_file_allocator).
+    class buckets_type
+    {
+    private:
+        using bucket_pointer = typename std::allocator_traits<vec_allocator>::pointer;
+        vec_allocator alloc;
+        bucket_pointer data;
+        size_type count;
+        void release() noexcept
+        {
+            if (data)
+            {
+                tstd::destroy(begin(), end());
+                alloc.deallocate(data, count);
+                data = nullptr;
+                count = 0;
+            }
+        }
+    public:
+        explicit buckets_type(const vec_allocator& _alloc)
+            : alloc(_alloc)
+            , data(nullptr)
+            , count(0)
+        {
+        }
+        // every bucket is empty
+        buckets_type(size_type n, const vec_allocator& _alloc)
+            : buckets_type(_alloc)
+        {
+            if (n > 0)
+            {
+                data = alloc.allocate(n);
+                count = n;
+                tstd::uninitialized_fill_n(begin(), n, link_type(nullptr));
+            }
+        }
+        buckets_type(buckets_type&& other) noexcept
+            : alloc(std::move(other.alloc))
+            , data(other.data)
+            , count(other.count)
+        {
+            other.data = nullptr;
+            other.count = 0;
+        }
+        buckets_type& operator=(buckets_type&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                alloc = std::move(other.alloc);
+                data = other.data;
+                count = other.count;
+                other.data = nullptr;
+                other.count = 0;
+            }
+            return *this;
+        }
+        ~buckets_type()
+        {
+            release();
+        }
+        size_type size() const noexcept
+        {
+            return count;
+        }
+        size_type max_size() const noexcept
+        {
+            return std::allocator_traits<vec_allocator>::max_size(alloc);
+        }
+        link_type& operator[](size_type n) noexcept
+        {
+            return data[n];
+        }
+        const link_type& operator[](size_type n) const noexcept
+        {
+            return data[n];
+        }
+        link_type* begin() noexcept
+        {
+            return std::to_address(data);
+        }
+        const link_type* begin() const noexcept
+        {
+            return std::to_address(data);
+        }
+        link_type* end() noexcept
+        {
+            return begin() + count;
+        }
+        const link_type* end() const noexcept
+        {
+            return begin() + count;
+        }
+    };
 private:
     hasher hash_func;
     key_equal k_equal;
@@ -187,10 +290,21 @@ private:
             release_node(p);
         }
     }
+    static vec_allocator bucket_allocator(const Allocator& a)
+    {
+        if constexpr (std::is_constructible_v<vec_allocator, const Allocator&>)
+        {
+            return vec_allocator(a);
+        }
+        else
+        {
+            return vec_allocator();
+        }
+    }
     // init an empty table, buckets has no elements when call init_empty
     void init_empty(size_type bucket_count)
     {
-        buckets.resize(bucket_count); // will set every value to 0/nullptr, it's important.
+        buckets = buckets_type(bucket_count, vec_alloc); // every value is nullptr, it's important.
     }
     // insert to set/map, do not insert if exist.
     std::pair<iterator, bool> insert_unique(link_type new_node)
@@ -297,7 +411,7 @@ private:
         }
     }
     // get key of value
-    static const key_type& key(const node* p)
+    static const key_type& key(const link_type& p)
     {
         static KeyOfValue get_key;
         return get_key(p->data);
@@ -310,7 +424,7 @@ public:
         : hash_func(hash)
         , k_equal(equal)
         , alloc(_alloc)
-        , vec_alloc(alloc)
+        , vec_alloc(bucket_allocator(alloc))
         , node_alloc(alloc)
         , elem_count(0)
         , buckets(vec_alloc)
@@ -325,7 +439,7 @@ public:
         : hash_func(hash)
         , k_equal(equal)
         , alloc(_alloc)
-        , vec_alloc(alloc)
+        , vec_alloc(bucket_allocator(alloc))
         , node_alloc(alloc)
         , elem_count(0)
         , buckets(vec_alloc)
@@ -342,7 +456,7 @@ public:
         : hash_func(other.hash_func)
         , k_equal(other.k_equal)
         , alloc(_alloc)
-        , vec_alloc(alloc)
+        , vec_alloc(bucket_allocator(alloc))
         , node_alloc(alloc)
         , elem_count(other.elem_count)
         , buckets(vec_alloc)
@@ -372,7 +486,7 @@ public:
         : hash_func(std::move(other.hash_func))
         , k_equal(std::move(other.k_equal))
         , alloc(_alloc)
-        , vec_alloc(alloc)
+        , vec_alloc(bucket_allocator(alloc))
         , node_alloc(alloc)
         , elem_count(0)
         , buckets(vec_alloc)
@@ -417,11 +531,12 @@ public:
     }
     hash_table& operator=(hash_table&& other) // 2
     {
+        clear();
         hash_func = std::move(other.hash_func);
         k_equal = std::move(other.k_equal);
         alloc = std::move(other.alloc);
         vec_alloc = std::move(other.vec_alloc);
-        node_alloc = std::move(node_alloc);
+        node_alloc = std::move(other.node_alloc);
         elem_count = other.elem_count;
         buckets = std::move(other.buckets);
         max_load_factor_value = other.max_load_factor_value;
@@ -612,7 +727,7 @@ public:
         size_type count = 0;
         size_type index = bucket(k);
         link_type tmp = buckets[index];
-        if (k_equal(k, key(tmp))) // at the begin of list
+        if (tmp && k_equal(k, key(tmp))) // at the begin of list
         {
             while (tmp && k_equal(k, key(tmp)))
             {
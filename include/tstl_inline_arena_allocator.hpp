@@ -0,0 +1,172 @@
+#ifndef TSTL_INLINE_ARENA_ALLOCATOR_HPP
+#define TSTL_INLINE_ARENA_ALLOCATOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <new>
+#include <cstddef>
+#include <functional>  // for std::less_equal
+#include <limits>
+#include <type_traits>
+
+namespace tstd
+{
+
+// Fixed buffer of N bytes inside the arena object itself, usually on the stack of a function.
+// Blocks are bumped from the buffer and rounded to Align bytes, a freed block is only reclaimed when it is the last one
+// (LIFO, which is the common pattern of short-lived local containers), other freed blocks are kept until reset.
+// When the buffer is exhausted, blocks are allocated like tstd::allocator.
+// The arena must outlive all containers using it, and it's not thread safe.
+template<std::size_t N, std::size_t Align = alignof(std::max_align_t)>
+class inline_arena
+{
+    static_assert(Align > 0 && (Align & (Align - 1)) == 0, "Align must be a power of 2");
+private:
+    alignas(Align) unsigned char buffer[N];
+    unsigned char* ptr;
+
+    static constexpr std::size_t align_up(std::size_t n) noexcept
+    {
+        return (n + (Align - 1)) & ~(Align - 1);
+    }
+public:
+    inline constexpr static std::size_t alignment = Align;
+
+    inline_arena() noexcept
+        : ptr(buffer)
+    {
+    }
+    inline_arena(const inline_arena&) = delete;
+    inline_arena& operator=(const inline_arena&) = delete;
+
+    // BlockAlign is the alignment of the block, which is also needed by deallocate
+    template<std::size_t BlockAlign>
+    void* allocate(std::size_t n)
+    {
+        static_assert(BlockAlign <= Align, "alignment of block exceeds alignment of arena");
+        std::size_t bytes = align_up(n);
+        if (bytes >= n && static_cast<std::size_t>(buffer + N - ptr) >= bytes)
+        {
+            unsigned char* result = ptr;
+            ptr += bytes;
+            return result;
+        }
+        return impl::_allocate_bytes(n, BlockAlign);
+    }
+    template<std::size_t BlockAlign>
+    void deallocate(void* p, std::size_t n) noexcept
+    {
+        if (owns(p))
+        {
+            unsigned char* q = static_cast<unsigned char*>(p);
+            if (q + align_up(n) == ptr)
+            {
+                ptr = q;
+            }
+        }
+        else
+        {
+            impl::_deallocate_bytes(p, BlockAlign);
+        }
+    }
+    // whether p is in the buffer
+    bool owns(const void* p) const noexcept
+    {
+        const unsigned char* q = static_cast<const unsigned char*>(p);
+        return std::less_equal<const unsigned char*>()(buffer, q) && std::less<const unsigned char*>()(q, buffer + N);
+    }
+    static constexpr std::size_t size() noexcept
+    {
+        return N;
+    }
+    // bytes of buffer used
+    std::size_t used() const noexcept
+    {
+        return static_cast<std::size_t>(ptr - buffer);
+    }
+    // reclaim the whole buffer, blocks in the buffer must not be used any more
+    void reset() noexcept
+    {
+        ptr = buffer;
+    }
+};
+
+// inline arena allocator (short_alloc): allocate from a tstd::inline_arena, fall back to heap on overflow.
+// e.g.
+//     tstd::inline_arena<1024> arena;
+//     tstd::vector<int, tstd::inline_arena_allocator<int, 1024>> vec(arena);
+//     vec.reserve(64); // growth leaves the old blocks behind in the arena, reserve once if the size is known
+// copies and rebound allocators refer to the same arena.
+template<typename T, std::size_t N, std::size_t Align = alignof(std::max_align_t)>
+class inline_arena_allocator
+{
+    template<typename U, std::size_t M, std::size_t A> friend class inline_arena_allocator;
+    static_assert(alignof(T) <= Align);
+public:
+    using arena_type = inline_arena<N, Align>;
+private:
+    arena_type* arena;
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    template<typename U> struct rebind {
+        using other = inline_arena_allocator<U, N, Align>;
+    };
+    using is_always_equal = std::false_type;
+
+    inline_arena_allocator(arena_type& a) noexcept
+        : arena(&a)
+    {
+    }
+    inline_arena_allocator(const inline_arena_allocator& other) noexcept = default;
+    template<typename U>
+    inline_arena_allocator(const inline_arena_allocator<U, N, Align>& other) noexcept
+        : arena(other.arena)
+    {
+    }
+    inline_arena_allocator& operator=(const inline_arena_allocator& other) noexcept = default;
+
+    [[nodiscard]] T* allocate(size_type n)
+    {
+        if (n > max_size())
+        {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena->template allocate<alignof(T)>(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_type n) noexcept
+    {
+        arena->template deallocate<alignof(T)>(p, n * sizeof(T));
+    }
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        impl::_construct(p, std::forward<Args>(args)...);
+    }
+    template<typename U>
+    void destroy(U* p)
+    {
+        impl::_destroy(p);
+    }
+    size_type max_size() const noexcept
+    {
+        return static_cast<size_type>(std::numeric_limits<size_t>::max() / sizeof(T));
+    }
+    arena_type& get_arena() const noexcept
+    {
+        return *arena;
+    }
+    template<typename U>
+    bool operator==(const inline_arena_allocator<U, N, Align>& other) const noexcept
+    {
+        return arena == other.arena;
+    }
+};
+
+} // namespace tstd
+
+#endif // TSTL_INLINE_ARENA_ALLOCATOR_HPP
@@ -0,0 +1,576 @@
+#ifndef TSTL_MAPPED_FILE_ALLOCATOR_HPP
+#define TSTL_MAPPED_FILE_ALLOCATOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <limits>
+#include <iterator>
+#include <compare>
+#include <memory>      // for std::pointer_traits
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace tstd
+{
+
+// Self-relative fancy pointer: stores the distance from itself to the pointee,
+// so a linked structure inside a memory block stays valid wherever the block is mapped.
+// Copies recompute the distance from their own address, so an offset_ptr must not be copied by memcpy.
+template<typename T>
+class offset_ptr
+{
+    template<typename U> friend class offset_ptr;
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using iterator_category = std::random_access_iterator_tag;
+    template<typename U>
+    using rebind = offset_ptr<U>;
+private:
+    // 1 is the null pointer: an object never points to its own second byte
+    std::ptrdiff_t off;
+    void set(const volatile void* p) noexcept
+    {
+        off = p ? static_cast<std::ptrdiff_t>(reinterpret_cast<std::uintptr_t>(p) - reinterpret_cast<std::uintptr_t>(this)) : 1;
+    }
+public:
+    offset_ptr() noexcept
+        : off(1)
+    {
+    }
+    offset_ptr(std::nullptr_t) noexcept
+        : off(1)
+    {
+    }
+    offset_ptr(T* p) noexcept
+    {
+        set(p);
+    }
+    offset_ptr(const offset_ptr& other) noexcept
+    {
+        set(other.get());
+    }
+    template<typename U>
+        requires (std::is_convertible_v<U*, T*> && !std::is_same_v<U, T>)
+    offset_ptr(const offset_ptr<U>& other) noexcept
+    {
+        set(static_cast<T*>(other.get()));
+    }
+    offset_ptr& operator=(const offset_ptr& other) noexcept
+    {
+        set(other.get());
+        return *this;
+    }
+    offset_ptr& operator=(T* p) noexcept
+    {
+        set(p);
+        return *this;
+    }
+    offset_ptr& operator=(std::nullptr_t) noexcept
+    {
+        off = 1;
+        return *this;
+    }
+    T* get() const noexcept
+    {
+        return off == 1 ? nullptr : reinterpret_cast<T*>(reinterpret_cast<std::uintptr_t>(this) + off);
+    }
+    template<typename U = T>
+        requires (!std::is_void_v<U>)
+    U& operator*() const noexcept
+    {
+        return *get();
+    }
+    T* operator->() const noexcept
+    {
+        return get();
+    }
+    template<typename U = T>
+        requires (!std::is_void_v<U>)
+    U& operator[](difference_type n) const noexcept
+    {
+        return get()[n];
+    }
+    explicit operator bool() const noexcept
+    {
+        return off != 1;
+    }
+    // pointer arithmetic over arrays allocated in one block
+    offset_ptr& operator+=(difference_type n) noexcept requires (!std::is_void_v<T>)
+    {
+        set(get() + n);
+        return *this;
+    }
+    offset_ptr& operator-=(difference_type n) noexcept requires (!std::is_void_v<T>)
+    {
+        set(get() - n);
+        return *this;
+    }
+    offset_ptr& operator++() noexcept requires (!std::is_void_v<T>)
+    {
+        return *this += 1;
+    }
+    offset_ptr& operator--() noexcept requires (!std::is_void_v<T>)
+    {
+        return *this -= 1;
+    }
+    offset_ptr operator++(int) noexcept requires (!std::is_void_v<T>)
+    {
+        offset_ptr tmp = *this;
+        *this += 1;
+        return tmp;
+    }
+    offset_ptr operator--(int) noexcept requires (!std::is_void_v<T>)
+    {
+        offset_ptr tmp = *this;
+        *this -= 1;
+        return tmp;
+    }
+    friend offset_ptr operator+(const offset_ptr& p, difference_type n) noexcept requires (!std::is_void_v<T>)
+    {
+        return offset_ptr(p.get() + n);
+    }
+    friend offset_ptr operator+(difference_type n, const offset_ptr& p) noexcept requires (!std::is_void_v<T>)
+    {
+        return offset_ptr(p.get() + n);
+    }
+    friend offset_ptr operator-(const offset_ptr& p, difference_type n) noexcept requires (!std::is_void_v<T>)
+    {
+        return offset_ptr(p.get() - n);
+    }
+    friend difference_type operator-(const offset_ptr& lhs, const offset_ptr& rhs) noexcept requires (!std::is_void_v<T>)
+    {
+        return lhs.get() - rhs.get();
+    }
+    bool operator==(const offset_ptr& other) const noexcept
+    {
+        return get() == other.get();
+    }
+    std::strong_ordering operator<=>(const offset_ptr& other) const noexcept
+    {
+        return std::compare_three_way()(get(), other.get());
+    }
+    bool operator==(std::nullptr_t) const noexcept
+    {
+        return off == 1;
+    }
+    template<typename U = T>
+        requires (!std::is_void_v<U>)
+    static offset_ptr pointer_to(U& r) noexcept
+    {
+        return offset_ptr(std::addressof(r));
+    }
+};
+
+namespace impl
+{
+
+// Header at the beginning of a mapped file, links of the header are offsets from its address (0 is null).
+// Blocks are 16 bytes aligned and carved from the unused tail of the file. Freed blocks up to 1024 bytes are kept in
+// free lists of their size, larger ones are kept in one list and reused by first fit, the rest of a split block
+// is freed again. The file is never grown: the mapping can't move while containers in it are in use.
+struct mapped_file_header
+{
+    inline constexpr static std::uint64_t magic_value = 0x314c4946504d5453; // "STMPFIL1"
+    inline constexpr static std::size_t alignment = 16;
+    inline constexpr static std::size_t small_limit = 1024;
+    inline constexpr static std::size_t max_objects = 16;
+    inline constexpr static std::size_t max_name_length = 31;
+
+    struct named_object
+    {
+        char name[max_name_length + 1];
+        std::uint64_t offset;
+    };
+    struct large_block
+    {
+        std::uint64_t next;
+        std::uint64_t size;
+    };
+
+    std::uint64_t magic;
+    std::uint64_t size;        // bytes of file
+    std::uint64_t top;         // begin of never used bytes
+    std::uint64_t used;        // bytes of allocated blocks
+    std::uint64_t small_free[small_limit / alignment];
+    std::uint64_t large_free;
+    named_object objects[max_objects];
+
+    static std::size_t round(std::size_t bytes) noexcept
+    {
+        return bytes == 0 ? alignment : (bytes + alignment - 1) & ~(alignment - 1);
+    }
+    void init(std::size_t file_size) noexcept
+    {
+        std::memset(static_cast<void*>(this), 0, sizeof(mapped_file_header));
+        magic = magic_value;
+        size = file_size;
+        top = round(sizeof(mapped_file_header));
+    }
+    void* at(std::uint64_t offset) noexcept
+    {
+        return reinterpret_cast<char*>(this) + offset;
+    }
+    std::uint64_t offset_of(const void* p) const noexcept
+    {
+        return static_cast<std::uint64_t>(static_cast<const char*>(p) - reinterpret_cast<const char*>(this));
+    }
+    void* allocate(std::size_t bytes)
+    {
+        bytes = round(bytes);
+        std::uint64_t offset = 0;
+        if (bytes <= small_limit)
+        {
+            std::uint64_t& head = small_free[bytes / alignment - 1];
+            if (head)
+            {
+                offset = head;
+                head = *static_cast<std::uint64_t*>(at(offset));
+            }
+        }
+        else
+        {
+            for (std::uint64_t* link = &large_free; *link; link = &static_cast<large_block*>(at(*link))->next)
+            {
+                large_block* block = static_cast<large_block*>(at(*link));
+                if (block->size >= bytes)
+                {
+                    offset = *link;
+                    *link = block->next;
+                    if (block->size > bytes)
+                    {
+                        release(offset + bytes, block->size - bytes);
+                    }
+                    break;
+                }
+            }
+        }
+        if (offset == 0)
+        {
+            if (size - top < bytes)
+            {
+                throw std::bad_alloc();
+            }
+            offset = top;
+            top += bytes;
+        }
+        used += bytes;
+        return at(offset);
+    }
+    void deallocate(void* p, std::size_t bytes) noexcept
+    {
+        bytes = round(bytes);
+        used -= bytes;
+        release(offset_of(p), bytes);
+    }
+    named_object* find(const char* name) noexcept
+    {
+        for (named_object& object : objects)
+        {
+            if (object.offset && std::strncmp(object.name, name, max_name_length + 1) == 0)
+            {
+                return &object;
+            }
+        }
+        return nullptr;
+    }
+    named_object* find_empty() noexcept
+    {
+        for (named_object& object : objects)
+        {
+            if (object.offset == 0)
+            {
+                return &object;
+            }
+        }
+        return nullptr;
+    }
+private:
+    void release(std::uint64_t offset, std::size_t bytes) noexcept
+    {
+        if (bytes <= small_limit)
+        {
+            std::uint64_t& head = small_free[bytes / alignment - 1];
+            *static_cast<std::uint64_t*>(at(offset)) = head;
+            head = offset;
+        }
+        else
+        {
+            large_block* block = static_cast<large_block*>(at(offset));
+            block->next = large_free;
+            block->size = bytes;
+            large_free = offset;
+        }
+    }
+};
+
+} // namespace impl
+
+template<typename T>
+class mapped_file_allocator;
+
+// A file mapped into memory by MAP_SHARED, in which containers using mapped_file_allocator could be built
+// and reopened by later processes without rebuilding. Objects in the file are found by name, e.g.
+//     tstd::mapped_file file("index.bin", 1 << 30);
+//     using Alloc = tstd::mapped_file_allocator<std::pair<const int, int>>;
+//     auto* index = file.find_or_construct<tstd::map<int, int, std::less<int>, Alloc>>("index", Alloc(file));
+// Everything stored in the file must be position independent: links are offset_ptr, and element types should not
+// own memory outside the file (plain keys and values, no std::string). Not thread safe, one writer at a time.
+class mapped_file
+{
+public:
+#if defined(__linux__)
+    inline constexpr static bool supported = true;
+#else
+    inline constexpr static bool supported = false;
+#endif
+private:
+    impl::mapped_file_header* header;
+    std::size_t bytes;
+    bool is_new;
+
+    [[noreturn]] static void throw_system_error(int error, const char* what)
+    {
+        throw std::system_error(error, std::generic_category(), what);
+    }
+    impl::mapped_file_header::named_object* checked_find(const char* name) const
+    {
+        if (std::strlen(name) > impl::mapped_file_header::max_name_length)
+        {
+            throw std::length_error("tstd::mapped_file: name too long");
+        }
+        return header->find(name);
+    }
+public:
+    // open the file at path, or create it with size bytes if it does not exist or is empty.
+    // a created file is sparse: only touched pages take disk blocks. an existing file keeps its size.
+    mapped_file(const char* path, std::size_t size)
+        : header(nullptr)
+        , bytes(0)
+        , is_new(false)
+    {
+#if defined(__linux__)
+        int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+        {
+            throw_system_error(errno, "tstd::mapped_file: open");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            int error = errno;
+            ::close(fd);
+            throw_system_error(error, "tstd::mapped_file: fstat");
+        }
+        is_new = st.st_size == 0;
+        bytes = is_new ? impl::mapped_file_header::round(size > sizeof(impl::mapped_file_header) ? size : sizeof(impl::mapped_file_header)) : static_cast<std::size_t>(st.st_size);
+        if (is_new && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+        {
+            int error = errno;
+            ::close(fd);
+            throw_system_error(error, "tstd::mapped_file: ftruncate");
+        }
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int error = errno;
+        ::close(fd); // the mapping keeps the file open
+        if (p == MAP_FAILED)
+        {
+            throw_system_error(error, "tstd::mapped_file: mmap");
+        }
+        header = static_cast<impl::mapped_file_header*>(p);
+        if (is_new)
+        {
+            header->init(bytes);
+        }
+        else if (bytes < sizeof(impl::mapped_file_header) || header->magic != impl::mapped_file_header::magic_value || header->size != bytes)
+        {
+            ::munmap(p, bytes);
+            throw std::runtime_error("tstd::mapped_file: not a file created by tstd::mapped_file");
+        }
+#else
+        throw std::system_error(std::make_error_code(std::errc::function_not_supported), "tstd::mapped_file");
+#endif
+    }
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    // objects in the file are not destroyed, they are kept for next open
+    ~mapped_file()
+    {
+#if defined(__linux__)
+        ::munmap(header, bytes);
+#endif
+    }
+    // whether the file is created by this open
+    bool created() const noexcept
+    {
+        return is_new;
+    }
+    std::size_t size() const noexcept
+    {
+        return bytes;
+    }
+    // bytes of allocated blocks
+    std::size_t used() const noexcept
+    {
+        return header->used;
+    }
+    // write dirty pages back to the file, the kernel does it anyway after unmapping
+    void flush()
+    {
+#if defined(__linux__)
+        if (::msync(header, bytes, MS_SYNC) != 0)
+        {
+            throw_system_error(errno, "tstd::mapped_file: msync");
+        }
+#endif
+    }
+    impl::mapped_file_header* get_header() const noexcept
+    {
+        return header;
+    }
+    template<typename T>
+    mapped_file_allocator<T> get_allocator() noexcept
+    {
+        return mapped_file_allocator<T>(*this);
+    }
+    // named objects, T must be the type which the object is constructed with
+    template<typename T>
+    T* find(const char* name) const
+    {
+        impl::mapped_file_header::named_object* object = checked_find(name);
+        return object ? static_cast<T*>(header->at(object->offset)) : nullptr;
+    }
+    template<typename T, typename... Args>
+    T* find_or_construct(const char* name, Args&&... args)
+    {
+        static_assert(alignof(T) <= impl::mapped_file_header::alignment);
+        if (impl::mapped_file_header::named_object* object = checked_find(name))
+        {
+            return static_cast<T*>(header->at(object->offset));
+        }
+        impl::mapped_file_header::named_object* object = header->find_empty();
+        if (!object)
+        {
+            throw std::bad_alloc(); // no more names
+        }
+        void* p = header->allocate(sizeof(T));
+        try
+        {
+            ::new(p) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            header->deallocate(p, sizeof(T));
+            throw;
+        }
+        std::strcpy(object->name, name);
+        object->offset = header->offset_of(p);
+        return static_cast<T*>(p);
+    }
+    // destroy object named name and free its memory, return false if not found
+    template<typename T>
+    bool destroy(const char* name)
+    {
+        impl::mapped_file_header::named_object* object = checked_find(name);
+        if (!object)
+        {
+            return false;
+        }
+        T* p = static_cast<T*>(header->at(object->offset));
+        object->offset = 0;
+        p->~T();
+        header->deallocate(p, sizeof(T));
+        return true;
+    }
+};
+
+// mapped file allocator: memory is allocated from a mapped_file and referred by offset_ptr,
+// so node-based containers (list, map/set, unordered containers) whose links are Allocator::pointer
+// could be constructed in the file (see mapped_file::find_or_construct) and reopened at any address.
+// It throws std::bad_alloc when the file is full.
+template<typename T>
+class mapped_file_allocator
+{
+    template<typename U> friend class mapped_file_allocator;
+    static_assert(alignof(T) <= impl::mapped_file_header::alignment);
+private:
+    offset_ptr<impl::mapped_file_header> file; // also in the file when the container is
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using pointer = offset_ptr<T>;
+    using const_pointer = offset_ptr<const T>;
+    using void_pointer = offset_ptr<void>;
+    using const_void_pointer = offset_ptr<const void>;
+    using reference = T&;
+    using const_reference = const T&;
+    template<typename U> struct rebind {
+        using other = mapped_file_allocator<U>;
+    };
+    using is_always_equal = std::false_type;
+
+    explicit mapped_file_allocator(mapped_file& f) noexcept
+        : file(f.get_header())
+    {
+    }
+    mapped_file_allocator(const mapped_file_allocator& other) noexcept = default;
+    template<typename U>
+    mapped_file_allocator(const mapped_file_allocator<U>& other) noexcept
+        : file(other.file)
+    {
+    }
+    mapped_file_allocator& operator=(const mapped_file_allocator& other) noexcept = default;
+
+    [[nodiscard]] pointer allocate(size_type n)
+    {
+        if (n > max_size())
+        {
+            throw std::bad_array_new_length();
+        }
+        return pointer(static_cast<T*>(file->allocate(n * sizeof(T))));
+    }
+    void deallocate(pointer p, size_type n)
+    {
+        file->deallocate(p.get(), n * sizeof(T));
+    }
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        impl::_construct(p, std::forward<Args>(args)...);
+    }
+    template<typename U>
+    void destroy(U* p)
+    {
+        impl::_destroy(p);
+    }
+    size_type max_size() const noexcept
+    {
+        return static_cast<size_type>(file->size / sizeof(T));
+    }
+    template<typename U>
+    bool operator==(const mapped_file_allocator<U>& other) const noexcept
+    {
+        return file == other.file;
+    }
+};
+
+} // namespace tstd
+
+#endif // TSTL_MAPPED_FILE_ALLOCATOR_HPP
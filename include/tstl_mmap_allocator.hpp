@@ -0,0 +1,199 @@
+#ifndef TSTL_MMAP_ALLOCATOR_HPP
+#define TSTL_MMAP_ALLOCATOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <new>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace tstd
+{
+
+namespace impl
+{
+
+// Large blocks are mapped by mmap directly and advised to be backed by transparent huge pages,
+// which reduces TLB misses of random access over huge vectors and hash bucket arrays.
+// mapped blocks could grow/shrink by mremap without copying (see try_reallocate).
+// On systems other than Linux every block is allocated by ::operator new.
+class mmap_alloc_base
+{
+public:
+#if defined(__linux__)
+    inline constexpr static bool mmap_supported = true;
+#else
+    inline constexpr static bool mmap_supported = false;
+#endif
+
+    static std::size_t page_size()
+    {
+#if defined(__linux__)
+        static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+#else
+        return 4096;
+#endif
+    }
+    static std::size_t round_to_page(std::size_t bytes)
+    {
+        std::size_t page = page_size();
+        return (bytes + page - 1) & ~(page - 1);
+    }
+    // map bytes, throw std::bad_alloc on failure
+    static void* map(std::size_t bytes)
+    {
+#if defined(__linux__)
+        void* p = ::mmap(nullptr, round_to_page(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+#if defined(MADV_HUGEPAGE)
+        ::madvise(p, round_to_page(bytes), MADV_HUGEPAGE); // only a hint, ignore failure
+#endif
+        return p;
+#else
+        return ::operator new(bytes);
+#endif
+    }
+    static void unmap(void* p, std::size_t bytes)
+    {
+#if defined(__linux__)
+        ::munmap(p, round_to_page(bytes));
+#else
+        ::operator delete(p);
+#endif
+    }
+    // resize a mapped block, content is kept and block may move, return nullptr on failure
+    static void* remap(void* p, std::size_t old_bytes, std::size_t new_bytes)
+    {
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+        void* q = ::mremap(p, round_to_page(old_bytes), round_to_page(new_bytes), MREMAP_MAYMOVE);
+        if (q == MAP_FAILED)
+        {
+            return nullptr;
+        }
+#if defined(MADV_HUGEPAGE)
+        ::madvise(q, round_to_page(new_bytes), MADV_HUGEPAGE);
+#endif
+        return q;
+#else
+        return nullptr;
+#endif
+    }
+};
+
+} // namespace impl
+
+// mmap allocator: blocks of at least Threshold bytes are mapped by mmap with huge page advice,
+// smaller ones are allocated like tstd::allocator.
+// It provides try_reallocate, tstd::vector use it to grow mapped storage in place by mremap.
+template<typename T, std::size_t Threshold = (std::size_t(1) << 20)>
+class mmap_allocator
+{
+private:
+    using base = impl::mmap_alloc_base;
+    // mapped blocks are page aligned
+    inline constexpr static bool use_mmap = base::mmap_supported && alignof(T) <= 4096;
+public:
+    inline constexpr static std::size_t threshold = Threshold;
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    template<typename U> struct rebind {
+        using other = mmap_allocator<U, Threshold>;
+    };
+    using is_always_equal = std::true_type;
+
+    constexpr mmap_allocator() noexcept = default;
+    constexpr mmap_allocator(const mmap_allocator& other) noexcept = default;
+    template<typename U>
+    constexpr mmap_allocator(const mmap_allocator<U, Threshold>& other) noexcept {}
+
+    // whether a block of n elements is mapped
+    static constexpr bool is_mapped(size_type n)
+    {
+        return use_mmap && n * sizeof(T) >= Threshold;
+    }
+
+    [[nodiscard]] T* allocate(size_type n)
+    {
+        if (n > max_size())
+        {
+            throw std::bad_array_new_length();
+        }
+        if (is_mapped(n))
+        {
+            return static_cast<T*>(base::map(n * sizeof(T)));
+        }
+        return impl::_allocate(static_cast<difference_type>(n), (T*)nullptr);
+    }
+    void deallocate(T* p, size_type n)
+    {
+        if (is_mapped(n))
+        {
+            base::unmap(p, n * sizeof(T));
+        }
+        else
+        {
+            impl::_deallocate(p);
+        }
+    }
+    // resize block p of old_n elements to new_n elements keeping its bytes, the block may move.
+    // only works when both old and new blocks are mapped, return nullptr if fails and p is untouched.
+    T* try_reallocate(T* p, size_type old_n, size_type new_n)
+    {
+        if (is_mapped(old_n) && is_mapped(new_n) && new_n <= max_size())
+        {
+            return static_cast<T*>(base::remap(p, old_n * sizeof(T), new_n * sizeof(T)));
+        }
+        return nullptr;
+    }
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        impl::_construct(p, std::forward<Args>(args)...);
+    }
+    template<typename U>
+    void destroy(U* p)
+    {
+        impl::_destroy(p);
+    }
+    size_type max_size() const noexcept
+    {
+        return static_cast<size_type>(std::numeric_limits<size_t>::max() / sizeof(T));
+    }
+    pointer address(reference x) const noexcept
+    {
+        return static_cast<pointer>(&x);
+    }
+    const_pointer address(const_reference x) const noexcept
+    {
+        return static_cast<const_pointer>(&x);
+    }
+};
+
+template<typename T1, typename T2, std::size_t Threshold>
+constexpr bool operator==(const mmap_allocator<T1, Threshold>& lhs, const mmap_allocator<T2, Threshold>& rhs) noexcept
+{
+    return true;
+}
+template<typename T1, typename T2, std::size_t Threshold>
+constexpr bool operator!=(const mmap_allocator<T1, Threshold>& lhs, const mmap_allocator<T2, Threshold>& rhs) noexcept
+{
+    return false;
+}
+
+} // namespace tstd
+
+#endif // TSTL_MMAP_ALLOCATOR_HPP
@@ -0,0 +1,251 @@
+#ifndef TSTL_POOL_ALLOCATOR_HPP
+#define TSTL_POOL_ALLOCATOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <new>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+namespace tstd
+{
+
+namespace impl
+{
+
+// SGI-style second level allocator (__default_alloc_template in SGI STL).
+// Small blocks (<= MaxBytes) are served from free lists, one list per size class (multiple of Align),
+// free lists are refilled from big chunks, memory of chunks is never returned to system.
+// Large blocks are forwarded to impl::_allocate/_deallocate.
+// Threads: guard free lists and chunk with a mutex or not.
+template<bool Threads>
+class pool_alloc_base
+{
+public:
+    inline constexpr static std::size_t Align = 8;
+    inline constexpr static std::size_t MaxBytes = 256;
+    inline constexpr static std::size_t FreeListCount = MaxBytes / Align;
+    inline constexpr static int RefillObjects = 20; // objects got from chunk for every refill
+private:
+    union obj
+    {
+        obj* next;
+    };
+    inline static obj* free_lists[FreeListCount] = {};
+    // the chunk that is not put into free lists yet
+    inline static char* start_free = nullptr;
+    inline static char* end_free = nullptr;
+    inline static std::size_t heap_size = 0; // total bytes got from system
+    inline static std::mutex lock;
+    // lock only if Threads
+    struct lock_guard
+    {
+        lock_guard()
+        {
+            if constexpr (Threads)
+            {
+                lock.lock();
+            }
+        }
+        ~lock_guard()
+        {
+            if constexpr (Threads)
+            {
+                lock.unlock();
+            }
+        }
+    };
+public:
+    static constexpr std::size_t round_up(std::size_t bytes)
+    {
+        return (bytes + Align - 1) & ~(Align - 1);
+    }
+    // index of free list, 0 bytes use the smallest class
+    static constexpr std::size_t free_list_index(std::size_t bytes)
+    {
+        return bytes == 0 ? 0 : (bytes + Align - 1) / Align - 1;
+    }
+    static void* allocate(std::size_t bytes)
+    {
+        if (bytes > MaxBytes)
+        {
+            return impl::_allocate(static_cast<ptrdiff_t>(bytes), (char*)nullptr);
+        }
+        lock_guard guard;
+        obj** my_free_list = free_lists + free_list_index(bytes);
+        obj* result = *my_free_list;
+        if (result == nullptr)
+        {
+            return refill(round_up(bytes == 0 ? 1 : bytes));
+        }
+        *my_free_list = result->next;
+        return result;
+    }
+    static void deallocate(void* p, std::size_t bytes)
+    {
+        if (bytes > MaxBytes)
+        {
+            impl::_deallocate(static_cast<char*>(p));
+            return;
+        }
+        lock_guard guard;
+        obj** my_free_list = free_lists + free_list_index(bytes);
+        obj* q = static_cast<obj*>(p);
+        q->next = *my_free_list;
+        *my_free_list = q;
+    }
+private:
+    // return an object of size bytes, and add other objects got from chunk to free list, bytes is aligned
+    static void* refill(std::size_t bytes)
+    {
+        int nobjs = RefillObjects;
+        char* chunk = chunk_alloc(bytes, nobjs);
+        if (nobjs == 1)
+        {
+            return chunk;
+        }
+        obj** my_free_list = free_lists + free_list_index(bytes);
+        obj* result = reinterpret_cast<obj*>(chunk);
+        obj* next_obj = reinterpret_cast<obj*>(chunk + bytes);
+        *my_free_list = next_obj;
+        for (int i = 1; ; ++i)
+        {
+            obj* cur_obj = next_obj;
+            next_obj = reinterpret_cast<obj*>(reinterpret_cast<char*>(next_obj) + bytes);
+            if (i == nobjs - 1)
+            {
+                cur_obj->next = nullptr;
+                break;
+            }
+            cur_obj->next = next_obj;
+        }
+        return result;
+    }
+    // get nobjs objects of size bytes from chunk, nobjs may be reduced if memory is insufficient
+    static char* chunk_alloc(std::size_t bytes, int& nobjs)
+    {
+        std::size_t total_bytes = bytes * nobjs;
+        std::size_t bytes_left = end_free - start_free;
+        if (bytes_left >= total_bytes) // enough for all
+        {
+            char* result = start_free;
+            start_free += total_bytes;
+            return result;
+        }
+        else if (bytes_left >= bytes) // enough for at least one
+        {
+            nobjs = static_cast<int>(bytes_left / bytes);
+            total_bytes = bytes * nobjs;
+            char* result = start_free;
+            start_free += total_bytes;
+            return result;
+        }
+        else // not enough for one, get a new chunk
+        {
+            // put the rest of chunk into free list, rest size must be multiple of Align
+            if (bytes_left > 0)
+            {
+                obj** my_free_list = free_lists + free_list_index(bytes_left);
+                reinterpret_cast<obj*>(start_free)->next = *my_free_list;
+                *my_free_list = reinterpret_cast<obj*>(start_free);
+            }
+            std::size_t bytes_to_get = 2 * total_bytes + round_up(heap_size >> 4);
+            start_free = impl::_allocate(static_cast<ptrdiff_t>(bytes_to_get), (char*)nullptr);
+            heap_size += bytes_to_get;
+            end_free = start_free + bytes_to_get;
+            return chunk_alloc(bytes, nobjs);
+        }
+    }
+};
+
+} // namespace impl
+
+// pool allocator: allocate small objects from free lists, fit for node-based containers.
+// blocks of over-aligned types or larger than MaxBytes are allocated like tstd::allocator.
+template<typename T, bool ThreadSafe = true>
+class pool_allocator
+{
+private:
+    using base = impl::pool_alloc_base<ThreadSafe>;
+    inline constexpr static bool use_pool = alignof(T) <= base::Align;
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    template<typename U> struct rebind {
+        using other = pool_allocator<U, ThreadSafe>;
+    };
+    using is_always_equal = std::true_type;
+
+    constexpr pool_allocator() noexcept = default;
+    constexpr pool_allocator(const pool_allocator& other) noexcept = default;
+    template<typename U>
+    constexpr pool_allocator(const pool_allocator<U, ThreadSafe>& other) noexcept {}
+
+    [[nodiscard]] T* allocate(size_type n)
+    {
+        if constexpr (use_pool)
+        {
+            return static_cast<T*>(base::allocate(n * sizeof(T)));
+        }
+        else
+        {
+            return impl::_allocate(static_cast<difference_type>(n), (T*)nullptr);
+        }
+    }
+    void deallocate(T* p, size_type n)
+    {
+        if constexpr (use_pool)
+        {
+            base::deallocate(p, n * sizeof(T));
+        }
+        else
+        {
+            impl::_deallocate(p);
+        }
+    }
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        impl::_construct(p, std::forward<Args>(args)...);
+    }
+    template<typename U>
+    void destroy(U* p)
+    {
+        impl::_destroy(p);
+    }
+    size_type max_size() const noexcept
+    {
+        return static_cast<size_type>(std::numeric_limits<size_t>::max() / sizeof(T));
+    }
+    pointer address(reference x) const noexcept
+    {
+        return static_cast<pointer>(&x);
+    }
+    const_pointer address(const_reference x) const noexcept
+    {
+        return static_cast<const_pointer>(&x);
+    }
+};
+
+// all pool allocators of same thread policy share the same pool
+template<typename T1, typename T2, bool ThreadSafe>
+constexpr bool operator==(const pool_allocator<T1, ThreadSafe>& lhs, const pool_allocator<T2, ThreadSafe>& rhs) noexcept
+{
+    return true;
+}
+template<typename T1, typename T2, bool ThreadSafe>
+constexpr bool operator!=(const pool_allocator<T1, ThreadSafe>& lhs, const pool_allocator<T2, ThreadSafe>& rhs) noexcept
+{
+    return false;
+}
+
+} // namespace tstd
+
+#endif // TSTL_POOL_ALLOCATOR_HPP
@@ -39,6 +39,9 @@ implementation detail: Let a Nil node that painted to black be root's parent and
 */
 private:
     enum NodeColor : unsigned char{ RED, BLACK };
+    struct RbTreeNode;
+    // links are Allocator::pointer rebound to node, could be fancy pointers (e.g. 32-bit slab_ptr of slab_allocator)
+    using link_type = typename std::pointer_traits<typename std::allocator_traits<Allocator>::pointer>::template rebind<RbTreeNode>;
     struct RbTreeNode
     {
         RbTreeNode(const Value& _data) : data(_data)
@@ -51,9 +54,9 @@ private:
         RbTreeNode(Args&&... args) : data(std::forward<Args>(args)...)
         {
         }
-        RbTreeNode* left = nullptr;
-        RbTreeNode* right = nullptr;
-        RbTreeNode* parent = nullptr;
+        link_type left = nullptr;
+        link_type right = nullptr;
+        link_type parent = nullptr;
         Value data;
         NodeColor color = RED;
     };
@@ -65,7 +68,7 @@ private:
     private:
         using iterator = RbTreeIterator<IterValue, IterValue&, IterValue*, std::remove_const_t<TreeType>>;
     public:
-        RbTreeIterator(TreeType* _tree = nullptr, RbTreeNode* _node = nullptr) : tree(_tree), node(_node)
+        RbTreeIterator(TreeType* _tree = nullptr, link_type _node = nullptr) : tree(_tree), node(_node)
         {
         }
         RbTreeIterator(const iterator& other) : tree(other.tree), node(other.node)
@@ -119,11 +122,10 @@ private:
         using pointer = IterPtr;
     private:
         TreeType* tree;
-        RbTreeNode* node;
+        link_type node;
     };
 private:
     using rb_tree_node_allocator = typename Allocator::template rebind<RbTreeNode>::other;
-    using link_type = RbTreeNode*;
 public:
     using key_type = Key;
     using value_type = Value;
@@ -313,7 +315,7 @@ private:
         m_nodeCount = other.m_nodeCount;
     }
     // search
-    RbTreeNode* search(RbTreeNode* node, const Key& val) const
+    link_type search(link_type node, const Key& val) const
     {
         while (node != Nil)
         {
@@ -337,9 +339,9 @@ private:
     //  node  to   y
     //   \        /
     //    y      node
-    void leftRotate(RbTreeNode* node)
+    void leftRotate(link_type node)
     {
-        RbTreeNode* y = node->right;
+        link_type y = node->right;
         node->right = y->left;
         if (y->left != Nil)
         {
@@ -365,9 +367,9 @@ private:
     //  node  to  y
     //  /          \_
     // y           node
-    void rightRotate(RbTreeNode* node)
+    void rightRotate(link_type node)
     {
-        RbTreeNode* y = node->left;
+        link_type y = node->left;
         node->left = y->right;
         if (y->right != Nil)
         {
@@ -439,13 +441,13 @@ private:
         return { newNode, true };
     }
     // fix up the attributes of Red-Black tree after inserting: make sure node is not nullptr or Nil
-    void insertFixUp(RbTreeNode* node)
+    void insertFixUp(link_type node)
     {
         while (node->parent->color == RED) // root is always black, so node->parent is not root and has a parent for sure.
         {
             if (node->parent == node->parent->parent->left)
             {
-                RbTreeNode* uncle = node->parent->parent->right; // node's uncle
+                link_type uncle = node->parent->parent->right; // node's uncle
                 if (uncle->color == RED) // case 1: node's uncle is red
                 {
                     // paint it's parent and uncle to black, paint it's grandparent to red, then go up to it's grandfather
@@ -470,7 +472,7 @@ private:
             }
             else // just change the direction
             {
-                RbTreeNode* uncle = node->parent->parent->left;
+                link_type uncle = node->parent->parent->left;
                 if (uncle->color == RED) // case 1
                 {
                     node->parent->color = BLACK;
@@ -494,7 +496,7 @@ private:
         m_root->color = BLACK;
     }
     // auxiliary function: replace node with newNode, make sure node is not Nil or nullptr
-    void transplant(RbTreeNode* node, RbTreeNode* newNode)
+    void transplant(link_type node, link_type newNode)
     {
         if (node->parent == Nil) // node is root
         {
@@ -511,11 +513,11 @@ private:
         newNode->parent = node->parent; // set parent even if newNode is Nil. (this is a key point !!!)
     }
     // remove specified node: make sure node is not Nil or nullptr
-    RbTreeNode* removeNode(RbTreeNode* node)
+    link_type removeNode(link_type node)
     {
-        RbTreeNode* ret = successor(node);
-        RbTreeNode* y = node;
-        RbTreeNode* x = Nil;
+        link_type ret = successor(node);
+        link_type y = node;
+        link_type x = Nil;
         NodeColor yOriginalColor = y->color;
         if (node->left == Nil) // node has no left child, (include the case of no child)
         {
@@ -561,7 +563,7 @@ private:
         return ret;
     }
     // fix up the attributes of Red-Black tree after inserting: make sure node is not nullptr or Nil
-    void removeFixUp(RbTreeNode* node)
+    void removeFixUp(link_type node)
     {
         // attribute 2, 4, 5 could be broken
         while (node != m_root && node->color == BLACK)
@@ -570,7 +572,7 @@ private:
             {
                 // w is node's sibling
                 // and w is not Nil for sure, because the path from w to Nil(exclude Nil itself) definitely has at least one black node.
-                RbTreeNode* w = node->parent->right;
+                link_type w = node->parent->right;
                 if (w->color == RED) // case 1
                 {
                     // case 1: w is red, so w has two black non-Nil children for sure.
@@ -608,7 +610,7 @@ private:
             }
             else // node is right child of its parent
             {
-                RbTreeNode* w = node->parent->left;
+                link_type w = node->parent->left;
                 if (w->color == RED) // case 1
                 {
                     w->color = BLACK;
@@ -997,12 +999,12 @@ constexpr int _cmp_rb_tree(const tstd::impl::rb_tree<Key, Value, KeyOfValue, Mul
 template<typename Key, typename Value, typename KeyOfValue, bool Multi, typename Compare, typename Allocator>
 constexpr bool operator==(const tstd::impl::rb_tree<Key, Value, KeyOfValue, Multi, Compare, Allocator>& lhs, const tstd::impl::rb_tree<Key, Value, KeyOfValue, Multi, Compare, Allocator>& rhs)
 {
-    return _cmp_rb_tree(lhs, rhs) == 0;
+    return lhs.size() == rhs.size() && _cmp_rb_tree(lhs, rhs) == 0;
 }
 template<typename Key, typename Value, typename KeyOfValue, bool Multi, typename Compare, typename Allocator>
 constexpr bool operator!=(const tstd::impl::rb_tree<Key, Value, KeyOfValue, Multi, Compare, Allocator>& lhs, const tstd::impl::rb_tree<Key, Value, KeyOfValue, Multi, Compare, Allocator>& rhs)
 {
-    return _cmp_rb_tree(lhs, rhs) != 0;
+    return !(lhs == rhs);
 }
 template<typename Key, typename Value, typename KeyOfValue, bool Multi, typename Compare, typename Allocator>
 constexpr bool operator<(const tstd::impl::rb_tree<Key, Value, KeyOfValue, Multi, Compare, Allocator>& lhs, const tstd::impl::rb_tree<Key, Value, KeyOfValue, Multi, Compare, Allocator>& rhs)
@@ -0,0 +1,1047 @@
+#ifndef TSTL_SHARED_PTR_HPP
+#define TSTL_SHARED_PTR_HPP
+
+#include <tstl_allocator.hpp>
+#include <tstl_unique_ptr.hpp>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <memory>     // for std::allocator_traits
+#include <atomic>
+#include <typeinfo>
+#include <exception>
+#include <functional> // for std::hash std::less
+#include <ostream>
+
+namespace tstd
+{
+
+// exception thrown when constructing shared_ptr from an expired weak_ptr
+class bad_weak_ptr : public std::exception
+{
+public:
+    const char* what() const noexcept override
+    {
+        return "tstd::bad_weak_ptr";
+    }
+};
+
+namespace impl
+{
+
+// control block of shared_ptr (Atomic = true) and local_shared_ptr (Atomic = false).
+// The reference counts of local_shared_ptr are plain integers, copying and destroying it cost no atomic
+// read-modify-write, but a local_shared_ptr and its copies must be used by only one thread at a time.
+template<bool Atomic>
+class sp_counted_base
+{
+private:
+    using counter_type = std::conditional_t<Atomic, std::atomic<long>, long>;
+    counter_type uses;  // number of shared owners
+    counter_type weaks; // number of weak owners, plus 1 while uses > 0
+public:
+    sp_counted_base() noexcept
+        : uses(1)
+        , weaks(1)
+    {
+    }
+    sp_counted_base(const sp_counted_base&) = delete;
+    sp_counted_base& operator=(const sp_counted_base&) = delete;
+    virtual ~sp_counted_base() = default;
+    // destroy the managed object
+    virtual void dispose() noexcept = 0;
+    // free the control block itself
+    virtual void destroy() noexcept = 0;
+    virtual void* get_deleter([[maybe_unused]] const std::type_info& ti) noexcept
+    {
+        return nullptr;
+    }
+    void add_ref() noexcept
+    {
+        if constexpr (Atomic)
+        {
+            uses.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            ++uses;
+        }
+    }
+    // add a shared owner only if there is still one, for weak_ptr::lock
+    bool add_ref_lock() noexcept
+    {
+        if constexpr (Atomic)
+        {
+            long count = uses.load(std::memory_order_relaxed);
+            while (count != 0)
+            {
+                if (uses.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        else
+        {
+            if (uses == 0)
+            {
+                return false;
+            }
+            ++uses;
+            return true;
+        }
+    }
+    void release() noexcept
+    {
+        if (decrease(uses) == 0)
+        {
+            dispose();
+            weak_release();
+        }
+    }
+    void weak_add_ref() noexcept
+    {
+        if constexpr (Atomic)
+        {
+            weaks.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            ++weaks;
+        }
+    }
+    void weak_release() noexcept
+    {
+        if (decrease(weaks) == 0)
+        {
+            destroy();
+        }
+    }
+    long use_count() const noexcept
+    {
+        if constexpr (Atomic)
+        {
+            return uses.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            return uses;
+        }
+    }
+private:
+    // return the decreased count, acquire-release makes all uses of the object happen before its destruction
+    static long decrease(counter_type& count) noexcept
+    {
+        if constexpr (Atomic)
+        {
+            return count.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        }
+        else
+        {
+            return --count;
+        }
+    }
+};
+
+// control block owning a pointer with a deleter, allocated by Allocator
+template<typename Pointer, typename Deleter, typename Allocator, bool Atomic>
+class sp_counted_deleter final : public sp_counted_base<Atomic>
+{
+private:
+    using block_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<sp_counted_deleter>;
+    using block_traits = std::allocator_traits<block_allocator>;
+    Pointer ptr;
+    [[no_unique_address]] Deleter deleter;
+    [[no_unique_address]] block_allocator alloc;
+public:
+    sp_counted_deleter(Pointer p, Deleter&& d, const block_allocator& a) noexcept
+        : ptr(p)
+        , deleter(std::move(d))
+        , alloc(a)
+    {
+    }
+    void dispose() noexcept override
+    {
+        deleter(ptr);
+    }
+    void destroy() noexcept override
+    {
+        block_allocator a(alloc);
+        this->~sp_counted_deleter();
+        block_traits::deallocate(a, this, 1);
+    }
+    void* get_deleter(const std::type_info& ti) noexcept override
+    {
+        return ti == typeid(Deleter) ? static_cast<void*>(std::addressof(deleter)) : nullptr;
+    }
+    // deleter is called on p if allocation fails
+    static sp_counted_deleter* create(Pointer p, Deleter d, const Allocator& a)
+    {
+        block_allocator ba(a);
+        sp_counted_deleter* block = nullptr;
+        try
+        {
+            block = block_traits::allocate(ba, 1);
+        }
+        catch (...)
+        {
+            d(p);
+            throw;
+        }
+        ::new (static_cast<void*>(block)) sp_counted_deleter(p, std::move(d), ba);
+        return block;
+    }
+};
+
+// tag for default initialization of the object in make_shared_for_overwrite
+struct sp_for_overwrite_tag
+{
+};
+
+// control block with the object inside, make_shared/allocate_shared need only one allocation
+template<typename T, typename Allocator, bool Atomic>
+class sp_counted_inplace final : public sp_counted_base<Atomic>
+{
+private:
+    using value_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using value_traits = std::allocator_traits<value_allocator>;
+    using block_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<sp_counted_inplace>;
+    using block_traits = std::allocator_traits<block_allocator>;
+    [[no_unique_address]] value_allocator alloc;
+    union
+    {
+        T obj; // constructed and destroyed explicitly
+    };
+public:
+    template<typename... Args>
+    sp_counted_inplace(const Allocator& a, Args&&... args)
+        : alloc(a)
+    {
+        value_traits::construct(alloc, ptr(), std::forward<Args>(args)...);
+    }
+    sp_counted_inplace(const Allocator& a, sp_for_overwrite_tag)
+        : alloc(a)
+    {
+        ::new (static_cast<void*>(ptr())) T;
+    }
+    ~sp_counted_inplace()
+    {
+    }
+    T* ptr() noexcept
+    {
+        return std::addressof(obj);
+    }
+    void dispose() noexcept override
+    {
+        value_traits::destroy(alloc, ptr());
+    }
+    void destroy() noexcept override
+    {
+        block_allocator a(alloc);
+        this->~sp_counted_inplace();
+        block_traits::deallocate(a, this, 1);
+    }
+    template<typename... Args>
+    static sp_counted_inplace* create(const Allocator& a, Args&&... args)
+    {
+        block_allocator ba(a);
+        sp_counted_inplace* block = block_traits::allocate(ba, 1);
+        try
+        {
+            ::new (static_cast<void*>(block)) sp_counted_inplace(a, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            block_traits::deallocate(ba, block, 1);
+            throw;
+        }
+        return block;
+    }
+};
+
+// whether a pointer Y* could be owned by shared_ptr<T>
+template<typename Y, typename T>
+inline constexpr bool sp_acceptable_pointer_v = std::is_array_v<T>
+    ? std::is_convertible_v<Y(*)[], T*>
+    : std::is_convertible_v<Y*, T*>;
+
+// whether shared_ptr<Y> is convertible to shared_ptr<T>
+template<typename Y, typename T>
+inline constexpr bool sp_compatible_v = std::is_convertible_v<Y*, T*>;
+
+template<typename T, bool Atomic> class basic_weak_ptr;
+template<typename T, bool Atomic> class basic_enable_shared_from_this;
+
+// shared_ptr (Atomic = true) and local_shared_ptr (Atomic = false)
+template<typename T, bool Atomic>
+class basic_shared_ptr
+{
+    template<typename U, bool A> friend class basic_shared_ptr;
+    template<typename U, bool A> friend class basic_weak_ptr;
+    template<typename U, typename Allocator, bool A, typename... Args>
+    friend basic_shared_ptr<U, A> _allocate_shared(const Allocator& alloc, Args&&... args);
+    template<typename D, typename U, bool A>
+    friend D* _get_deleter(const basic_shared_ptr<U, A>& p) noexcept;
+public:
+    using element_type = std::remove_extent_t<T>;
+    using weak_type = basic_weak_ptr<T, Atomic>;
+private:
+    using control_block = sp_counted_base<Atomic>;
+    element_type* ptr;
+    control_block* ctrl;
+public:
+    // constructors
+    // 1
+    constexpr basic_shared_ptr() noexcept
+        : ptr(nullptr)
+        , ctrl(nullptr)
+    {
+    }
+    constexpr basic_shared_ptr(std::nullptr_t) noexcept
+        : basic_shared_ptr()
+    {
+    }
+    // 3
+    template<typename Y>
+        requires sp_acceptable_pointer_v<Y, T>
+    explicit basic_shared_ptr(Y* p)
+        : basic_shared_ptr(p, std::conditional_t<std::is_array_v<T>, tstd::default_delete<Y[]>, tstd::default_delete<Y>>())
+    {
+    }
+    // 4, 5
+    template<typename Y, typename Deleter>
+        requires sp_acceptable_pointer_v<Y, T>
+    basic_shared_ptr(Y* p, Deleter d)
+        : basic_shared_ptr(p, std::move(d), tstd::allocator<char>())
+    {
+    }
+    template<typename Deleter>
+    basic_shared_ptr(std::nullptr_t p, Deleter d)
+        : basic_shared_ptr(p, std::move(d), tstd::allocator<char>())
+    {
+    }
+    // 6, 7
+    template<typename Y, typename Deleter, typename Allocator>
+        requires sp_acceptable_pointer_v<Y, T>
+    basic_shared_ptr(Y* p, Deleter d, const Allocator& alloc)
+        : ptr(p)
+        , ctrl(sp_counted_deleter<Y*, Deleter, Allocator, Atomic>::create(p, std::move(d), alloc))
+    {
+        enable_shared_from_this_with(p);
+    }
+    template<typename Deleter, typename Allocator>
+    basic_shared_ptr(std::nullptr_t p, Deleter d, const Allocator& alloc)
+        : ptr(nullptr)
+        , ctrl(sp_counted_deleter<std::nullptr_t, Deleter, Allocator, Atomic>::create(p, std::move(d), alloc))
+    {
+    }
+    // 8: aliasing constructor, share ownership with r but point to p
+    template<typename Y>
+    basic_shared_ptr(const basic_shared_ptr<Y, Atomic>& r, element_type* p) noexcept
+        : ptr(p)
+        , ctrl(r.ctrl)
+    {
+        if (ctrl)
+        {
+            ctrl->add_ref();
+        }
+    }
+    template<typename Y>
+    basic_shared_ptr(basic_shared_ptr<Y, Atomic>&& r, element_type* p) noexcept
+        : ptr(p)
+        , ctrl(r.ctrl)
+    {
+        r.ptr = nullptr;
+        r.ctrl = nullptr;
+    }
+    // 9
+    basic_shared_ptr(const basic_shared_ptr& r) noexcept
+        : ptr(r.ptr)
+        , ctrl(r.ctrl)
+    {
+        if (ctrl)
+        {
+            ctrl->add_ref();
+        }
+    }
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    basic_shared_ptr(const basic_shared_ptr<Y, Atomic>& r) noexcept
+        : ptr(r.ptr)
+        , ctrl(r.ctrl)
+    {
+        if (ctrl)
+        {
+            ctrl->add_ref();
+        }
+    }
+    // 10
+    basic_shared_ptr(basic_shared_ptr&& r) noexcept
+        : ptr(r.ptr)
+        , ctrl(r.ctrl)
+    {
+        r.ptr = nullptr;
+        r.ctrl = nullptr;
+    }
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    basic_shared_ptr(basic_shared_ptr<Y, Atomic>&& r) noexcept
+        : ptr(r.ptr)
+        , ctrl(r.ctrl)
+    {
+        r.ptr = nullptr;
+        r.ctrl = nullptr;
+    }
+    // 11
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    explicit basic_shared_ptr(const basic_weak_ptr<Y, Atomic>& r)
+        : ptr(r.ptr)
+        , ctrl(r.ctrl)
+    {
+        if (!ctrl || !ctrl->add_ref_lock())
+        {
+            throw tstd::bad_weak_ptr();
+        }
+    }
+    // 13
+    template<typename Y, typename Deleter>
+        requires std::is_convertible_v<typename tstd::unique_ptr<Y, Deleter>::pointer, element_type*>
+    basic_shared_ptr(tstd::unique_ptr<Y, Deleter>&& r)
+        : ptr(nullptr)
+        , ctrl(nullptr)
+    {
+        if (r)
+        {
+            using Pointer = typename tstd::unique_ptr<Y, Deleter>::pointer;
+            using StoredDeleter = std::conditional_t<std::is_reference_v<Deleter>,
+                decltype(std::ref(r.get_deleter())), Deleter>;
+            Pointer p = r.get();
+            ctrl = sp_counted_deleter<Pointer, StoredDeleter, tstd::allocator<char>, Atomic>::create(p,
+                static_cast<StoredDeleter>(std::forward<Deleter>(r.get_deleter())), tstd::allocator<char>());
+            ptr = p;
+            r.release();
+            enable_shared_from_this_with(p);
+        }
+    }
+    // destructor
+    ~basic_shared_ptr()
+    {
+        if (ctrl)
+        {
+            ctrl->release();
+        }
+    }
+    // assignment
+    basic_shared_ptr& operator=(const basic_shared_ptr& r) noexcept
+    {
+        assign(r.ptr, r.ctrl);
+        return *this;
+    }
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    basic_shared_ptr& operator=(const basic_shared_ptr<Y, Atomic>& r) noexcept
+    {
+        assign(r.ptr, r.ctrl);
+        return *this;
+    }
+    basic_shared_ptr& operator=(basic_shared_ptr&& r) noexcept
+    {
+        basic_shared_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    basic_shared_ptr& operator=(basic_shared_ptr<Y, Atomic>&& r) noexcept
+    {
+        basic_shared_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+    template<typename Y, typename Deleter>
+    basic_shared_ptr& operator=(tstd::unique_ptr<Y, Deleter>&& r)
+    {
+        basic_shared_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+    // modifiers
+    void reset() noexcept
+    {
+        basic_shared_ptr().swap(*this);
+    }
+    template<typename Y>
+    void reset(Y* p)
+    {
+        basic_shared_ptr(p).swap(*this);
+    }
+    template<typename Y, typename Deleter>
+    void reset(Y* p, Deleter d)
+    {
+        basic_shared_ptr(p, std::move(d)).swap(*this);
+    }
+    template<typename Y, typename Deleter, typename Allocator>
+    void reset(Y* p, Deleter d, const Allocator& alloc)
+    {
+        basic_shared_ptr(p, std::move(d), alloc).swap(*this);
+    }
+    void swap(basic_shared_ptr& r) noexcept
+    {
+        std::swap(ptr, r.ptr);
+        std::swap(ctrl, r.ctrl);
+    }
+    // observers
+    element_type* get() const noexcept
+    {
+        return ptr;
+    }
+    template<typename U = T>
+        requires (!std::is_array_v<U> && !std::is_void_v<U>)
+    U& operator*() const noexcept
+    {
+        return *ptr;
+    }
+    template<typename U = T>
+        requires (!std::is_array_v<U>)
+    U* operator->() const noexcept
+    {
+        return ptr;
+    }
+    template<typename U = T>
+        requires std::is_array_v<U>
+    element_type& operator[](std::ptrdiff_t idx) const
+    {
+        return ptr[idx];
+    }
+    long use_count() const noexcept
+    {
+        return ctrl ? ctrl->use_count() : 0;
+    }
+    explicit operator bool() const noexcept
+    {
+        return ptr != nullptr;
+    }
+    template<typename Y>
+    bool owner_before(const basic_shared_ptr<Y, Atomic>& other) const noexcept
+    {
+        return std::less<control_block*>()(ctrl, other.ctrl);
+    }
+    template<typename Y>
+    bool owner_before(const basic_weak_ptr<Y, Atomic>& other) const noexcept
+    {
+        return std::less<control_block*>()(ctrl, other.ctrl);
+    }
+private:
+    // share the ownership of _ctrl, counts are untouched if it is already shared
+    void assign(element_type* p, control_block* _ctrl) noexcept
+    {
+        if (ctrl != _ctrl)
+        {
+            if (_ctrl)
+            {
+                _ctrl->add_ref();
+            }
+            if (ctrl)
+            {
+                ctrl->release();
+            }
+            ctrl = _ctrl;
+        }
+        ptr = p;
+    }
+    // take over a newly created control block
+    basic_shared_ptr(control_block* _ctrl, element_type* p) noexcept
+        : ptr(p)
+        , ctrl(_ctrl)
+    {
+    }
+    // set the weak_this of enable_shared_from_this base of the newly owned object
+    template<typename Y>
+    void enable_shared_from_this_with(Y* p) noexcept
+    {
+        if constexpr (requires(Y* q) { _enable_shared_from_this_base(q, std::bool_constant<Atomic>()); })
+        {
+            if (auto base = _enable_shared_from_this_base(p, std::bool_constant<Atomic>()))
+            {
+                base->weak_this.assign_if_expired(const_cast<std::remove_cv_t<Y>*>(p), ctrl);
+            }
+        }
+    }
+};
+
+// weak_ptr (Atomic = true) and local_weak_ptr (Atomic = false)
+template<typename T, bool Atomic>
+class basic_weak_ptr
+{
+    template<typename U, bool A> friend class basic_shared_ptr;
+    template<typename U, bool A> friend class basic_weak_ptr;
+    template<typename U, bool A> friend class basic_enable_shared_from_this;
+public:
+    using element_type = std::remove_extent_t<T>;
+private:
+    using control_block = sp_counted_base<Atomic>;
+    element_type* ptr;
+    control_block* ctrl;
+public:
+    // constructors
+    constexpr basic_weak_ptr() noexcept
+        : ptr(nullptr)
+        , ctrl(nullptr)
+    {
+    }
+    basic_weak_ptr(const basic_weak_ptr& r) noexcept
+        : ptr(r.ptr)
+        , ctrl(r.ctrl)
+    {
+        if (ctrl)
+        {
+            ctrl->weak_add_ref();
+        }
+    }
+    // the object may be expired, converting the pointer to a virtual base would read it, so lock first
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    basic_weak_ptr(const basic_weak_ptr<Y, Atomic>& r) noexcept
+        : ptr(r.lock().get())
+        , ctrl(r.ctrl)
+    {
+        if (ctrl)
+        {
+            ctrl->weak_add_ref();
+        }
+    }
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    basic_weak_ptr(const basic_shared_ptr<Y, Atomic>& r) noexcept
+        : ptr(r.ptr)
+        , ctrl(r.ctrl)
+    {
+        if (ctrl)
+        {
+            ctrl->weak_add_ref();
+        }
+    }
+    basic_weak_ptr(basic_weak_ptr&& r) noexcept
+        : ptr(r.ptr)
+        , ctrl(r.ctrl)
+    {
+        r.ptr = nullptr;
+        r.ctrl = nullptr;
+    }
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    basic_weak_ptr(basic_weak_ptr<Y, Atomic>&& r) noexcept
+        : ptr(r.lock().get())
+        , ctrl(r.ctrl)
+    {
+        r.ptr = nullptr;
+        r.ctrl = nullptr;
+    }
+    // destructor
+    ~basic_weak_ptr()
+    {
+        if (ctrl)
+        {
+            ctrl->weak_release();
+        }
+    }
+    // assignment
+    basic_weak_ptr& operator=(const basic_weak_ptr& r) noexcept
+    {
+        basic_weak_ptr(r).swap(*this);
+        return *this;
+    }
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    basic_weak_ptr& operator=(const basic_weak_ptr<Y, Atomic>& r) noexcept
+    {
+        basic_weak_ptr(r).swap(*this);
+        return *this;
+    }
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    basic_weak_ptr& operator=(const basic_shared_ptr<Y, Atomic>& r) noexcept
+    {
+        basic_weak_ptr(r).swap(*this);
+        return *this;
+    }
+    basic_weak_ptr& operator=(basic_weak_ptr&& r) noexcept
+    {
+        basic_weak_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+    template<typename Y>
+        requires sp_compatible_v<Y, T>
+    basic_weak_ptr& operator=(basic_weak_ptr<Y, Atomic>&& r) noexcept
+    {
+        basic_weak_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+    // modifiers
+    void reset() noexcept
+    {
+        basic_weak_ptr().swap(*this);
+    }
+    void swap(basic_weak_ptr& r) noexcept
+    {
+        std::swap(ptr, r.ptr);
+        std::swap(ctrl, r.ctrl);
+    }
+    // observers
+    long use_count() const noexcept
+    {
+        return ctrl ? ctrl->use_count() : 0;
+    }
+    bool expired() const noexcept
+    {
+        return use_count() == 0;
+    }
+    basic_shared_ptr<T, Atomic> lock() const noexcept
+    {
+        if (ctrl && ctrl->add_ref_lock())
+        {
+            return basic_shared_ptr<T, Atomic>(ctrl, ptr);
+        }
+        return basic_shared_ptr<T, Atomic>();
+    }
+    template<typename Y>
+    bool owner_before(const basic_weak_ptr<Y, Atomic>& other) const noexcept
+    {
+        return std::less<control_block*>()(ctrl, other.ctrl);
+    }
+    template<typename Y>
+    bool owner_before(const basic_shared_ptr<Y, Atomic>& other) const noexcept
+    {
+        return std::less<control_block*>()(ctrl, other.ctrl);
+    }
+private:
+    // for enable_shared_from_this: observe the object p owned by _ctrl unless already observing one
+    void assign_if_expired(element_type* p, control_block* _ctrl) noexcept
+    {
+        if (expired())
+        {
+            _ctrl->weak_add_ref();
+            if (ctrl)
+            {
+                ctrl->weak_release();
+            }
+            ptr = p;
+            ctrl = _ctrl;
+        }
+    }
+};
+
+// enable_shared_from_this (Atomic = true) and enable_local_shared_from_this (Atomic = false)
+template<typename T, bool Atomic>
+class basic_enable_shared_from_this
+{
+    template<typename U, bool A> friend class basic_shared_ptr;
+protected:
+    constexpr basic_enable_shared_from_this() noexcept
+        : weak_this()
+    {
+    }
+    basic_enable_shared_from_this([[maybe_unused]] const basic_enable_shared_from_this& other) noexcept
+        : weak_this()
+    {
+    }
+    basic_enable_shared_from_this& operator=([[maybe_unused]] const basic_enable_shared_from_this& other) noexcept
+    {
+        return *this;
+    }
+    ~basic_enable_shared_from_this() = default;
+public:
+    basic_shared_ptr<T, Atomic> shared_from_this()
+    {
+        return basic_shared_ptr<T, Atomic>(weak_this);
+    }
+    basic_shared_ptr<const T, Atomic> shared_from_this() const
+    {
+        return basic_shared_ptr<const T, Atomic>(weak_this);
+    }
+    basic_weak_ptr<T, Atomic> weak_from_this() noexcept
+    {
+        return weak_this;
+    }
+    basic_weak_ptr<const T, Atomic> weak_from_this() const noexcept
+    {
+        return weak_this;
+    }
+private:
+    // found by ADL from pointers of derived classes when shared_ptr takes ownership
+    friend const basic_enable_shared_from_this* _enable_shared_from_this_base(const basic_enable_shared_from_this* p,
+        std::bool_constant<Atomic>) noexcept
+    {
+        return p;
+    }
+    mutable basic_weak_ptr<T, Atomic> weak_this;
+};
+
+template<typename T, typename Allocator, bool Atomic, typename... Args>
+basic_shared_ptr<T, Atomic> _allocate_shared(const Allocator& alloc, Args&&... args)
+{
+    using block_type = sp_counted_inplace<std::remove_cv_t<T>, Allocator, Atomic>;
+    block_type* block = block_type::create(alloc, std::forward<Args>(args)...);
+    basic_shared_ptr<T, Atomic> res(block, block->ptr());
+    res.enable_shared_from_this_with(block->ptr());
+    return res;
+}
+
+template<typename D, typename T, bool Atomic>
+D* _get_deleter(const basic_shared_ptr<T, Atomic>& p) noexcept
+{
+    return p.ctrl ? static_cast<D*>(p.ctrl->get_deleter(typeid(D))) : nullptr;
+}
+
+} // namespace impl
+
+// shared_ptr: reference counts are atomic, copies could be used by different threads.
+template<typename T>
+using shared_ptr = impl::basic_shared_ptr<T, true>;
+template<typename T>
+using weak_ptr = impl::basic_weak_ptr<T, true>;
+template<typename T>
+using enable_shared_from_this = impl::basic_enable_shared_from_this<T, true>;
+
+// local_shared_ptr: same interface as shared_ptr, but reference counts are not atomic.
+// for single threaded hot paths, all copies of a local_shared_ptr (and local_weak_ptr) must stay in one thread.
+template<typename T>
+using local_shared_ptr = impl::basic_shared_ptr<T, false>;
+template<typename T>
+using local_weak_ptr = impl::basic_weak_ptr<T, false>;
+template<typename T>
+using enable_local_shared_from_this = impl::basic_enable_shared_from_this<T, false>;
+
+// make_shared/allocate_shared: the control block and the object are in one allocation.
+// arrays are not supported.
+template<typename T, typename Allocator, typename... Args>
+    requires (!std::is_array_v<T>)
+shared_ptr<T> allocate_shared(const Allocator& alloc, Args&&... args)
+{
+    return impl::_allocate_shared<T, Allocator, true>(alloc, std::forward<Args>(args)...);
+}
+template<typename T, typename... Args>
+    requires (!std::is_array_v<T>)
+shared_ptr<T> make_shared(Args&&... args)
+{
+    return impl::_allocate_shared<T, tstd::allocator<std::remove_cv_t<T>>, true>(
+        tstd::allocator<std::remove_cv_t<T>>(), std::forward<Args>(args)...);
+}
+template<typename T, typename Allocator>
+    requires (!std::is_array_v<T>)
+shared_ptr<T> allocate_shared_for_overwrite(const Allocator& alloc)
+{
+    return impl::_allocate_shared<T, Allocator, true>(alloc, impl::sp_for_overwrite_tag());
+}
+template<typename T>
+    requires (!std::is_array_v<T>)
+shared_ptr<T> make_shared_for_overwrite()
+{
+    return impl::_allocate_shared<T, tstd::allocator<std::remove_cv_t<T>>, true>(
+        tstd::allocator<std::remove_cv_t<T>>(), impl::sp_for_overwrite_tag());
+}
+
+template<typename T, typename Allocator, typename... Args>
+    requires (!std::is_array_v<T>)
+local_shared_ptr<T> allocate_local_shared(const Allocator& alloc, Args&&... args)
+{
+    return impl::_allocate_shared<T, Allocator, false>(alloc, std::forward<Args>(args)...);
+}
+template<typename T, typename... Args>
+    requires (!std::is_array_v<T>)
+local_shared_ptr<T> make_local_shared(Args&&... args)
+{
+    return impl::_allocate_shared<T, tstd::allocator<std::remove_cv_t<T>>, false>(
+        tstd::allocator<std::remove_cv_t<T>>(), std::forward<Args>(args)...);
+}
+
+// non-member operations of shared_ptr and local_shared_ptr
+template<typename D, typename T, bool Atomic>
+D* get_deleter(const impl::basic_shared_ptr<T, Atomic>& p) noexcept
+{
+    return impl::_get_deleter<D>(p);
+}
+
+template<typename T, typename U, bool Atomic>
+impl::basic_shared_ptr<T, Atomic> static_pointer_cast(const impl::basic_shared_ptr<U, Atomic>& r) noexcept
+{
+    using E = typename impl::basic_shared_ptr<T, Atomic>::element_type;
+    return impl::basic_shared_ptr<T, Atomic>(r, static_cast<E*>(r.get()));
+}
+template<typename T, typename U, bool Atomic>
+impl::basic_shared_ptr<T, Atomic> const_pointer_cast(const impl::basic_shared_ptr<U, Atomic>& r) noexcept
+{
+    using E = typename impl::basic_shared_ptr<T, Atomic>::element_type;
+    return impl::basic_shared_ptr<T, Atomic>(r, const_cast<E*>(r.get()));
+}
+template<typename T, typename U, bool Atomic>
+impl::basic_shared_ptr<T, Atomic> reinterpret_pointer_cast(const impl::basic_shared_ptr<U, Atomic>& r) noexcept
+{
+    using E = typename impl::basic_shared_ptr<T, Atomic>::element_type;
+    return impl::basic_shared_ptr<T, Atomic>(r, reinterpret_cast<E*>(r.get()));
+}
+template<typename T, typename U, bool Atomic>
+impl::basic_shared_ptr<T, Atomic> dynamic_pointer_cast(const impl::basic_shared_ptr<U, Atomic>& r) noexcept
+{
+    using E = typename impl::basic_shared_ptr<T, Atomic>::element_type;
+    if (E* p = dynamic_cast<E*>(r.get()))
+    {
+        return impl::basic_shared_ptr<T, Atomic>(r, p);
+    }
+    return impl::basic_shared_ptr<T, Atomic>();
+}
+
+template<typename T, bool Atomic>
+void swap(impl::basic_shared_ptr<T, Atomic>& lhs, impl::basic_shared_ptr<T, Atomic>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+template<typename T, bool Atomic>
+void swap(impl::basic_weak_ptr<T, Atomic>& lhs, impl::basic_weak_ptr<T, Atomic>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+namespace impl
+{
+// comparisons are found by ADL in namespace of basic_shared_ptr
+template<typename T, typename U, bool Atomic>
+bool operator==(const impl::basic_shared_ptr<T, Atomic>& lhs, const impl::basic_shared_ptr<U, Atomic>& rhs) noexcept
+{
+    return lhs.get() == rhs.get();
+}
+template<typename T, typename U, bool Atomic>
+bool operator<(const impl::basic_shared_ptr<T, Atomic>& lhs, const impl::basic_shared_ptr<U, Atomic>& rhs) noexcept
+{
+    using CT = std::common_type_t<typename impl::basic_shared_ptr<T, Atomic>::element_type*,
+        typename impl::basic_shared_ptr<U, Atomic>::element_type*>;
+    return std::less<CT>()(lhs.get(), rhs.get());
+}
+template<typename T, typename U, bool Atomic>
+bool operator<=(const impl::basic_shared_ptr<T, Atomic>& lhs, const impl::basic_shared_ptr<U, Atomic>& rhs) noexcept
+{
+    return !(rhs < lhs);
+}
+template<typename T, typename U, bool Atomic>
+bool operator>(const impl::basic_shared_ptr<T, Atomic>& lhs, const impl::basic_shared_ptr<U, Atomic>& rhs) noexcept
+{
+    return rhs < lhs;
+}
+template<typename T, typename U, bool Atomic>
+bool operator>=(const impl::basic_shared_ptr<T, Atomic>& lhs, const impl::basic_shared_ptr<U, Atomic>& rhs) noexcept
+{
+    return !(lhs < rhs);
+}
+template<typename T, bool Atomic>
+bool operator==(const impl::basic_shared_ptr<T, Atomic>& lhs, std::nullptr_t) noexcept
+{
+    return !lhs;
+}
+template<typename T, bool Atomic>
+bool operator<(const impl::basic_shared_ptr<T, Atomic>& lhs, std::nullptr_t) noexcept
+{
+    return std::less<typename impl::basic_shared_ptr<T, Atomic>::element_type*>()(lhs.get(), nullptr);
+}
+template<typename T, bool Atomic>
+bool operator<(std::nullptr_t, const impl::basic_shared_ptr<T, Atomic>& rhs) noexcept
+{
+    return std::less<typename impl::basic_shared_ptr<T, Atomic>::element_type*>()(nullptr, rhs.get());
+}
+template<typename T, bool Atomic>
+bool operator<=(const impl::basic_shared_ptr<T, Atomic>& lhs, std::nullptr_t) noexcept
+{
+    return !(nullptr < lhs);
+}
+template<typename T, bool Atomic>
+bool operator<=(std::nullptr_t, const impl::basic_shared_ptr<T, Atomic>& rhs) noexcept
+{
+    return !(rhs < nullptr);
+}
+template<typename T, bool Atomic>
+bool operator>(const impl::basic_shared_ptr<T, Atomic>& lhs, std::nullptr_t) noexcept
+{
+    return nullptr < lhs;
+}
+template<typename T, bool Atomic>
+bool operator>(std::nullptr_t, const impl::basic_shared_ptr<T, Atomic>& rhs) noexcept
+{
+    return rhs < nullptr;
+}
+template<typename T, bool Atomic>
+bool operator>=(const impl::basic_shared_ptr<T, Atomic>& lhs, std::nullptr_t) noexcept
+{
+    return !(lhs < nullptr);
+}
+template<typename T, bool Atomic>
+bool operator>=(std::nullptr_t, const impl::basic_shared_ptr<T, Atomic>& rhs) noexcept
+{
+    return !(nullptr < rhs);
+}
+
+template<typename CharT, typename Traits, typename T, bool Atomic>
+std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const impl::basic_shared_ptr<T, Atomic>& p)
+{
+    return os << p.get();
+}
+} // namespace impl
+
+// owner based ordering of shared_ptr and weak_ptr
+template<typename T = void>
+struct owner_less;
+
+template<typename T, bool Atomic>
+struct owner_less<impl::basic_shared_ptr<T, Atomic>>
+{
+    bool operator()(const impl::basic_shared_ptr<T, Atomic>& lhs, const impl::basic_shared_ptr<T, Atomic>& rhs) const noexcept
+    {
+        return lhs.owner_before(rhs);
+    }
+    bool operator()(const impl::basic_shared_ptr<T, Atomic>& lhs, const impl::basic_weak_ptr<T, Atomic>& rhs) const noexcept
+    {
+        return lhs.owner_before(rhs);
+    }
+    bool operator()(const impl::basic_weak_ptr<T, Atomic>& lhs, const impl::basic_shared_ptr<T, Atomic>& rhs) const noexcept
+    {
+        return lhs.owner_before(rhs);
+    }
+};
+
+template<typename T, bool Atomic>
+struct owner_less<impl::basic_weak_ptr<T, Atomic>>
+{
+    bool operator()(const impl::basic_weak_ptr<T, Atomic>& lhs, const impl::basic_weak_ptr<T, Atomic>& rhs) const noexcept
+    {
+        return lhs.owner_before(rhs);
+    }
+    bool operator()(const impl::basic_shared_ptr<T, Atomic>& lhs, const impl::basic_weak_ptr<T, Atomic>& rhs) const noexcept
+    {
+        return lhs.owner_before(rhs);
+    }
+    bool operator()(const impl::basic_weak_ptr<T, Atomic>& lhs, const impl::basic_shared_ptr<T, Atomic>& rhs) const noexcept
+    {
+        return lhs.owner_before(rhs);
+    }
+};
+
+template<>
+struct owner_less<void>
+{
+    template<typename T, typename U>
+    bool operator()(const T& lhs, const U& rhs) const noexcept
+    {
+        return lhs.owner_before(rhs);
+    }
+    using is_transparent = void;
+};
+
+} // namespace tstd
+
+template<typename T, bool Atomic>
+struct std::hash<tstd::impl::basic_shared_ptr<T, Atomic>>
+{
+    std::size_t operator()(const tstd::impl::basic_shared_ptr<T, Atomic>& p) const noexcept
+    {
+        return std::hash<typename tstd::impl::basic_shared_ptr<T, Atomic>::element_type*>()(p.get());
+    }
+};
+
+#endif // TSTL_SHARED_PTR_HPP
@@ -0,0 +1,297 @@
+#ifndef TSTL_SLAB_ALLOCATOR_HPP
+#define TSTL_SLAB_ALLOCATOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <bit>
+#include <memory>      // for std::pointer_traits
+#include <type_traits>
+
+namespace tstd
+{
+
+namespace impl
+{
+
+// Slab of fixed size slots addressed by 32-bit indices, index 0 is the null pointer.
+// Slots are carved from chunks of geometrically growing size: indices [1, 2^MinBits) live in the first chunk,
+// and indices [2^(b-1), 2^b) live in chunk b for b > MinBits. bias[b] is the address of chunk b minus the offset
+// of its first index, so the address of index i is always bias[bit_width(i)] + i * SlotSize (bias[0] = 0 maps null
+// to nullptr), which is one load from a 264 bytes table.
+// Freed slots are kept in a free list linked by indices, chunks are never returned to system.
+template<std::size_t SlotSize, std::size_t SlotAlign, bool ThreadSafe>
+class slab_storage
+{
+    static_assert(SlotSize >= sizeof(std::uint32_t) && SlotSize % SlotAlign == 0);
+public:
+    inline constexpr static std::size_t MinBits = 6;
+    inline constexpr static std::size_t MaxBits = 32;
+    using index_type = std::uint32_t;
+private:
+    // only live in static storage, zero-initialized
+    inline static std::uintptr_t bias[MaxBits + 1];
+    inline static void* chunks[MaxBits + 1];
+    inline static index_type free_list;   // head of free slots
+    inline static std::uint64_t next_index; // next never used index
+    inline static std::uint64_t end_index;  // end of indices of allocated chunks
+    inline static std::mutex lock;
+public:
+    static void* address(index_type i) noexcept
+    {
+        return reinterpret_cast<void*>(bias[std::bit_width(i)] + static_cast<std::uintptr_t>(i) * SlotSize);
+    }
+    // index of an address of slot, linear in number of chunks
+    static index_type index_of(const void* p) noexcept
+    {
+        if (!p)
+        {
+            return 0;
+        }
+        std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(p);
+        for (std::size_t b = MinBits; b <= MaxBits && chunks[b]; ++b)
+        {
+            std::uintptr_t first = reinterpret_cast<std::uintptr_t>(chunks[b]);
+            if (addr >= first && addr < first + (chunk_end(b) - chunk_begin(b)) * SlotSize)
+            {
+                return static_cast<index_type>((addr - bias[b]) / SlotSize);
+            }
+        }
+        return 0;
+    }
+    static index_type allocate()
+    {
+        if constexpr (ThreadSafe)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            return allocate_nolock();
+        }
+        else
+        {
+            return allocate_nolock();
+        }
+    }
+    static void deallocate(index_type i) noexcept
+    {
+        if constexpr (ThreadSafe)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            deallocate_nolock(i);
+        }
+        else
+        {
+            deallocate_nolock(i);
+        }
+    }
+private:
+    // indices of chunk b: [chunk_begin(b), chunk_end(b))
+    static constexpr std::uint64_t chunk_begin(std::size_t b) noexcept
+    {
+        return b <= MinBits ? 1 : std::uint64_t(1) << (b - 1);
+    }
+    static constexpr std::uint64_t chunk_end(std::size_t b) noexcept
+    {
+        return b <= MinBits ? std::uint64_t(1) << MinBits : std::uint64_t(1) << b;
+    }
+    static index_type allocate_nolock()
+    {
+        if (free_list)
+        {
+            index_type i = free_list;
+            free_list = *static_cast<index_type*>(address(i));
+            return i;
+        }
+        if (next_index == end_index)
+        {
+            grow();
+        }
+        return static_cast<index_type>(next_index++);
+    }
+    static void deallocate_nolock(index_type i) noexcept
+    {
+        *static_cast<index_type*>(address(i)) = free_list;
+        free_list = i;
+    }
+    // allocate the next chunk
+    static void grow()
+    {
+        std::size_t b = end_index == 0 ? MinBits : std::bit_width(end_index);
+        if (b > MaxBits)
+        {
+            throw std::bad_alloc(); // all 32-bit indices are used
+        }
+        std::size_t bytes = (chunk_end(b) - chunk_begin(b)) * SlotSize;
+        chunks[b] = impl::_allocate_bytes(bytes, SlotAlign);
+        std::uintptr_t chunk_bias = reinterpret_cast<std::uintptr_t>(chunks[b]) - chunk_begin(b) * SlotSize;
+        if (b == MinBits)
+        {
+            for (std::size_t k = 1; k <= MinBits; ++k)
+            {
+                bias[k] = chunk_bias;
+            }
+            next_index = 1;
+        }
+        else
+        {
+            bias[b] = chunk_bias;
+        }
+        end_index = chunk_end(b);
+    }
+};
+
+// size of slot of T
+template<typename T>
+inline constexpr std::size_t slab_slot_size = ((sizeof(T) > sizeof(std::uint32_t) ? sizeof(T) : sizeof(std::uint32_t)) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+template<typename T, bool ThreadSafe>
+using slab_storage_of = slab_storage<slab_slot_size<std::remove_cv_t<T>>, alignof(T), ThreadSafe>;
+
+} // namespace impl
+
+// 32-bit fancy pointer to a slot of slab_allocator<T, ThreadSafe>.
+// Only points to single objects: there is no pointer arithmetic.
+template<typename T, bool ThreadSafe = true>
+class slab_ptr
+{
+    template<typename U, bool TS> friend class slab_ptr;
+public:
+    using element_type = T;
+    using difference_type = std::ptrdiff_t;
+    using index_type = std::uint32_t;
+    template<typename U>
+    using rebind = slab_ptr<U, ThreadSafe>;
+private:
+    index_type idx;
+public:
+    constexpr slab_ptr() noexcept
+        : idx(0)
+    {
+    }
+    constexpr slab_ptr(std::nullptr_t) noexcept
+        : idx(0)
+    {
+    }
+    constexpr explicit slab_ptr(index_type i) noexcept
+        : idx(i)
+    {
+    }
+    // slab_ptr<T> to slab_ptr<const T>
+    template<typename U>
+        requires (std::is_same_v<const U, T> && !std::is_same_v<U, T>)
+    constexpr slab_ptr(const slab_ptr<U, ThreadSafe>& other) noexcept
+        : idx(other.idx)
+    {
+    }
+    constexpr index_type index() const noexcept
+    {
+        return idx;
+    }
+    T* get() const noexcept requires (!std::is_void_v<T>)
+    {
+        return static_cast<T*>(impl::slab_storage_of<T, ThreadSafe>::address(idx));
+    }
+    template<typename U = T>
+        requires (!std::is_void_v<U>)
+    U& operator*() const noexcept
+    {
+        return *get();
+    }
+    T* operator->() const noexcept requires (!std::is_void_v<T>)
+    {
+        return get();
+    }
+    constexpr explicit operator bool() const noexcept
+    {
+        return idx != 0;
+    }
+    constexpr bool operator==(const slab_ptr& other) const noexcept = default;
+    constexpr bool operator==(std::nullptr_t) const noexcept
+    {
+        return idx == 0;
+    }
+    // only for objects in slots of slab_allocator<T, ThreadSafe>
+    template<typename U = T>
+        requires (!std::is_void_v<U>)
+    static slab_ptr pointer_to(U& r) noexcept
+    {
+        return slab_ptr(impl::slab_storage_of<T, ThreadSafe>::index_of(std::addressof(r)));
+    }
+};
+
+// slab allocator: single objects are allocated from a slab of T sized slots and are referred by 32-bit slab_ptr.
+// node-based containers (list, map/set, unordered containers) store their links as Allocator::pointer,
+// so with this allocator every link takes 4 bytes instead of 8.
+// e.g. tstd::map<int, int, std::less<int>, tstd::slab_allocator<std::pair<const int, int>>>
+// All allocators of same slot size share a slab, which has at most 2^32 - 1 slots and is never shrunk.
+// Only n == 1 is supported by allocate, containers needing arrays (hash table buckets) use tstd::allocator for them.
+template<typename T, bool ThreadSafe = true>
+class slab_allocator
+{
+private:
+    using storage = impl::slab_storage_of<T, ThreadSafe>;
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using pointer = slab_ptr<T, ThreadSafe>;
+    using const_pointer = slab_ptr<const T, ThreadSafe>;
+    using void_pointer = slab_ptr<void, ThreadSafe>;
+    using const_void_pointer = slab_ptr<const void, ThreadSafe>;
+    using reference = T&;
+    using const_reference = const T&;
+    template<typename U> struct rebind {
+        using other = slab_allocator<U, ThreadSafe>;
+    };
+    using is_always_equal = std::true_type;
+
+    constexpr slab_allocator() noexcept = default;
+    constexpr slab_allocator(const slab_allocator& other) noexcept = default;
+    template<typename U>
+    constexpr slab_allocator(const slab_allocator<U, ThreadSafe>& other) noexcept {}
+
+    [[nodiscard]] pointer allocate(size_type n)
+    {
+        if (n != 1)
+        {
+            throw std::bad_array_new_length();
+        }
+        return pointer(storage::allocate());
+    }
+    void deallocate(pointer p, [[maybe_unused]] size_type n)
+    {
+        storage::deallocate(p.index());
+    }
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        impl::_construct(p, std::forward<Args>(args)...);
+    }
+    template<typename U>
+    void destroy(U* p)
+    {
+        impl::_destroy(p);
+    }
+    size_type max_size() const noexcept
+    {
+        return 1;
+    }
+};
+
+template<typename T1, typename T2, bool ThreadSafe>
+constexpr bool operator==(const slab_allocator<T1, ThreadSafe>& lhs, const slab_allocator<T2, ThreadSafe>& rhs) noexcept
+{
+    return true;
+}
+template<typename T1, typename T2, bool ThreadSafe>
+constexpr bool operator!=(const slab_allocator<T1, ThreadSafe>& lhs, const slab_allocator<T2, ThreadSafe>& rhs) noexcept
+{
+    return false;
+}
+
+} // namespace tstd
+
+#endif // TSTL_SLAB_ALLOCATOR_HPP
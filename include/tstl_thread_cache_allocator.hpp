@@ -0,0 +1,288 @@
+#ifndef TSTL_THREAD_CACHE_ALLOCATOR_HPP
+#define TSTL_THREAD_CACHE_ALLOCATOR_HPP
+
+#include <tstl_allocator.hpp>
+#include <new>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+namespace tstd
+{
+
+namespace impl
+{
+
+// Thread caching allocator (in the manner of tcmalloc).
+// Small blocks (<= MaxBytes) are served from a thread local magazine of the size class without any lock.
+// An empty magazine is refilled by a batch from the central depot (or a newly carved chunk),
+// a magazine with more than MagazineCapacity blocks returns a batch to the depot.
+// Blocks are not owned by threads: a block freed by another thread (remote free) just goes to
+// the magazine of the freeing thread, and migrates back to other threads through the depot.
+// Magazines are flushed to the depot when threads exit, memory of chunks is never returned to system.
+// Blocks freed after the thread cache is destroyed (e.g. by static or thread_local containers destroyed later)
+// go to the depot directly.
+class thread_cache_alloc_base
+{
+public:
+    inline constexpr static std::size_t Align = 16;
+    inline constexpr static std::size_t MaxBytes = 256;
+    inline constexpr static std::size_t SizeClassCount = MaxBytes / Align;
+    inline constexpr static std::size_t BatchSize = 32; // blocks moved between magazine and depot at a time
+    inline constexpr static std::size_t MagazineCapacity = 2 * BatchSize;
+private:
+    struct obj
+    {
+        obj* next;
+    };
+    // depots and magazines only live in static/thread storage, they are zero-initialized.
+    // central depot of a size class
+    struct depot
+    {
+        std::mutex lock;
+        obj* free_list;
+        std::size_t count;
+    };
+    // magazine of a size class in thread cache
+    struct magazine
+    {
+        obj* free_list;
+        std::size_t count;
+    };
+    struct thread_cache
+    {
+        magazine magazines[SizeClassCount];
+        ~thread_cache()
+        {
+            for (std::size_t i = 0; i < SizeClassCount; ++i)
+            {
+                while (magazines[i].count > 0)
+                {
+                    release_batch(i, magazines[i]);
+                }
+            }
+            cache_destroyed = true;
+        }
+    };
+    inline static depot depots[SizeClassCount];
+    inline static thread_local thread_cache cache;
+    // trivially destructible, so it outlives cache and tells later calls not to touch it
+    inline static thread_local bool cache_destroyed = false;
+public:
+    static constexpr std::size_t round_up(std::size_t bytes)
+    {
+        return (bytes + Align - 1) & ~(Align - 1);
+    }
+    // index of size class, 0 bytes use the smallest class
+    static constexpr std::size_t size_class_index(std::size_t bytes)
+    {
+        return bytes == 0 ? 0 : (bytes + Align - 1) / Align - 1;
+    }
+    static void* allocate(std::size_t bytes)
+    {
+        if (bytes > MaxBytes)
+        {
+            return impl::_allocate(static_cast<ptrdiff_t>(bytes), (char*)nullptr);
+        }
+        std::size_t index = size_class_index(bytes);
+        if (cache_destroyed) [[unlikely]]
+        {
+            // fetch a batch into a temporary magazine, and give back what is left
+            magazine mag{nullptr, 0};
+            fetch_batch(index, mag);
+            obj* result = mag.free_list;
+            mag.free_list = result->next;
+            if (--mag.count > 0)
+            {
+                release_batch(index, mag);
+            }
+            return result;
+        }
+        magazine& mag = cache.magazines[index];
+        if (mag.count == 0)
+        {
+            fetch_batch(index, mag);
+        }
+        obj* result = mag.free_list;
+        mag.free_list = result->next;
+        --mag.count;
+        return result;
+    }
+    static void deallocate(void* p, std::size_t bytes)
+    {
+        if (bytes > MaxBytes)
+        {
+            impl::_deallocate(static_cast<char*>(p));
+            return;
+        }
+        std::size_t index = size_class_index(bytes);
+        obj* q = static_cast<obj*>(p);
+        if (cache_destroyed) [[unlikely]]
+        {
+            q->next = nullptr;
+            magazine mag{q, 1};
+            release_batch(index, mag);
+            return;
+        }
+        magazine& mag = cache.magazines[index];
+        q->next = mag.free_list;
+        mag.free_list = q;
+        if (++mag.count > MagazineCapacity)
+        {
+            release_batch(index, mag);
+        }
+    }
+    // number of free blocks of the size class of bytes in the central depot
+    static std::size_t depot_blocks(std::size_t bytes)
+    {
+        depot& d = depots[size_class_index(bytes)];
+        std::lock_guard<std::mutex> guard(d.lock);
+        return d.count;
+    }
+private:
+    // move a batch from depot to the empty magazine, carve a new chunk if depot is empty
+    static void fetch_batch(std::size_t index, magazine& mag)
+    {
+        {
+            depot& d = depots[index];
+            std::lock_guard<std::mutex> guard(d.lock);
+            if (d.count > 0)
+            {
+                obj* first = d.free_list;
+                obj* last = first;
+                std::size_t n = 1;
+                for (; n < BatchSize && last->next; ++n)
+                {
+                    last = last->next;
+                }
+                d.free_list = last->next;
+                d.count -= n;
+                last->next = nullptr;
+                mag.free_list = first;
+                mag.count = n;
+                return;
+            }
+        }
+        // no lock needed: the chunk is only visible to this thread
+        std::size_t size = (index + 1) * Align;
+        char* chunk = impl::_allocate(static_cast<ptrdiff_t>(size * BatchSize), (char*)nullptr);
+        for (std::size_t i = BatchSize; i > 0; --i)
+        {
+            obj* q = reinterpret_cast<obj*>(chunk + (i - 1) * size);
+            q->next = mag.free_list;
+            mag.free_list = q;
+        }
+        mag.count = BatchSize;
+    }
+    // move (at most) a batch from magazine to depot, splice the chain under the lock
+    static void release_batch(std::size_t index, magazine& mag)
+    {
+        obj* first = mag.free_list;
+        obj* last = first;
+        std::size_t n = 1;
+        for (; n < BatchSize && n < mag.count; ++n)
+        {
+            last = last->next;
+        }
+        mag.free_list = last->next;
+        mag.count -= n;
+        depot& d = depots[index];
+        std::lock_guard<std::mutex> guard(d.lock);
+        last->next = d.free_list;
+        d.free_list = first;
+        d.count += n;
+    }
+};
+
+} // namespace impl
+
+// thread caching allocator: small blocks come from lock free thread local magazines,
+// fit for node-based containers built and destroyed by many threads concurrently.
+// blocks of over-aligned types or larger than MaxBytes are allocated like tstd::allocator.
+template<typename T>
+class thread_cache_allocator
+{
+private:
+    using base = impl::thread_cache_alloc_base;
+    inline constexpr static bool use_cache = alignof(T) <= base::Align;
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    template<typename U> struct rebind {
+        using other = thread_cache_allocator<U>;
+    };
+    using is_always_equal = std::true_type;
+
+    constexpr thread_cache_allocator() noexcept = default;
+    constexpr thread_cache_allocator(const thread_cache_allocator& other) noexcept = default;
+    template<typename U>
+    constexpr thread_cache_allocator(const thread_cache_allocator<U>& other) noexcept {}
+
+    [[nodiscard]] T* allocate(size_type n)
+    {
+        if constexpr (use_cache)
+        {
+            return static_cast<T*>(base::allocate(n * sizeof(T)));
+        }
+        else
+        {
+            return impl::_allocate(static_cast<difference_type>(n), (T*)nullptr);
+        }
+    }
+    void deallocate(T* p, size_type n)
+    {
+        if constexpr (use_cache)
+        {
+            base::deallocate(p, n * sizeof(T));
+        }
+        else
+        {
+            impl::_deallocate(p);
+        }
+    }
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        impl::_construct(p, std::forward<Args>(args)...);
+    }
+    template<typename U>
+    void destroy(U* p)
+    {
+        impl::_destroy(p);
+    }
+    size_type max_size() const noexcept
+    {
+        return static_cast<size_type>(std::numeric_limits<size_t>::max() / sizeof(T));
+    }
+    pointer address(reference x) const noexcept
+    {
+        return static_cast<pointer>(&x);
+    }
+    const_pointer address(const_reference x) const noexcept
+    {
+        return static_cast<const_pointer>(&x);
+    }
+};
+
+// all thread cache allocators share the same depot
+template<typename T1, typename T2>
+constexpr bool operator==(const thread_cache_allocator<T1>& lhs, const thread_cache_allocator<T2>& rhs) noexcept
+{
+    return true;
+}
+template<typename T1, typename T2>
+constexpr bool operator!=(const thread_cache_allocator<T1>& lhs, const thread_cache_allocator<T2>& rhs) noexcept
+{
+    return false;
+}
+
+} // namespace tstd
+
+#endif // TSTL_THREAD_CACHE_ALLOCATOR_HPP
@@ -2,73 +2,422 @@
 #define TSTL_UNINTIALIZED_HPP
 
 #include <tstl_allocator.hpp>
+#include <titerator.hpp>
 #include <memory>
 #include <type_traits>
+#include <cstring>
+#include <compare>
 
 namespace tstd
 {
 
-// There is space to optimize for POD types.
+namespace impl
+{
+// elements of [first, last) could be constructed to dest by memmove when both iterators are pointers
+// to the same trivially copyable type, and the construction from SrcRef is trivial.
+template<typename InputIterator, typename ForwardIterator, typename SrcRef>
+inline constexpr bool is_memmovable_v = []() {
+    if constexpr (std::is_pointer_v<InputIterator> && std::is_pointer_v<ForwardIterator>)
+    {
+        using Src = std::remove_cv_t<std::remove_pointer_t<InputIterator>>;
+        using Dest = std::remove_pointer_t<ForwardIterator>;
+        return std::is_same_v<Src, Dest> && std::is_trivially_copyable_v<Dest>
+            && std::is_trivially_constructible_v<Dest, SrcRef>;
+    }
+    return false;
+}();
+
+template<typename InputIterator, typename ForwardIterator>
+inline constexpr bool is_copy_memmovable_v = is_memmovable_v<InputIterator, ForwardIterator,
+    std::add_lvalue_reference_t<std::add_const_t<std::remove_pointer_t<ForwardIterator>>>>;
+
+template<typename InputIterator, typename ForwardIterator>
+inline constexpr bool is_move_memmovable_v = is_memmovable_v<InputIterator, ForwardIterator,
+    std::add_rvalue_reference_t<std::remove_pointer_t<ForwardIterator>>>;
+
+// filling of byte sized trivially copyable types could be done by memset
+template<typename ForwardIterator, typename T>
+inline constexpr bool is_memsetable_v = []() {
+    if constexpr (std::is_pointer_v<ForwardIterator>)
+    {
+        using Dest = std::remove_pointer_t<ForwardIterator>;
+        return std::is_same_v<std::remove_cv_t<T>, Dest> && sizeof(Dest) == 1
+            && std::is_trivially_copyable_v<Dest> && std::is_trivially_constructible_v<Dest, const T&>;
+    }
+    return false;
+}();
+
+template<typename T>
+inline T* _memmove_n(const T* first, std::size_t count, T* dest)
+{
+    if (count > 0)
+    {
+        std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), count * sizeof(T));
+    }
+    return dest + count;
+}
+
+template<typename T>
+inline T* _memset_n(T* first, std::size_t count, const T& value)
+{
+    if (count > 0)
+    {
+        unsigned char byte;
+        std::memcpy(&byte, std::addressof(value), 1);
+        std::memset(static_cast<void*>(first), byte, count);
+    }
+    return first + count;
+}
+
+// ranges of pointers to the same integral or pointer type are equal exactly when their bytes are,
+// so they could be compared by memcmp
+template<typename Iterator1, typename Iterator2>
+inline constexpr bool is_memcmp_comparable_v = []() {
+    if constexpr (std::is_pointer_v<Iterator1> && std::is_pointer_v<Iterator2>)
+    {
+        using T1 = std::remove_const_t<std::remove_pointer_t<Iterator1>>;
+        using T2 = std::remove_const_t<std::remove_pointer_t<Iterator2>>;
+        return std::is_same_v<T1, T2> && (std::is_integral_v<T1> || std::is_pointer_v<T1>);
+    }
+    return false;
+}();
+
+// byte-wise order is value order only for unsigned byte types
+template<typename T>
+inline constexpr bool is_memcmp_ordered_v = std::is_integral_v<T> && std::is_unsigned_v<T> && sizeof(T) == 1;
+
+template<typename T>
+inline bool _memequal_n(const T* first1, const T* first2, std::size_t count)
+{
+    return count == 0 || std::memcmp(first1, first2, count * sizeof(T)) == 0;
+}
+
+// index of the first mismatch of [first1, first1 + count) and [first2, first2 + count), or count.
+// blocks are skipped by memcmp, then the mismatch is located in the block.
+template<typename T>
+inline std::size_t _mismatch_n(const T* first1, const T* first2, std::size_t count)
+{
+    constexpr std::size_t block = 256 / sizeof(T) > 0 ? 256 / sizeof(T) : 1;
+    std::size_t i = 0;
+    while (i + block <= count && std::memcmp(first1 + i, first2 + i, block * sizeof(T)) == 0)
+    {
+        i += block;
+    }
+    while (i < count && first1[i] == first2[i])
+    {
+        ++i;
+    }
+    return i;
+}
+
+// searching a value of the same integral type in a range of pointers could be done block by block
+template<typename Iterator, typename T>
+inline constexpr bool is_block_searchable_v = []() {
+    if constexpr (std::is_pointer_v<Iterator>)
+    {
+        using Elem = std::remove_cv_t<std::remove_pointer_t<Iterator>>;
+        return std::is_same_v<Elem, T> && std::is_integral_v<Elem>;
+    }
+    return false;
+}();
+
+// index of the first element equal to value in [first, first + count), or count.
+// bytes are searched by memchr, other types by blocks tested without branch (which could be vectorized),
+// then the element is located in the block.
+template<typename T>
+inline std::size_t _find_n(const T* first, std::size_t count, T value)
+{
+    if constexpr (sizeof(T) == 1)
+    {
+        unsigned char byte;
+        std::memcpy(&byte, &value, 1);
+        const void* pos = count == 0 ? nullptr : std::memchr(first, byte, count);
+        return pos ? static_cast<std::size_t>(static_cast<const T*>(pos) - first) : count;
+    }
+    else
+    {
+        constexpr std::size_t block = 64 / sizeof(T) > 8 ? 64 / sizeof(T) : 8;
+        std::size_t i = 0;
+        for (; i + block <= count; i += block)
+        {
+            bool found = false;
+            for (std::size_t j = 0; j < block; ++j)
+            {
+                found |= first[i + j] == value;
+            }
+            if (found)
+            {
+                break;
+            }
+        }
+        while (i < count && first[i] != value)
+        {
+            ++i;
+        }
+        return i;
+    }
+}
+
+// lexicographical three way compare of [first1, first1 + count1) and [first2, first2 + count2)
+template<typename T>
+inline std::strong_ordering _memcmp_three_way(const T* first1, std::size_t count1, const T* first2, std::size_t count2)
+{
+    std::size_t count = count1 < count2 ? count1 : count2;
+    if constexpr (is_memcmp_ordered_v<T>)
+    {
+        int result = count == 0 ? 0 : std::memcmp(first1, first2, count);
+        if (result != 0)
+        {
+            return result < 0 ? std::strong_ordering::less : std::strong_ordering::greater;
+        }
+    }
+    else
+    {
+        std::size_t i = _mismatch_n(first1, first2, count);
+        if (i < count)
+        {
+            return std::compare_three_way()(first1[i], first2[i]);
+        }
+    }
+    return count1 <=> count2;
+}
+} // namespace impl
+
+// Types whose objects could be relocated (move constructed to a new location then destroyed at
+// the old one) by copying bytes. Trivially copyable types always are, specialize it for other types
+// that never hold pointers to themselves, like tstd::vector and tstd::deque.
+template<typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template<typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+namespace impl
+{
+// relocate [first, last) to uninitialized dest which must not overlap with [first, last),
+// elements of [first, last) are destroyed. return end of dest.
+template<typename T>
+inline T* _relocate(T* first, T* last, T* dest)
+{
+    if constexpr (tstd::is_trivially_relocatable_v<T>)
+    {
+        return _memmove_n(first, static_cast<std::size_t>(last - first), dest);
+    }
+    else
+    {
+        for (; first != last; ++first, ++dest)
+        {
+            _construct(dest, std::move(*first));
+            _destroy(first);
+        }
+        return dest;
+    }
+}
+
+// destroy [first, last), used to roll back a partially constructed range
+template<typename ForwardIterator>
+inline void _destroy_range(ForwardIterator first, ForwardIterator last)
+{
+    for (; first != last; ++first)
+    {
+        _destroy(&*first);
+    }
+}
+} // namespace impl
+
+// uninitialized copy/move/fill of trivially copyable types on pointers are lowered to memmove/memset.
+// if a constructor throws, the elements already constructed are destroyed.
 
 template<class InputIterator, class ForwardIterator>
 ForwardIterator uninitialized_copy(InputIterator first, InputIterator last, ForwardIterator dest)
 {
-    for (; first != last; ++dest, ++first)
+    if constexpr (impl::is_copy_memmovable_v<InputIterator, ForwardIterator>)
+    {
+        return impl::_memmove_n(first, static_cast<std::size_t>(last - first), dest);
+    }
+    ForwardIterator cur = dest;
+    try
     {
-        impl::_construct(&*dest, *first);
+        for (; first != last; ++cur, ++first)
+        {
+            impl::_construct(&*cur, *first);
+        }
     }
-    return dest;
+    catch (...)
+    {
+        impl::_destroy_range(dest, cur);
+        throw;
+    }
+    return cur;
 }
 
 template<class InputIterator, class Size, class ForwardIterator>
 ForwardIterator uninitialized_copy_n(InputIterator first, Size count, ForwardIterator dest)
 {
-    for (; count > 0; --count, ++dest, ++first)
+    if constexpr (impl::is_copy_memmovable_v<InputIterator, ForwardIterator>)
     {
-        impl::_construct(&*dest, *first);
+        return impl::_memmove_n(first, count > 0 ? static_cast<std::size_t>(count) : 0, dest);
     }
-    return dest;
+    ForwardIterator cur = dest;
+    try
+    {
+        for (; count > 0; --count, ++cur, ++first)
+        {
+            impl::_construct(&*cur, *first);
+        }
+    }
+    catch (...)
+    {
+        impl::_destroy_range(dest, cur);
+        throw;
+    }
+    return cur;
 }
 
 template<class ForwardIterator, class T>
 void uninitialized_fill(ForwardIterator first, ForwardIterator last, const T& value)
 {
-    for (; first != last; ++first)
+    if constexpr (impl::is_memsetable_v<ForwardIterator, T>)
+    {
+        impl::_memset_n(first, static_cast<std::size_t>(last - first), value);
+        return;
+    }
+    ForwardIterator cur = first;
+    try
     {
-        impl::_construct(&*first, value);
+        for (; cur != last; ++cur)
+        {
+            impl::_construct(&*cur, value);
+        }
+    }
+    catch (...)
+    {
+        impl::_destroy_range(first, cur);
+        throw;
     }
 }
 
 template<class ForwardIterator, class Size, class T>
 ForwardIterator uninitialized_fill_n(ForwardIterator first, Size count, const T& value)
 {
-    for (; count > 0; --count, ++first)
+    if constexpr (impl::is_memsetable_v<ForwardIterator, T>)
+    {
+        return impl::_memset_n(first, count > 0 ? static_cast<std::size_t>(count) : 0, value);
+    }
+    ForwardIterator cur = first;
+    try
+    {
+        for (; count > 0; --count, ++cur)
+        {
+            impl::_construct(&*cur, value);
+        }
+    }
+    catch (...)
     {
-        impl::_construct(&*first, value);
+        impl::_destroy_range(first, cur);
+        throw;
     }
-    return first;
+    return cur;
 }
 
 // since C++17
 template<typename InputIterator, typename ForwardIterator>
 ForwardIterator uninitialized_move(InputIterator first, InputIterator last, ForwardIterator dest)
 {
-    for (; first != last; ++dest, ++first)
+    if constexpr (impl::is_move_memmovable_v<InputIterator, ForwardIterator>)
     {
-        impl::_construct(&*dest, std::move(*first));
+        return impl::_memmove_n(first, static_cast<std::size_t>(last - first), dest);
     }
-    return dest;
+    ForwardIterator cur = dest;
+    try
+    {
+        for (; first != last; ++cur, ++first)
+        {
+            impl::_construct(&*cur, std::move(*first));
+        }
+    }
+    catch (...)
+    {
+        impl::_destroy_range(dest, cur);
+        throw;
+    }
+    return cur;
 }
 
 // since C++17
 template<typename InputIterator, typename Size, typename ForwardIterator>
 ForwardIterator uninitialized_move_n(InputIterator first, Size count, ForwardIterator dest)
 {
-    for (; count > 0; --count, ++dest, ++first)
+    if constexpr (impl::is_move_memmovable_v<InputIterator, ForwardIterator>)
+    {
+        return impl::_memmove_n(first, count > 0 ? static_cast<std::size_t>(count) : 0, dest);
+    }
+    ForwardIterator cur = dest;
+    try
+    {
+        for (; count > 0; --count, ++cur, ++first)
+        {
+            impl::_construct(&*cur, std::move(*first));
+        }
+    }
+    catch (...)
     {
-        impl::_construct(&*dest, std::move(*first));
+        impl::_destroy_range(dest, cur);
+        throw;
+    }
+    return cur;
+}
+
+// since C++17
+// default-initialize: no initialization at all for trivial types
+template<typename ForwardIterator>
+void uninitialized_default_construct(ForwardIterator first, ForwardIterator last)
+{
+    using T = typename std::iterator_traits<ForwardIterator>::value_type;
+    if constexpr (!std::is_trivially_default_constructible_v<T>)
+    {
+        ForwardIterator cur = first;
+        try
+        {
+            for (; cur != last; ++cur)
+            {
+                ::new (static_cast<void*>(std::addressof(*cur))) T;
+            }
+        }
+        catch (...)
+        {
+            impl::_destroy_range(first, cur);
+            throw;
+        }
+    }
+}
+
+// since C++17
+template<typename ForwardIterator, typename Size>
+ForwardIterator uninitialized_default_construct_n(ForwardIterator first, Size count)
+{
+    using T = typename std::iterator_traits<ForwardIterator>::value_type;
+    if constexpr (std::is_trivially_default_constructible_v<T>)
+    {
+        return count > 0 ? tstd::next(first, count) : first;
+    }
+    else
+    {
+        ForwardIterator cur = first;
+        try
+        {
+            for (; count > 0; --count, ++cur)
+            {
+                ::new (static_cast<void*>(std::addressof(*cur))) T;
+            }
+        }
+        catch (...)
+        {
+            impl::_destroy_range(first, cur);
+            throw;
+        }
+        return cur;
     }
-    return dest;
 }
 
 // since C++20
@@ -86,7 +435,7 @@ constexpr void destroy_at(T* p)
     {
         for (auto& elem: *p)
         {
-            destroy_at(std::addressof(elem));
+            tstd::destroy_at(std::addressof(elem));
         }
     }
     else
@@ -99,9 +448,13 @@ constexpr void destroy_at(T* p)
 template<typename ForwardIterator>
 constexpr void destroy(ForwardIterator first, ForwardIterator last)
 {
+    if constexpr (std::is_trivially_destructible_v<typename std::iterator_traits<ForwardIterator>::value_type>)
+    {
+        return;
+    }
     for (; first != last; ++first)
     {
-        destroy_at(std::addressof(*first));
+        tstd::destroy_at(std::addressof(*first));
     }
 }
 
@@ -111,7 +464,7 @@ constexpr void destroy(ForwardIterator first, Size count)
 {
     for (; count > 0; --count, ++first)
     {
-        destroy_at(std::addressof(*first));
+        tstd::destroy_at(std::addressof(*first));
     }
 }
 
@@ -0,0 +1,475 @@
+#ifndef TSTL_UNIQUE_PTR_HPP
+#define TSTL_UNIQUE_PTR_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <functional> // for std::hash std::less
+#include <compare>
+#include <ostream>
+
+namespace tstd
+{
+
+// default deleter
+template<typename T>
+struct default_delete
+{
+    constexpr default_delete() noexcept = default;
+    template<typename U, std::enable_if_t<std::is_convertible_v<U*, T*>, int> = 0>
+    default_delete(const default_delete<U>& other) noexcept
+    {
+    }
+    void operator()(T* ptr) const
+    {
+        static_assert(sizeof(T) > 0, "can not delete pointer to incomplete type");
+        delete ptr;
+    }
+};
+
+template<typename T>
+struct default_delete<T[]>
+{
+    constexpr default_delete() noexcept = default;
+    template<typename U, std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>, int> = 0>
+    default_delete(const default_delete<U[]>& other) noexcept
+    {
+    }
+    template<typename U, std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>, int> = 0>
+    void operator()(U* ptr) const
+    {
+        static_assert(sizeof(U) > 0, "can not delete pointer to incomplete type");
+        delete[] ptr;
+    }
+};
+
+namespace impl
+{
+// pointer type of unique_ptr: Deleter::pointer if exists, T* otherwise
+template<typename T, typename Deleter>
+auto _unique_ptr_pointer()
+{
+    if constexpr (requires { typename std::remove_reference_t<Deleter>::pointer; })
+    {
+        return std::type_identity<typename std::remove_reference_t<Deleter>::pointer>();
+    }
+    else
+    {
+        return std::type_identity<T*>();
+    }
+}
+template<typename T, typename Deleter>
+using unique_ptr_pointer_t = typename decltype(_unique_ptr_pointer<T, Deleter>())::type;
+} // namespace impl
+
+// unique_ptr
+// The deleter is a [[no_unique_address]] member, so unique_ptr with an empty deleter (default_delete,
+// stateless lambdas, etc) is exactly as large as a raw pointer.
+template<typename T, typename Deleter = tstd::default_delete<T>>
+class unique_ptr
+{
+    template<typename U, typename E> friend class unique_ptr;
+public:
+    using pointer = impl::unique_ptr_pointer_t<T, Deleter>;
+    using element_type = T;
+    using deleter_type = Deleter;
+private:
+    pointer ptr;
+    [[no_unique_address]] Deleter deleter;
+public:
+    // constructors
+    // 1
+    constexpr unique_ptr() noexcept requires (std::is_default_constructible_v<Deleter> && !std::is_pointer_v<Deleter>)
+        : ptr()
+        , deleter()
+    {
+    }
+    constexpr unique_ptr(std::nullptr_t) noexcept requires (std::is_default_constructible_v<Deleter> && !std::is_pointer_v<Deleter>)
+        : ptr()
+        , deleter()
+    {
+    }
+    // 2
+    explicit unique_ptr(pointer p) noexcept requires (std::is_default_constructible_v<Deleter> && !std::is_pointer_v<Deleter>)
+        : ptr(p)
+        , deleter()
+    {
+    }
+    // 3, 4
+    unique_ptr(pointer p, const Deleter& d) noexcept requires (!std::is_reference_v<Deleter>)
+        : ptr(p)
+        , deleter(d)
+    {
+    }
+    unique_ptr(pointer p, Deleter&& d) noexcept requires (!std::is_reference_v<Deleter>)
+        : ptr(p)
+        , deleter(std::move(d))
+    {
+    }
+    unique_ptr(pointer p, Deleter d) noexcept requires std::is_reference_v<Deleter>
+        : ptr(p)
+        , deleter(d)
+    {
+    }
+    // 5
+    unique_ptr(unique_ptr&& other) noexcept
+        : ptr(other.release())
+        , deleter(std::forward<Deleter>(other.deleter))
+    {
+    }
+    // 6
+    template<typename U, typename E>
+        requires (std::is_convertible_v<typename unique_ptr<U, E>::pointer, pointer> && !std::is_array_v<U>
+            && (std::is_reference_v<Deleter> ? std::is_same_v<E, Deleter> : std::is_convertible_v<E, Deleter>))
+    unique_ptr(unique_ptr<U, E>&& other) noexcept
+        : ptr(other.release())
+        , deleter(std::forward<E>(other.deleter))
+    {
+    }
+    unique_ptr(const unique_ptr&) = delete;
+    // destructor
+    ~unique_ptr()
+    {
+        if (ptr)
+        {
+            deleter(ptr);
+        }
+    }
+    // assignment
+    unique_ptr& operator=(unique_ptr&& other) noexcept
+    {
+        reset(other.release());
+        deleter = std::forward<Deleter>(other.deleter);
+        return *this;
+    }
+    template<typename U, typename E>
+        requires (std::is_convertible_v<typename unique_ptr<U, E>::pointer, pointer> && !std::is_array_v<U>
+            && std::is_assignable_v<Deleter&, E&&>)
+    unique_ptr& operator=(unique_ptr<U, E>&& other) noexcept
+    {
+        reset(other.release());
+        deleter = std::forward<E>(other.deleter);
+        return *this;
+    }
+    unique_ptr& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+    unique_ptr& operator=(const unique_ptr&) = delete;
+    // modifiers
+    pointer release() noexcept
+    {
+        pointer p = ptr;
+        ptr = pointer();
+        return p;
+    }
+    void reset(pointer p = pointer()) noexcept
+    {
+        pointer old = ptr;
+        ptr = p;
+        if (old)
+        {
+            deleter(old);
+        }
+    }
+    void swap(unique_ptr& other) noexcept
+    {
+        using std::swap;
+        swap(ptr, other.ptr);
+        swap(deleter, other.deleter);
+    }
+    // observers
+    pointer get() const noexcept
+    {
+        return ptr;
+    }
+    Deleter& get_deleter() noexcept
+    {
+        return deleter;
+    }
+    const Deleter& get_deleter() const noexcept
+    {
+        return deleter;
+    }
+    explicit operator bool() const noexcept
+    {
+        return ptr != pointer();
+    }
+    std::add_lvalue_reference_t<T> operator*() const
+    {
+        return *ptr;
+    }
+    pointer operator->() const noexcept
+    {
+        return ptr;
+    }
+};
+
+// unique_ptr of array
+template<typename T, typename Deleter>
+class unique_ptr<T[], Deleter>
+{
+    template<typename U, typename E> friend class unique_ptr;
+public:
+    using pointer = impl::unique_ptr_pointer_t<T, Deleter>;
+    using element_type = T;
+    using deleter_type = Deleter;
+private:
+    pointer ptr;
+    [[no_unique_address]] Deleter deleter;
+    // U could be pointer, nullptr_t, or U* where U(*)[] is convertible to T(*)[] when pointer is T*
+    template<typename U>
+    inline constexpr static bool is_acceptable_pointer_v = std::is_same_v<U, pointer> || std::is_same_v<U, std::nullptr_t>
+        || (std::is_same_v<pointer, T*> && std::is_pointer_v<U>
+            && std::is_convertible_v<std::remove_pointer_t<U>(*)[], T(*)[]>);
+public:
+    // constructors
+    constexpr unique_ptr() noexcept requires (std::is_default_constructible_v<Deleter> && !std::is_pointer_v<Deleter>)
+        : ptr()
+        , deleter()
+    {
+    }
+    constexpr unique_ptr(std::nullptr_t) noexcept requires (std::is_default_constructible_v<Deleter> && !std::is_pointer_v<Deleter>)
+        : ptr()
+        , deleter()
+    {
+    }
+    template<typename U>
+        requires (is_acceptable_pointer_v<U> && std::is_default_constructible_v<Deleter> && !std::is_pointer_v<Deleter>)
+    explicit unique_ptr(U p) noexcept
+        : ptr(p)
+        , deleter()
+    {
+    }
+    template<typename U>
+        requires (is_acceptable_pointer_v<U> && !std::is_reference_v<Deleter>)
+    unique_ptr(U p, const Deleter& d) noexcept
+        : ptr(p)
+        , deleter(d)
+    {
+    }
+    template<typename U>
+        requires (is_acceptable_pointer_v<U> && !std::is_reference_v<Deleter>)
+    unique_ptr(U p, Deleter&& d) noexcept
+        : ptr(p)
+        , deleter(std::move(d))
+    {
+    }
+    template<typename U>
+        requires (is_acceptable_pointer_v<U> && std::is_reference_v<Deleter>)
+    unique_ptr(U p, Deleter d) noexcept
+        : ptr(p)
+        , deleter(d)
+    {
+    }
+    unique_ptr(unique_ptr&& other) noexcept
+        : ptr(other.release())
+        , deleter(std::forward<Deleter>(other.deleter))
+    {
+    }
+    unique_ptr(const unique_ptr&) = delete;
+    // destructor
+    ~unique_ptr()
+    {
+        if (ptr)
+        {
+            deleter(ptr);
+        }
+    }
+    // assignment
+    unique_ptr& operator=(unique_ptr&& other) noexcept
+    {
+        reset(other.release());
+        deleter = std::forward<Deleter>(other.deleter);
+        return *this;
+    }
+    unique_ptr& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+    unique_ptr& operator=(const unique_ptr&) = delete;
+    // modifiers
+    pointer release() noexcept
+    {
+        pointer p = ptr;
+        ptr = pointer();
+        return p;
+    }
+    template<typename U>
+        requires is_acceptable_pointer_v<U>
+    void reset(U p) noexcept
+    {
+        pointer old = ptr;
+        ptr = p;
+        if (old)
+        {
+            deleter(old);
+        }
+    }
+    void reset(std::nullptr_t = nullptr) noexcept
+    {
+        reset(pointer());
+    }
+    void swap(unique_ptr& other) noexcept
+    {
+        using std::swap;
+        swap(ptr, other.ptr);
+        swap(deleter, other.deleter);
+    }
+    // observers
+    pointer get() const noexcept
+    {
+        return ptr;
+    }
+    Deleter& get_deleter() noexcept
+    {
+        return deleter;
+    }
+    const Deleter& get_deleter() const noexcept
+    {
+        return deleter;
+    }
+    explicit operator bool() const noexcept
+    {
+        return ptr != pointer();
+    }
+    T& operator[](std::size_t i) const
+    {
+        return ptr[i];
+    }
+};
+
+// make_unique
+template<typename T, typename... Args>
+    requires (!std::is_array_v<T>)
+unique_ptr<T> make_unique(Args&&... args)
+{
+    return unique_ptr<T>(new T(std::forward<Args>(args)...));
+}
+template<typename T>
+    requires std::is_unbounded_array_v<T>
+unique_ptr<T> make_unique(std::size_t n)
+{
+    return unique_ptr<T>(new std::remove_extent_t<T>[n]());
+}
+template<typename T, typename... Args>
+    requires std::is_bounded_array_v<T>
+void make_unique(Args&&... args) = delete;
+
+// no value initialization
+template<typename T>
+    requires (!std::is_array_v<T>)
+unique_ptr<T> make_unique_for_overwrite()
+{
+    return unique_ptr<T>(new T);
+}
+template<typename T>
+    requires std::is_unbounded_array_v<T>
+unique_ptr<T> make_unique_for_overwrite(std::size_t n)
+{
+    return unique_ptr<T>(new std::remove_extent_t<T>[n]);
+}
+template<typename T, typename... Args>
+    requires std::is_bounded_array_v<T>
+void make_unique_for_overwrite(Args&&... args) = delete;
+
+// non-member operations
+template<typename T, typename D>
+    requires std::is_swappable_v<D>
+void swap(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template<typename T1, typename D1, typename T2, typename D2>
+bool operator==(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+{
+    return lhs.get() == rhs.get();
+}
+template<typename T1, typename D1, typename T2, typename D2>
+bool operator<(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+{
+    using CT = std::common_type_t<typename unique_ptr<T1, D1>::pointer, typename unique_ptr<T2, D2>::pointer>;
+    return std::less<CT>()(lhs.get(), rhs.get());
+}
+template<typename T1, typename D1, typename T2, typename D2>
+bool operator<=(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+{
+    return !(rhs < lhs);
+}
+template<typename T1, typename D1, typename T2, typename D2>
+bool operator>(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+{
+    return rhs < lhs;
+}
+template<typename T1, typename D1, typename T2, typename D2>
+bool operator>=(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs)
+{
+    return !(lhs < rhs);
+}
+template<typename T, typename D>
+bool operator==(const unique_ptr<T, D>& lhs, std::nullptr_t) noexcept
+{
+    return !lhs;
+}
+template<typename T, typename D>
+bool operator<(const unique_ptr<T, D>& lhs, std::nullptr_t)
+{
+    return std::less<typename unique_ptr<T, D>::pointer>()(lhs.get(), nullptr);
+}
+template<typename T, typename D>
+bool operator<(std::nullptr_t, const unique_ptr<T, D>& rhs)
+{
+    return std::less<typename unique_ptr<T, D>::pointer>()(nullptr, rhs.get());
+}
+template<typename T, typename D>
+bool operator<=(const unique_ptr<T, D>& lhs, std::nullptr_t)
+{
+    return !(nullptr < lhs);
+}
+template<typename T, typename D>
+bool operator<=(std::nullptr_t, const unique_ptr<T, D>& rhs)
+{
+    return !(rhs < nullptr);
+}
+template<typename T, typename D>
+bool operator>(const unique_ptr<T, D>& lhs, std::nullptr_t)
+{
+    return nullptr < lhs;
+}
+template<typename T, typename D>
+bool operator>(std::nullptr_t, const unique_ptr<T, D>& rhs)
+{
+    return rhs < nullptr;
+}
+template<typename T, typename D>
+bool operator>=(const unique_ptr<T, D>& lhs, std::nullptr_t)
+{
+    return !(lhs < nullptr);
+}
+template<typename T, typename D>
+bool operator>=(std::nullptr_t, const unique_ptr<T, D>& rhs)
+{
+    return !(nullptr < rhs);
+}
+
+template<typename CharT, typename Traits, typename T, typename D>
+std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const unique_ptr<T, D>& p)
+{
+    return os << p.get();
+}
+
+} // namespace tstd
+
+template<typename T, typename D>
+struct std::hash<tstd::unique_ptr<T, D>>
+{
+    std::size_t operator()(const tstd::unique_ptr<T, D>& p) const
+    {
+        return std::hash<typename tstd::unique_ptr<T, D>::pointer>()(p.get());
+    }
+};
+
+#endif // TSTL_UNIQUE_PTR_HPP
@@ -9,6 +9,7 @@
 #include <stdexcept>
 #include <tuple>
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <tstl_hashtable.hpp>
 #include <tutility.hpp>
 #include <titerator.hpp>
@@ -553,6 +554,12 @@ void swap(tstd::unordered_map<Key, T, Hash, KeyEqual, Allocator, UnderlyingHashT
     lhs.swap(rhs);
 }
 
+namespace pmr
+{
+template<typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+using unordered_map = tstd::unordered_map<Key, T, Hash, KeyEqual, polymorphic_allocator<std::pair<const Key, T>>>;
+} // namespace pmr
+
 } // namespace tstd
 
 
@@ -7,6 +7,7 @@
 #include <type_traits>
 #include <utility>
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <tstl_hashtable.hpp>
 #include <tutility.hpp>
 #include <titerator.hpp>
@@ -436,6 +437,12 @@ void swap(tstd::unordered_multimap<Key, T, Hash, KeyEqual, Allocator, Underlying
     lhs.swap(rhs);
 }
 
+namespace pmr
+{
+template<typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+using unordered_multimap = tstd::unordered_multimap<Key, T, Hash, KeyEqual, polymorphic_allocator<std::pair<const Key, T>>>;
+} // namespace pmr
+
 } // namespace tstd
 
 
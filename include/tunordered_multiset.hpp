@@ -7,6 +7,7 @@
 #include <type_traits>
 #include <utility>
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <tstl_hashtable.hpp>
 #include <tutility.hpp>
 #include <titerator.hpp>
@@ -419,6 +420,12 @@ void swap(tstd::unordered_multiset<Key, Hash, KeyEqual, Allocator, UnderlyingHas
     lhs.swap(rhs);
 }
 
+namespace pmr
+{
+template<typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+using unordered_multiset = tstd::unordered_multiset<Key, Hash, KeyEqual, polymorphic_allocator<Key>>;
+} // namespace pmr
+
 } // namespace tstd
 
 
@@ -7,6 +7,7 @@
 #include <type_traits>
 #include <utility>
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <tstl_hashtable.hpp>
 #include <tutility.hpp>
 #include <titerator.hpp>
@@ -421,6 +422,12 @@ void swap(tstd::unordered_set<Key, Hash, KeyEqual, Allocator, UnderlyingHashTabl
     lhs.swap(rhs);
 }
 
+namespace pmr
+{
+template<typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+using unordered_set = tstd::unordered_set<Key, Hash, KeyEqual, polymorphic_allocator<Key>>;
+} // namespace pmr
+
 } // namespace tstd
 
 
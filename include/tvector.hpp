@@ -2,6 +2,7 @@
 #define TVECTOR_HPP
 
 #include <tstl_allocator.hpp>
+#include <tmemory_resource.hpp>
 #include <tstl_uninitialized.hpp>
 #include <titerator.hpp>
 #include <tutility.hpp>
@@ -9,15 +10,97 @@
 #include <initializer_list>
 #include <cstddef>
 #include <type_traits>
+#include <concepts>
 #include <numeric>
 #include <stdexcept> // for std::out_of_range
 #include <iterator>
 #include <cassert>
+#include <limits>
 
 namespace tstd
 {
 
-template<typename T, typename Allocator = tstd::allocator<T>>
+// growth policies of tstd::vector.
+// grow(capacity, required, element_size) returns the new capacity (at least required) when growing from capacity,
+// shrink(capacity, size, element_size) returns the capacity to shrink to after erase/clear/pop_back/resize,
+// returning capacity means no shrink. User-defined policies provide the same two static functions.
+template<typename Policy>
+concept vector_growth_policy = requires(std::size_t n) {
+    { Policy::grow(n, n, n) } -> std::convertible_to<std::size_t>;
+    { Policy::shrink(n, n, n) } -> std::convertible_to<std::size_t>;
+};
+
+// double the capacity, default policy
+struct vector_growth_2x
+{
+    static constexpr std::size_t grow(std::size_t capacity, std::size_t required, [[maybe_unused]] std::size_t element_size) noexcept
+    {
+        std::size_t new_cap = 2 * capacity;
+        return new_cap > required ? new_cap : (required > 0 ? required : 1);
+    }
+    static constexpr std::size_t shrink(std::size_t capacity, [[maybe_unused]] std::size_t size, [[maybe_unused]] std::size_t element_size) noexcept
+    {
+        return capacity;
+    }
+};
+
+// grow by 1.5x: more reallocations, less unused capacity, and freed blocks could be reused by later growth
+struct vector_growth_1_5x
+{
+    static constexpr std::size_t grow(std::size_t capacity, std::size_t required, [[maybe_unused]] std::size_t element_size) noexcept
+    {
+        std::size_t new_cap = capacity + capacity / 2;
+        return new_cap > required ? new_cap : (required > 0 ? required : 1);
+    }
+    static constexpr std::size_t shrink(std::size_t capacity, [[maybe_unused]] std::size_t size, [[maybe_unused]] std::size_t element_size) noexcept
+    {
+        return capacity;
+    }
+};
+
+// double the capacity, and round storage of at least one page up to whole pages,
+// which fits allocators mapping pages directly (e.g. tstd::mmap_allocator).
+template<std::size_t PageSize = 4096>
+struct vector_growth_page
+{
+    static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "PageSize must be a power of 2");
+    static constexpr std::size_t grow(std::size_t capacity, std::size_t required, std::size_t element_size) noexcept
+    {
+        std::size_t new_cap = vector_growth_2x::grow(capacity, required, element_size);
+        std::size_t bytes = new_cap * element_size;
+        if (bytes >= PageSize)
+        {
+            new_cap = ((bytes + PageSize - 1) & ~(PageSize - 1)) / element_size;
+        }
+        return new_cap;
+    }
+    static constexpr std::size_t shrink(std::size_t capacity, [[maybe_unused]] std::size_t size, [[maybe_unused]] std::size_t element_size) noexcept
+    {
+        return capacity;
+    }
+};
+
+// grow by Growth, and give memory back when size falls below 1/Ratio of capacity and the storage takes at least
+// MinBytes: capacity shrinks to 2 * size (0 after clear). The gap between growth and shrinking keeps both amortized O(1).
+template<typename Growth = vector_growth_2x, std::size_t Ratio = 4, std::size_t MinBytes = 4096>
+struct vector_auto_shrink
+{
+    static_assert(Ratio > 2, "shrinking to 2 * size must not be followed by another shrink immediately");
+    static constexpr std::size_t grow(std::size_t capacity, std::size_t required, std::size_t element_size) noexcept
+    {
+        return Growth::grow(capacity, required, element_size);
+    }
+    static constexpr std::size_t shrink(std::size_t capacity, std::size_t size, std::size_t element_size) noexcept
+    {
+        if (capacity * element_size >= MinBytes && size * Ratio < capacity)
+        {
+            return 2 * size;
+        }
+        return capacity;
+    }
+};
+
+template<typename T, typename Allocator = tstd::allocator<T>, vector_growth_policy Growth = vector_growth_2x>
 class vector
 {
 public:
@@ -33,6 +116,7 @@ public:
     using const_iterator = const T*;
     using reverse_iterator = tstd::reverse_iterator<iterator>;
     using const_reverse_iterator = tstd::reverse_iterator<const_iterator>;
+    using growth_policy = Growth;
 public:
     // constructors
     constexpr vector() noexcept(noexcept(Allocator())) // 1
@@ -55,7 +139,7 @@ public:
         , finish(nullptr)
         , end_of_storage(nullptr)
     {
-        start = alloc.allocate(count * sizeof(T));
+        start = alloc.allocate(count);
         finish = end_of_storage = start + count;
         tstd::uninitialized_fill_n(start, count, value);
     }
@@ -65,7 +149,7 @@ public:
         , finish(nullptr)
         , end_of_storage(nullptr)
     {
-        start = alloc.allocate(count * sizeof(T));
+        start = alloc.allocate(count);
         finish = end_of_storage = start + count;
         tstd::uninitialized_fill_n(start, count, T());
     }
@@ -79,20 +163,34 @@ public:
         , finish(nullptr)
         , end_of_storage(nullptr)
     {
-        for (auto iter = first; iter != last; ++iter)
+        if constexpr (tstd::is_forward_iterator_v<InputIterator>)
+        {
+            // size is known, allocate only once
+            size_type count = static_cast<size_type>(tstd::distance(first, last));
+            if (count > 0)
+            {
+                start = alloc.allocate(count);
+                finish = end_of_storage = start + count;
+                tstd::uninitialized_copy_n(first, count, start);
+            }
+        }
+        else
         {
-            push_back(*iter);
+            for (; first != last; ++first)
+            {
+                push_back(*first);
+            }
         }
     }
     constexpr vector(const vector& other) // 6
-        : alloc(other.alloc)
+        : alloc(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc))
         , start(nullptr)
         , finish(nullptr)
         , end_of_storage(nullptr)
     {
         if (other.size() > 0)
         {
-            start = alloc.allocate(other.size() * sizeof(T));
+            start = alloc.allocate(other.size());
             finish = end_of_storage = start + other.size();
             tstd::uninitialized_copy(other.begin(), other.end(), start);
         }
@@ -105,7 +203,7 @@ public:
     {
         if (other.size() > 0)
         {
-            start = alloc.allocate(other.size() * sizeof(T));
+            start = alloc.allocate(other.size());
             finish = end_of_storage = start + other.size();
             tstd::uninitialized_copy(other.begin(), other.end(), start);
         }
@@ -138,8 +236,10 @@ public:
         {
             if (other.size() > 0)
             {
-                start = alloc.allocate(other.size() * sizeof(T));
+                start = alloc.allocate(other.size());
+                finish = end_of_storage = start + other.size();
                 tstd::uninitialized_move(other.begin(), other.end(), start);
+                other.clear();
             }
         }
     }
@@ -151,7 +251,7 @@ public:
     {
         if (il.size() > 0)
         {
-            start = alloc.allocate(il.size() * sizeof(T));
+            start = alloc.allocate(il.size());
             finish = end_of_storage = start + il.size();
             tstd::uninitialized_copy(il.begin(), il.end(), start);
         }
@@ -174,20 +274,28 @@ public:
         else
         {
             free_all_spaces();
-            start = alloc.allocate(rhs.size() * sizeof(T));
+            start = alloc.allocate(rhs.size());
             tstd::uninitialized_copy(rhs.begin(), rhs.end(), start);
             finish = end_of_storage = start + rhs.size();
         }
         return *this;
     }
-    constexpr vector& operator=(vector&& rhs) noexcept // 2
+    constexpr vector& operator=(vector&& rhs) noexcept(std::allocator_traits<Allocator>::is_always_equal::value) // 2
     {
         clear();
-        free_all_spaces();
-        start = rhs.start;
-        finish = rhs.finish;
-        end_of_storage = rhs.end_of_storage;
-        rhs.start = rhs.finish = rhs.end_of_storage = nullptr;
+        if (alloc == rhs.alloc) // take over the whole buffer
+        {
+            free_all_spaces();
+            start = rhs.start;
+            finish = rhs.finish;
+            end_of_storage = rhs.end_of_storage;
+            rhs.start = rhs.finish = rhs.end_of_storage = nullptr;
+        }
+        else // buffer of rhs could not be freed by alloc, move every element
+        {
+            assign(tstd::make_move_iterator(rhs.begin()), tstd::make_move_iterator(rhs.end()));
+            rhs.clear();
+        }
         return *this;
     }
     constexpr vector& operator=(std::initializer_list<T> il) // 3
@@ -207,7 +315,7 @@ public:
         else
         {
             free_all_spaces();
-            start = alloc.allocate(count * sizeof(T));
+            start = alloc.allocate(count);
             tstd::uninitialized_fill_n(start, count, value);
             finish = end_of_storage = start + count;
         }
@@ -216,11 +324,29 @@ public:
         typename = std::enable_if_t<std::is_base_of_v<typename std::input_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>>>
     constexpr void assign(InputIterator first, InputIterator last) // 2
     {
-        clear();
-        free_all_spaces();
-        for (; first != last; ++first)
+        erase_range(start, finish);
+        finish = start;
+        if constexpr (tstd::is_forward_iterator_v<InputIterator>)
         {
-            push_back(*first);
+            // reuse the storage if possible, otherwise allocate only once
+            size_type count = static_cast<size_type>(tstd::distance(first, last));
+            if (count > capacity())
+            {
+                free_all_spaces();
+                auto result = impl::_allocate_at_least(alloc, count);
+                start = finish = result.ptr;
+                end_of_storage = start + result.count;
+            }
+            finish = tstd::uninitialized_copy_n(first, count, start);
+            shrink_if_needed();
+        }
+        else
+        {
+            for (; first != last; ++first)
+            {
+                push_back(*first);
+            }
+            shrink_if_needed();
         }
     }
     constexpr void assign(std::initializer_list<T> il)
@@ -234,7 +360,7 @@ public:
         else
         {
             free_all_spaces();
-            start = alloc.allocate(il.size() * sizeof(T));
+            start = alloc.allocate(il.size());
             tstd::uninitialized_copy(il.begin(), il.end(), start);
             finish = end_of_storage = start + il.size();
         }
@@ -370,11 +496,7 @@ public:
     {
         if (new_cap > capacity())
         {
-            if (new_cap < 2 * capacity())
-            {
-                new_cap = 2 * capacity();
-            }
-            adjust_capacity(new_cap);
+            grow(new_cap);
         }
     }
     constexpr size_type capacity() const noexcept
@@ -383,10 +505,16 @@ public:
     }
     constexpr void shrink_to_fit()
     {
-        // do shrink only when capacity > 2*size(), just a choice of implementation, no sepcial meaning
-        if (capacity() > 2 * size())
+        if (capacity() > size())
         {
-            adjust_capacity(size());
+            if (empty())
+            {
+                free_all_spaces();
+            }
+            else
+            {
+                reallocate(size());
+            }
         }
     }
 
@@ -395,26 +523,37 @@ public:
     {
         erase_range(start, finish);
         finish = start;
+        if (Growth::shrink(capacity(), 0, sizeof(T)) < capacity())
+        {
+            free_all_spaces(); // give the whole storage back
+        }
     }
     constexpr iterator insert(const_iterator pos, const T& value) // 1
     {
-        size_type idx = (size_type)(pos - start);
-        move_backward(idx, 1);
-        *(start + idx) = value;
-        return start + idx;
+        return emplace(pos, value);
     }
     constexpr iterator insert(const_iterator pos, T&& value) // 2
     {
         size_type idx = (size_type)(pos - start);
-        move_backward(idx, 1);
-        *(start + idx) = std::move(value);
+        insert_gap(idx, 1, [&](T* gap) { alloc.construct(gap, std::move(value)); });
         return start + idx;
     }
     constexpr iterator insert(const_iterator pos, size_type count, const T& value) // 3
     {
         size_type idx = (size_type)(pos - start);
-        move_backward(idx, count);
-        fill_range(start + idx, start + idx + count, value);
+        if (count > 0)
+        {
+            if (moves_before_construct(idx, count))
+            {
+                // value may refer to an element, which is moved before the gap is filled
+                T copy(value);
+                insert_gap(idx, count, [&](T* gap) { tstd::uninitialized_fill(gap, gap + count, copy); });
+            }
+            else
+            {
+                insert_gap(idx, count, [&](T* gap) { tstd::uninitialized_fill(gap, gap + count, value); });
+            }
+        }
         return start + idx;
     }
     template<typename InputIterator, 
@@ -422,8 +561,25 @@ public:
     constexpr iterator insert(const_iterator pos, InputIterator first, InputIterator last) // 4
     {
         size_type idx = (size_type)(pos - start);
-        move_backward(idx, last - first);
-        copy_range(first, last, start + idx);
+        if constexpr (tstd::is_forward_iterator_v<InputIterator>)
+        {
+            // open the gap with at most one reallocation, then copy the range into it
+            size_type count = static_cast<size_type>(tstd::distance(first, last));
+            if (count > 0)
+            {
+                insert_gap(idx, count, [&](T* gap) { tstd::uninitialized_copy_n(first, count, gap); });
+            }
+        }
+        else
+        {
+            // size is unknown, append then rotate into place
+            size_type old_size = size();
+            for (; first != last; ++first)
+            {
+                push_back(*first);
+            }
+            tstd::rotate(start + idx, start + old_size, finish);
+        }
         return start + idx;
     }
     constexpr iterator insert(const_iterator pos, std::initializer_list<T> il) // 5
@@ -431,8 +587,7 @@ public:
         size_type idx = (size_type)(pos - start);
         if (il.size() > 0)
         {
-            move_backward(idx, il.size());
-            copy_range(il.begin(), il.end(), start + idx);
+            insert_gap(idx, il.size(), [&](T* gap) { tstd::uninitialized_copy(il.begin(), il.end(), gap); });
         }
         return start + idx;
     }
@@ -440,25 +595,37 @@ public:
     constexpr iterator emplace(const_iterator pos, Args&&... args)
     {
         size_type idx = (size_type)(pos - start);
-        move_backward(idx, 1);
-        alloc.construct(start + idx, std::forward<Args>(args)...);
+        if (moves_before_construct(idx, 1))
+        {
+            // args may refer to an element, which is moved before the gap is constructed
+            T tmp(std::forward<Args>(args)...);
+            insert_gap(idx, 1, [&](T* gap) { alloc.construct(gap, std::move(tmp)); });
+        }
+        else
+        {
+            insert_gap(idx, 1, [&](T* gap) { alloc.construct(gap, std::forward<Args>(args)...); });
+        }
         return start + idx;
     }
     constexpr iterator erase(const_iterator pos) // 1
     {
+        size_type idx = (size_type)(pos - start);
         move_forward(pos + 1, 1);
-        return (iterator)pos;
+        shrink_if_needed();
+        return start + idx;
     }
     constexpr iterator erase(const_iterator first, const_iterator last) // 2
     {
+        size_type idx = (size_type)(first - start);
         move_forward(last, last - first);
-        return (iterator)first;
+        shrink_if_needed();
+        return start + idx;
     }
     constexpr void push_back(const T& value) // 1
     {
         if (size() == capacity())
         {
-            adjust_capacity(); // default ajust to double of size()
+            grow(size() + 1);
         }
         alloc.construct(finish, value);
         ++finish;
@@ -467,7 +634,7 @@ public:
     {
         if (size() == capacity())
         {
-            adjust_capacity();
+            grow(size() + 1);
         }
         alloc.construct(finish, std::forward<T>(value));
         ++finish;
@@ -477,17 +644,39 @@ public:
     {
         if (size() == capacity())
         {
-            adjust_capacity();
+            grow(size() + 1);
         }
         alloc.construct(finish, std::forward<Args>(args)...);
         ++finish;
-        return *finish;
+        return *(finish - 1);
+    }
+    // non-standard: append without checking capacity, size() < capacity() is required (e.g. after reserve)
+    constexpr void push_back_unchecked(const T& value) // 1
+    {
+        assert(finish != end_of_storage);
+        alloc.construct(finish, value);
+        ++finish;
+    }
+    constexpr void push_back_unchecked(T&& value) // 2
+    {
+        assert(finish != end_of_storage);
+        alloc.construct(finish, std::move(value));
+        ++finish;
+    }
+    template<typename... Args>
+    constexpr reference emplace_back_unchecked(Args&&... args)
+    {
+        assert(finish != end_of_storage);
+        alloc.construct(finish, std::forward<Args>(args)...);
+        ++finish;
+        return *(finish - 1);
     }
     constexpr void pop_back()
     {
         assert(!empty());
         alloc.destroy(finish - 1);
         --finish;
+        shrink_if_needed();
     }
     constexpr void resize(size_type count) // 1
     {
@@ -499,6 +688,7 @@ public:
         {
             erase_range(start + count, finish);
             finish = start + count;
+            shrink_if_needed();
         }
         else if (count <= capacity()) // count > size()
         {
@@ -507,7 +697,7 @@ public:
         }
         else // count > capacity()
         {
-            adjust_capacity(count);
+            grow(count);
             tstd::uninitialized_fill(finish, start + count, T());
             finish = start + count;
         }
@@ -522,6 +712,7 @@ public:
         {
             erase_range(start + count, finish);
             finish = start + count;
+            shrink_if_needed();
         }
         else if (count <= capacity()) // count > size()
         {
@@ -530,11 +721,27 @@ public:
         }
         else // count > capacity()
         {
-            adjust_capacity(count);
+            grow(count);
             tstd::uninitialized_fill(finish, start + count, value);
             finish = start + count;
         }
     }
+    // non-standard: like resize, but new elements are default-initialized, which leaves trivial types (char, float, ...)
+    // uninitialized. for buffers that will be overwritten anyway.
+    constexpr void resize_for_overwrite(size_type count)
+    {
+        if (count <= size())
+        {
+            resize(count);
+            return;
+        }
+        if (count > capacity())
+        {
+            grow(count);
+        }
+        tstd::uninitialized_default_construct(finish, start + count);
+        finish = start + count;
+    }
     constexpr void swap(vector& other) noexcept(std::allocator_traits<Allocator>::propagate_on_container_swap::value || std::allocator_traits<Allocator>::is_always_equal::value)
     {
         tstd::swap(alloc, other.alloc);
@@ -544,14 +751,6 @@ public:
     }
 private:
     // auxiliary functions
-    template<typename InputIterator>
-    void copy_range(InputIterator first, InputIterator last, iterator dest)
-    {
-        for (; first != last; ++first, ++dest)
-        {
-            *dest = *first;
-        }
-    }
     // move from front to back
     void move_range(const_iterator first, const_iterator last, iterator dest)
     {
@@ -560,24 +759,6 @@ private:
             *dest = std::move(*first);
         }
     }
-    // move from back to front
-    void move_range_from_back_to_front(const_iterator first, const_iterator last, iterator dest)
-    {
-        auto count = last - first;
-        auto rfirst = make_reverse_iterator(first);
-        auto iter = make_reverse_iterator(last);
-        for (auto rdest = make_reverse_iterator(dest + count); iter != rfirst; ++iter, ++rdest)
-        {
-            *rdest = std::move(*iter);
-        }
-    }
-    void fill_range(iterator first, iterator last, const T& value)
-    {
-        for (auto dest = first; dest != last; ++dest)
-        {
-            *dest = value;
-        }
-    }
     // destroy a range of elements in reverse order.
     void erase_range(iterator first, iterator last)
     {
@@ -595,43 +776,137 @@ private:
         }
         start = finish = end_of_storage = nullptr;
     }
-    // adjust capacity: less or more, reserve, shrink_to_fit, etc
-    // new_cap must greater than or equal to size(), default adjust to double of current size()
-    void adjust_capacity(size_type new_cap = 0)
+    // grow capacity to hold at least required elements by the growth policy
+    void grow(size_type required)
+    {
+        reallocate(Growth::grow(capacity(), required, sizeof(T)));
+    }
+    // shrink capacity by the growth policy after erasing elements
+    void shrink_if_needed()
     {
-        if (new_cap <= size())
+        size_type new_cap = Growth::shrink(capacity(), size(), sizeof(T));
+        if (new_cap < capacity())
         {
-            new_cap = 2 * size();
-            new_cap = new_cap > 0 ? new_cap : 1; // make sure at least for 1 elements
+            if (new_cap == 0 && empty())
+            {
+                free_all_spaces();
+            }
+            else
+            {
+                reallocate(tstd::max(new_cap, size()));
+            }
         }
-        T* new_start = alloc.allocate(new_cap * sizeof(T));
-        T* new_finish = new_start + size();
-        T* new_end_of_storage = new_start + new_cap;
-        tstd::uninitialized_move(start, finish, new_start);
-        clear();
+    }
+    // reallocate storage for at least new_cap elements, new_cap must be greater than or equal to size()
+    void reallocate(size_type new_cap)
+    {
+        if constexpr (impl::has_try_reallocate_v<Allocator> && tstd::is_trivially_relocatable_v<T>)
+        {
+            // resize in place (or move pages) without copying elements
+            if (start)
+            {
+                size_type count = size();
+                if (T* p = alloc.try_reallocate(start, capacity(), new_cap))
+                {
+                    start = p;
+                    finish = p + count;
+                    end_of_storage = p + new_cap;
+                    return;
+                }
+            }
+        }
+        // adopt the real size of the block, the slack is used by later growth
+        auto result = impl::_allocate_at_least(alloc, new_cap);
+        T* new_start = result.ptr;
+        T* new_end_of_storage = new_start + result.count;
+        T* new_finish = impl::_relocate(start, finish, new_start); // elements are moved and destroyed in one pass
         free_all_spaces();
         start = new_start;
         finish = new_finish;
         end_of_storage = new_end_of_storage;
     }
-    // move elements after(include) idx backward specific location.
-    // do the copy(move if possible), and ajust capacity if necessary
-    // for insert
-    void move_backward(size_type idx, size_type count)
+    // whether inserting count elements at idx moves elements before the new ones are constructed:
+    // the tail is shifted in place, or the storage grows by grow() when appending.
+    bool moves_before_construct(size_type idx, size_type count) const noexcept
     {
-        while (size() + count > capacity())
+        return (idx < size()) == (size() + count <= capacity());
+    }
+    // open a gap of count elements at idx and construct them by construct(gap), adjust capacity if necessary.
+    // construct must destroy what it has constructed before throwing, then the vector keeps its elements.
+    // when the storage is reallocated, the gap is constructed before old elements are relocated, so it could copy them,
+    // see moves_before_construct for other cases.
+    template<typename Construct>
+    void insert_gap(size_type idx, size_type count, Construct construct)
+    {
+        if (idx == size())
+        {
+            // appending, the storage may be resized in place by grow(), and nothing is shifted
+            if (size() + count > capacity())
+            {
+                grow(size() + count);
+            }
+            construct(finish);
+            finish += count;
+            return;
+        }
+        if (size() + count > capacity())
+        {
+            // relocate the head and the tail into new storage around the gap, every element is moved only once
+            auto result = impl::_allocate_at_least(alloc, Growth::grow(capacity(), size() + count, sizeof(T)));
+            T* new_start = result.ptr;
+            try
+            {
+                construct(new_start + idx);
+            }
+            catch (...)
+            {
+                alloc.deallocate(new_start, result.count);
+                throw;
+            }
+            impl::_relocate(start, start + idx, new_start);
+            T* new_finish = impl::_relocate(start + idx, finish, new_start + idx + count);
+            free_all_spaces();
+            start = new_start;
+            finish = new_finish;
+            end_of_storage = new_start + result.count;
+            return;
+        }
+        if constexpr (tstd::is_trivially_relocatable_v<T>)
         {
-            adjust_capacity(tstd::max(2*size(), size() + count));
+            // relocate the tail as a whole
+            impl::_memmove_n(start + idx, size() - idx, start + idx + count);
         }
-        if (idx + count >= size())
+        else
         {
-            tstd::uninitialized_copy(start + idx, finish, start + idx + count);
+            // relocate the tail one by one from back to front
+            for (iterator iter = finish; iter != start + idx;)
+            {
+                --iter;
+                alloc.construct(iter + count, std::move(*iter));
+                alloc.destroy(iter);
+            }
         }
-        else // idx + count < size()
+        // finish is only advanced after the gap is constructed, the vector never holds raw slots
+        try
         {
-            tstd::uninitialized_copy(finish - count, finish, finish);
-            // move elements from back to front
-            move_range_from_back_to_front(start + idx, finish - count, start + idx + count);
+            construct(start + idx);
+        }
+        catch (...)
+        {
+            // shift the tail back
+            if constexpr (tstd::is_trivially_relocatable_v<T>)
+            {
+                impl::_memmove_n(start + idx + count, size() - idx, start + idx);
+            }
+            else
+            {
+                for (iterator iter = start + idx; iter != finish; ++iter)
+                {
+                    alloc.construct(iter, std::move(*(iter + count)));
+                    alloc.destroy(iter + count);
+                }
+            }
+            throw;
         }
         finish += count;
     }
@@ -639,8 +914,17 @@ private:
     // called after erasing
     void move_forward(const_iterator first, size_type count)
     {
-        move_range(first, finish, (iterator)(first - count));
-        erase_range(finish - count, finish);
+        if constexpr (tstd::is_trivially_relocatable_v<T>)
+        {
+            // destroy erased elements, then relocate the tail as a whole
+            erase_range((iterator)(first - count), (iterator)first);
+            impl::_memmove_n(first, finish - first, (iterator)(first - count));
+        }
+        else
+        {
+            move_range(first, finish, (iterator)(first - count));
+            erase_range(finish - count, finish);
+        }
         finish -= count;
     }
 private:
@@ -650,12 +934,537 @@ private:
     T* end_of_storage; // off the capacity
 };
 
+// vector<bool>: bits are packed into 64-bit words, elements are accessed through proxy references.
+// the growth policy works on words. count, find, find_first_of, fill, fill_n, copy and copy_backward in talgorithm.hpp
+// have word-at-a-time overloads for its iterators.
+template<typename Allocator, vector_growth_policy Growth>
+class vector<bool, Allocator, Growth>
+{
+private:
+    using word_type = impl::bit_word;
+    using word_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<word_type>;
+    inline constexpr static std::size_t word_bits = impl::bit_word_bits;
+public:
+    using value_type = bool;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = impl::bit_reference;
+    using const_reference = bool;
+    using iterator = impl::bit_iterator<false>;
+    using const_iterator = impl::bit_iterator<true>;
+    using pointer = iterator;
+    using const_pointer = const_iterator;
+    using reverse_iterator = tstd::reverse_iterator<iterator>;
+    using const_reverse_iterator = tstd::reverse_iterator<const_iterator>;
+    using growth_policy = Growth;
+public:
+    // constructors
+    constexpr vector() noexcept(noexcept(Allocator())) // 1
+        : alloc()
+        , start(nullptr)
+        , finish()
+        , end_of_storage(nullptr)
+    {
+    }
+    constexpr explicit vector(const Allocator& _alloc) noexcept // 2
+        : alloc(_alloc)
+        , start(nullptr)
+        , finish()
+        , end_of_storage(nullptr)
+    {
+    }
+    constexpr vector(size_type count, const bool& value, const Allocator& _alloc = Allocator()) // 3
+        : vector(_alloc)
+    {
+        assign(count, value);
+    }
+    constexpr explicit vector(size_type count, const Allocator& _alloc = Allocator()) // 4
+        : vector(_alloc)
+    {
+        assign(count, false);
+    }
+    template<typename InputIterator,
+        typename = std::enable_if_t<std::is_base_of_v<typename std::input_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>>>
+    constexpr vector(InputIterator first, InputIterator last, const Allocator& _alloc = Allocator()) // 5
+        : vector(_alloc)
+    {
+        assign(first, last);
+    }
+    constexpr vector(const vector& other) // 6
+        : vector(std::allocator_traits<word_allocator>::select_on_container_copy_construction(other.alloc))
+    {
+        assign(other.begin(), other.end());
+    }
+    constexpr vector(const vector& other, const Allocator& _alloc) // 7
+        : vector(_alloc)
+    {
+        assign(other.begin(), other.end());
+    }
+    constexpr vector(vector&& other) noexcept // 8
+        : alloc(std::move(other.alloc))
+        , start(other.start)
+        , finish(other.finish)
+        , end_of_storage(other.end_of_storage)
+    {
+        other.start = other.end_of_storage = nullptr;
+        other.finish = iterator();
+    }
+    constexpr vector(vector&& other, const Allocator& _alloc) // 9
+        : vector(_alloc)
+    {
+        if (alloc == other.alloc)
+        {
+            swap(other);
+        }
+        else
+        {
+            assign(other.begin(), other.end());
+            other.clear();
+        }
+    }
+    constexpr vector(std::initializer_list<bool> il, const Allocator& _alloc = Allocator()) // 10
+        : vector(_alloc)
+    {
+        assign(il.begin(), il.end());
+    }
+    // destructor
+    constexpr ~vector()
+    {
+        free_all_spaces();
+    }
+    // operator =
+    constexpr vector& operator=(const vector& rhs) // 1
+    {
+        if (this != &rhs)
+        {
+            assign(rhs.begin(), rhs.end());
+        }
+        return *this;
+    }
+    constexpr vector& operator=(vector&& rhs) noexcept(std::allocator_traits<Allocator>::is_always_equal::value) // 2
+    {
+        if (alloc == rhs.alloc) // take over the whole buffer
+        {
+            free_all_spaces();
+            swap(rhs);
+        }
+        else
+        {
+            assign(rhs.begin(), rhs.end());
+            rhs.clear();
+        }
+        return *this;
+    }
+    constexpr vector& operator=(std::initializer_list<bool> il) // 3
+    {
+        assign(il.begin(), il.end());
+        return *this;
+    }
+    // assign
+    constexpr void assign(size_type count, const bool& value) // 1
+    {
+        bool x = value;
+        finish = begin();
+        if (count > capacity())
+        {
+            free_all_spaces();
+            allocate_words(words_for(count));
+        }
+        finish = begin() + count;
+        tstd::fill(begin(), finish, x);
+        shrink_if_needed();
+    }
+    template<typename InputIterator,
+        typename = std::enable_if_t<std::is_base_of_v<typename std::input_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>>>
+    constexpr void assign(InputIterator first, InputIterator last) // 2
+    {
+        finish = begin();
+        if constexpr (tstd::is_forward_iterator_v<InputIterator>)
+        {
+            size_type count = static_cast<size_type>(tstd::distance(first, last));
+            if (count > capacity())
+            {
+                free_all_spaces();
+                allocate_words(words_for(count));
+            }
+            finish = tstd::copy(first, last, begin());
+            shrink_if_needed();
+        }
+        else
+        {
+            for (; first != last; ++first)
+            {
+                push_back(*first);
+            }
+            shrink_if_needed();
+        }
+    }
+    constexpr void assign(std::initializer_list<bool> il) // 3
+    {
+        assign(il.begin(), il.end());
+    }
+    // allocator
+    constexpr allocator_type get_allocator() const noexcept
+    {
+        return allocator_type(alloc);
+    }
+
+    // element access
+    constexpr reference at(size_type pos)
+    {
+        assert(pos < size());
+        if (pos >= size())
+        {
+            throw std::out_of_range("vector<bool>::at : input index is out of bounds");
+        }
+        return begin()[pos];
+    }
+    constexpr const_reference at(size_type pos) const
+    {
+        assert(pos < size());
+        if (pos >= size())
+        {
+            throw std::out_of_range("vector<bool>::at : input index is out of bounds");
+        }
+        return begin()[pos];
+    }
+    constexpr reference operator[](size_type pos)
+    {
+        assert(pos < size());
+        return reference(start + pos / word_bits, pos % word_bits);
+    }
+    constexpr const_reference operator[](size_type pos) const
+    {
+        assert(pos < size());
+        return (start[pos / word_bits] >> (pos % word_bits)) & 1;
+    }
+    constexpr reference front()
+    {
+        assert(!empty());
+        return *begin();
+    }
+    constexpr const_reference front() const
+    {
+        assert(!empty());
+        return *begin();
+    }
+    constexpr reference back()
+    {
+        assert(!empty());
+        return *(end() - 1);
+    }
+    constexpr const_reference back() const
+    {
+        assert(!empty());
+        return *(end() - 1);
+    }
+
+    // iterators
+    constexpr iterator begin() noexcept
+    {
+        return iterator(start, 0);
+    }
+    constexpr const_iterator begin() const noexcept
+    {
+        return const_iterator(start, 0);
+    }
+    constexpr const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+    constexpr iterator end() noexcept
+    {
+        return finish;
+    }
+    constexpr const_iterator end() const noexcept
+    {
+        return finish;
+    }
+    constexpr const_iterator cend() const noexcept
+    {
+        return finish;
+    }
+    constexpr reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator(end());
+    }
+    constexpr const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+    constexpr const_reverse_iterator crbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+    constexpr reverse_iterator rend() noexcept
+    {
+        return reverse_iterator(begin());
+    }
+    constexpr const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+    constexpr const_reverse_iterator crend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    // size and capacity
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return begin() == end();
+    }
+    constexpr size_type size() const noexcept
+    {
+        return size_type(end() - begin());
+    }
+    constexpr size_type max_size() const noexcept
+    {
+        return std::numeric_limits<difference_type>::max() - (word_bits - 1);
+    }
+    constexpr void reserve(size_type new_cap)
+    {
+        if (new_cap > capacity())
+        {
+            grow(new_cap);
+        }
+    }
+    constexpr size_type capacity() const noexcept
+    {
+        return size_type(end_of_storage - start) * word_bits;
+    }
+    constexpr void shrink_to_fit()
+    {
+        if (words_for(size()) < size_type(end_of_storage - start))
+        {
+            if (empty())
+            {
+                free_all_spaces();
+            }
+            else
+            {
+                reallocate(words_for(size()));
+            }
+        }
+    }
+
+    // modifiers
+    constexpr void clear() noexcept
+    {
+        finish = begin();
+        if (Growth::shrink(size_type(end_of_storage - start), 0, sizeof(word_type)) < size_type(end_of_storage - start))
+        {
+            free_all_spaces(); // give the whole storage back
+        }
+    }
+    constexpr iterator insert(const_iterator pos, const bool& value) // 1
+    {
+        return insert(pos, size_type(1), value);
+    }
+    constexpr iterator insert(const_iterator pos, size_type count, const bool& value) // 2
+    {
+        bool x = value;
+        size_type idx = size_type(pos - begin());
+        if (count > 0)
+        {
+            move_backward(idx, count);
+            tstd::fill(begin() + idx, begin() + idx + count, x);
+        }
+        return begin() + idx;
+    }
+    template<typename InputIterator,
+        typename = std::enable_if_t<std::is_base_of_v<typename std::input_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>>>
+    constexpr iterator insert(const_iterator pos, InputIterator first, InputIterator last) // 3
+    {
+        size_type idx = size_type(pos - begin());
+        if constexpr (tstd::is_forward_iterator_v<InputIterator>)
+        {
+            size_type count = static_cast<size_type>(tstd::distance(first, last));
+            if (count > 0)
+            {
+                move_backward(idx, count);
+                tstd::copy(first, last, begin() + idx);
+            }
+        }
+        else
+        {
+            vector tmp(first, last, get_allocator());
+            insert(begin() + idx, tmp.begin(), tmp.end());
+        }
+        return begin() + idx;
+    }
+    constexpr iterator insert(const_iterator pos, std::initializer_list<bool> il) // 4
+    {
+        return insert(pos, il.begin(), il.end());
+    }
+    template<typename... Args>
+    constexpr iterator emplace(const_iterator pos, Args&&... args)
+    {
+        return insert(pos, bool(std::forward<Args>(args)...));
+    }
+    constexpr iterator erase(const_iterator pos) // 1
+    {
+        return erase(pos, pos + 1);
+    }
+    constexpr iterator erase(const_iterator first, const_iterator last) // 2
+    {
+        size_type idx = size_type(first - begin());
+        if (first != last)
+        {
+            iterator d_first = begin() + idx;
+            finish = tstd::copy(const_iterator(d_first + (last - first)), cend(), d_first);
+            shrink_if_needed();
+        }
+        return begin() + idx;
+    }
+    constexpr void push_back(const bool& value)
+    {
+        if (finish.word() == end_of_storage) // full
+        {
+            grow(size() + 1);
+        }
+        *finish++ = value;
+    }
+    template<typename... Args>
+    constexpr reference emplace_back(Args&&... args)
+    {
+        push_back(bool(std::forward<Args>(args)...));
+        return back();
+    }
+    constexpr void pop_back()
+    {
+        assert(!empty());
+        --finish;
+        shrink_if_needed();
+    }
+    constexpr void resize(size_type count, const bool& value = false)
+    {
+        if (count < size())
+        {
+            finish = begin() + count;
+            shrink_if_needed();
+        }
+        else if (count > size())
+        {
+            insert(end(), count - size(), value);
+        }
+    }
+    constexpr void swap(vector& other) noexcept(std::allocator_traits<Allocator>::propagate_on_container_swap::value || std::allocator_traits<Allocator>::is_always_equal::value)
+    {
+        tstd::swap(alloc, other.alloc);
+        tstd::swap(start, other.start);
+        tstd::swap(finish, other.finish);
+        tstd::swap(end_of_storage, other.end_of_storage);
+    }
+    // flip all bits
+    constexpr void flip() noexcept
+    {
+        for (word_type* p = start; p != end_of_storage; ++p)
+        {
+            *p = ~*p;
+        }
+    }
+    static constexpr void swap(reference x, reference y) noexcept
+    {
+        bool tmp = x;
+        x = bool(y);
+        y = tmp;
+    }
+private:
+    // auxiliary functions
+    static constexpr size_type words_for(size_type bits) noexcept
+    {
+        return (bits + word_bits - 1) / word_bits;
+    }
+    // allocate storage of at least n words for an empty vector
+    void allocate_words(size_type n)
+    {
+        auto result = impl::_allocate_at_least(alloc, n);
+        start = result.ptr;
+        end_of_storage = start + result.count;
+        finish = begin();
+    }
+    void free_all_spaces()
+    {
+        if (start)
+        {
+            alloc.deallocate(start, size_type(end_of_storage - start));
+        }
+        start = end_of_storage = nullptr;
+        finish = iterator();
+    }
+    // grow capacity to hold at least required bits by the growth policy
+    void grow(size_type required)
+    {
+        reallocate(Growth::grow(size_type(end_of_storage - start), words_for(required), sizeof(word_type)));
+    }
+    // shrink capacity by the growth policy after erasing bits
+    void shrink_if_needed()
+    {
+        size_type words = size_type(end_of_storage - start);
+        size_type new_cap = Growth::shrink(words, words_for(size()), sizeof(word_type));
+        if (new_cap < words)
+        {
+            if (new_cap == 0 && empty())
+            {
+                free_all_spaces();
+            }
+            else
+            {
+                reallocate(tstd::max(new_cap, words_for(size())));
+            }
+        }
+    }
+    // reallocate storage for at least new_cap words, keep all bits
+    void reallocate(size_type new_cap)
+    {
+        size_type count = size();
+        auto result = impl::_allocate_at_least(alloc, new_cap);
+        impl::_memmove_n(start, words_for(count), result.ptr);
+        free_all_spaces();
+        start = result.ptr;
+        end_of_storage = start + result.count;
+        finish = begin() + count;
+    }
+    // open a gap of count bits at idx, with at most one reallocation
+    void move_backward(size_type idx, size_type count)
+    {
+        size_type new_size = size() + count;
+        if (new_size > capacity())
+        {
+            vector tmp(get_allocator());
+            tmp.allocate_words(Growth::grow(size_type(end_of_storage - start), words_for(new_size), sizeof(word_type)));
+            tstd::copy(cbegin(), cbegin() + idx, tmp.begin());
+            tstd::copy(cbegin() + idx, cend(), tmp.begin() + idx + count);
+            tmp.finish = tmp.begin() + new_size;
+            swap(tmp);
+        }
+        else
+        {
+            tstd::copy_backward(cbegin() + idx, cend(), begin() + new_size);
+            finish = begin() + new_size;
+        }
+    }
+private:
+    word_allocator alloc;
+    word_type* start;
+    iterator finish; // off the end bit
+    word_type* end_of_storage; // off the capacity
+};
+
 // non-member operations
 // a non-standard compare function for tstd::vector
 // equal 0 less -1 greater 1
-template<typename T, typename Allocator>
-constexpr int _cmp_vector(const tstd::vector<T, Allocator>& lhs, const tstd::vector<T, Allocator>& rhs)
+template<typename T, typename Allocator, typename Growth>
+constexpr int _cmp_vector(const tstd::vector<T, Allocator, Growth>& lhs, const tstd::vector<T, Allocator, Growth>& rhs)
 {
+    using const_iterator = typename tstd::vector<T, Allocator, Growth>::const_iterator;
+    if constexpr (impl::is_memcmp_comparable_v<const_iterator, const_iterator>)
+    {
+        auto cmp = tstd::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        return cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+    }
     auto iter1 = lhs.begin();
     auto iter2 = rhs.begin();
     for (; iter1 != lhs.end() && iter2 != rhs.end(); ++iter1, ++iter2)
@@ -678,44 +1487,54 @@ constexpr int _cmp_vector(const tstd::vector<T, Allocator>& lhs, const tstd::vec
 }
 
 // comparisons
-template<typename T, typename Allocator>
-constexpr bool operator==(const tstd::vector<T, Allocator>& lhs, const tstd::vector<T, Allocator>& rhs)
+template<typename T, typename Allocator, typename Growth>
+constexpr bool operator==(const tstd::vector<T, Allocator, Growth>& lhs, const tstd::vector<T, Allocator, Growth>& rhs)
 {
-    return _cmp_vector(lhs, rhs) == 0;
+    return lhs.size() == rhs.size() && tstd::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
-template<typename T, typename Allocator>
-constexpr bool operator!=(const tstd::vector<T, Allocator>& lhs, const tstd::vector<T, Allocator>& rhs)
+template<typename T, typename Allocator, typename Growth>
+constexpr bool operator!=(const tstd::vector<T, Allocator, Growth>& lhs, const tstd::vector<T, Allocator, Growth>& rhs)
 {
-    return _cmp_vector(lhs, rhs) != 0;
+    return !(lhs == rhs);
 }
-template<typename T, typename Allocator>
-constexpr bool operator<(const tstd::vector<T, Allocator>& lhs, const tstd::vector<T, Allocator>& rhs)
+template<typename T, typename Allocator, typename Growth>
+constexpr bool operator<(const tstd::vector<T, Allocator, Growth>& lhs, const tstd::vector<T, Allocator, Growth>& rhs)
 {
     return _cmp_vector(lhs, rhs) < 0;
 }
-template<typename T, typename Allocator>
-constexpr bool operator<=(const tstd::vector<T, Allocator>& lhs, const tstd::vector<T, Allocator>& rhs)
+template<typename T, typename Allocator, typename Growth>
+constexpr bool operator<=(const tstd::vector<T, Allocator, Growth>& lhs, const tstd::vector<T, Allocator, Growth>& rhs)
 {
     return _cmp_vector(lhs, rhs) <= 0;
 }
-template<typename T, typename Allocator>
-constexpr bool operator>(const tstd::vector<T, Allocator>& lhs, const tstd::vector<T, Allocator>& rhs)
+template<typename T, typename Allocator, typename Growth>
+constexpr bool operator>(const tstd::vector<T, Allocator, Growth>& lhs, const tstd::vector<T, Allocator, Growth>& rhs)
 {
     return _cmp_vector(lhs, rhs) > 0;
 }
-template<typename T, typename Allocator>
-constexpr bool operator>=(const tstd::vector<T, Allocator>& lhs, const tstd::vector<T, Allocator>& rhs)
+template<typename T, typename Allocator, typename Growth>
+constexpr bool operator>=(const tstd::vector<T, Allocator, Growth>& lhs, const tstd::vector<T, Allocator, Growth>& rhs)
 {
     return _cmp_vector(lhs, rhs) >= 0;
 }
 
 // global swap for tstd::vector
-template<typename T, typename Allocator>
-constexpr void swap(tstd::vector<T, Allocator>& lhs, tstd::vector<T, Allocator>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+template<typename T, typename Allocator, typename Growth>
+constexpr void swap(tstd::vector<T, Allocator, Growth>& lhs, tstd::vector<T, Allocator, Growth>& rhs) noexcept(noexcept(lhs.swap(rhs)))
 {
     lhs.swap(rhs);
 }
 
+// vector only holds pointers to its heap storage, could be relocated bitwise if its allocator could.
+template<typename T, typename Allocator, typename Growth>
+struct is_trivially_relocatable<tstd::vector<T, Allocator, Growth>> : is_trivially_relocatable<Allocator> {};
+
+namespace pmr
+{
+template<typename T>
+using vector = tstd::vector<T, polymorphic_allocator<T>>;
+} // namespace pmr
+
 } // namespace tstd
 
 
@@ -0,0 +1,695 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+#include <unistd.h>
+#include <tmemory.hpp>
+#include <tlist.hpp>
+#include <tmap.hpp>
+#include <tunordered_map.hpp>
+#include <tunordered_set.hpp>
+#include <tvector.hpp>
+#include <tset.hpp>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include "EfficiencyTestUtil.hpp"
+
+void testPoolAllocatorEfficiency(bool showDetails);
+void testMemoryResourceEfficiency(bool showDetails);
+void testUninitializedEfficiency(bool showDetails);
+void testAlignedAllocatorEfficiency(bool showDetails);
+void testThreadCacheAllocatorEfficiency(bool showDetails);
+void testMmapAllocatorEfficiency(bool showDetails);
+void testSharedPtrEfficiency(bool showDetails);
+void testSlabAllocatorEfficiency(bool showDetails);
+void testMappedFileAllocatorEfficiency(bool showDetails);
+void testInlineArenaAllocatorEfficiency(bool showDetails);
+
+int main(int argc, char const *argv[])
+{
+    bool showDetails = argc >= 2 && std::string(argv[1]) == "-d";
+    testPoolAllocatorEfficiency(showDetails);
+    testMemoryResourceEfficiency(showDetails);
+    testUninitializedEfficiency(showDetails);
+    testAlignedAllocatorEfficiency(showDetails);
+    testThreadCacheAllocatorEfficiency(showDetails);
+    testMmapAllocatorEfficiency(showDetails);
+    testSharedPtrEfficiency(showDetails);
+    testSlabAllocatorEfficiency(showDetails);
+    testMappedFileAllocatorEfficiency(showDetails);
+    testInlineArenaAllocatorEfficiency(showDetails);
+    return 0;
+}
+
+// node insert/erase throughput with different allocators
+template<typename Allocator>
+void listChurn(EfficiencyTestUtil& util, const std::string& allocatorName, const std::vector<int>& keys)
+{
+    util.measure("list push_back/pop_front, " + allocatorName, [&]() {
+        tstd::list<int, typename Allocator::template rebind<int>::other> l;
+        for (int round = 0; round < 10; ++round)
+        {
+            for (int key : keys)
+            {
+                l.push_back(key);
+            }
+            while (!l.empty())
+            {
+                l.pop_front();
+            }
+        }
+        doNotOptimizeAway(l.size());
+    });
+}
+
+template<typename Allocator>
+void mapChurn(EfficiencyTestUtil& util, const std::string& allocatorName, const std::vector<int>& keys)
+{
+    util.measure("map insert/erase, " + allocatorName, [&]() {
+        tstd::map<int, int, std::less<int>, typename Allocator::template rebind<std::pair<const int, int>>::other> m;
+        for (int round = 0; round < 2; ++round)
+        {
+            for (int key : keys)
+            {
+                m[key] = key;
+            }
+            for (int key : keys)
+            {
+                m.erase(key);
+            }
+        }
+        doNotOptimizeAway(m.size());
+    });
+}
+
+template<typename Allocator>
+void unorderedMapChurn(EfficiencyTestUtil& util, const std::string& allocatorName, const std::vector<int>& keys)
+{
+    util.measure("unordered_map insert/erase, " + allocatorName, [&]() {
+        tstd::unordered_map<int, int, std::hash<int>, std::equal_to<int>, typename Allocator::template rebind<std::pair<const int, int>>::other> m;
+        for (int round = 0; round < 5; ++round)
+        {
+            for (int key : keys)
+            {
+                m[key] = key;
+            }
+            for (int key : keys)
+            {
+                m.erase(key);
+            }
+        }
+        doNotOptimizeAway(m.size());
+    });
+}
+
+void testPoolAllocatorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "pool allocator");
+    std::vector<int> keys(200000);
+    std::mt19937 gen(42);
+    for (auto& key : keys)
+    {
+        key = static_cast<int>(gen());
+    }
+    util.startGroup("list");
+    listChurn<tstd::allocator<int>>(util, "tstd::allocator", keys);
+    listChurn<tstd::pool_allocator<int>>(util, "tstd::pool_allocator", keys);
+    listChurn<tstd::pool_allocator<int, false>>(util, "tstd::pool_allocator<T, false>", keys);
+    util.startGroup("map");
+    mapChurn<tstd::allocator<int>>(util, "tstd::allocator", keys);
+    mapChurn<tstd::pool_allocator<int>>(util, "tstd::pool_allocator", keys);
+    mapChurn<tstd::pool_allocator<int, false>>(util, "tstd::pool_allocator<T, false>", keys);
+    util.startGroup("unordered_map");
+    unorderedMapChurn<tstd::allocator<int>>(util, "tstd::allocator", keys);
+    unorderedMapChurn<tstd::pool_allocator<int>>(util, "tstd::pool_allocator", keys);
+    unorderedMapChurn<tstd::pool_allocator<int, false>>(util, "tstd::pool_allocator<T, false>", keys);
+    util.showFinalResult();
+}
+
+// build and tear down short-lived containers, like handling of a request
+// makeResource create the memory resource of a request, nullptr means default resource.
+template<typename MakeResource>
+void requestChurn(EfficiencyTestUtil& util, const std::string& resourceName, const std::vector<int>& keys, MakeResource makeResource)
+{
+    util.measure("vector/map/unordered_map per request, " + resourceName, [&]() {
+        std::size_t total = 0;
+        for (std::size_t begin = 0; begin < keys.size(); begin += 1000)
+        {
+            auto resource = makeResource();
+            tstd::pmr::memory_resource* r = resource ? resource.get() : tstd::pmr::get_default_resource();
+            tstd::pmr::vector<int> vec(r);
+            tstd::pmr::map<int, int> m(r);
+            tstd::pmr::unordered_map<int, int> um(r);
+            for (std::size_t i = begin; i < begin + 1000 && i < keys.size(); ++i)
+            {
+                vec.push_back(keys[i]);
+                m[keys[i]] = keys[i];
+                um[keys[i]] = keys[i];
+            }
+            total += vec.size() + m.size() + um.size();
+        }
+        doNotOptimizeAway(total);
+    });
+}
+
+void testMemoryResourceEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "memory resource");
+    std::vector<int> keys(1000000);
+    std::mt19937 gen(42);
+    for (auto& key : keys)
+    {
+        key = static_cast<int>(gen());
+    }
+    util.startGroup("request");
+    requestChurn(util, "default resource", keys, []() {
+        return std::unique_ptr<tstd::pmr::memory_resource>();
+    });
+    requestChurn(util, "monotonic_buffer_resource", keys, []() {
+        return std::unique_ptr<tstd::pmr::memory_resource>(new tstd::pmr::monotonic_buffer_resource(64 * 1024));
+    });
+    requestChurn(util, "unsynchronized_pool_resource", keys, []() {
+        return std::unique_ptr<tstd::pmr::memory_resource>(new tstd::pmr::unsynchronized_pool_resource());
+    });
+    requestChurn(util, "synchronized_pool_resource", keys, []() {
+        return std::unique_ptr<tstd::pmr::memory_resource>(new tstd::pmr::synchronized_pool_resource());
+    });
+    util.showFinalResult();
+}
+
+// uninitialized copy/fill of trivially copyable types, compared with constructing elements one by one
+struct Pod
+{
+    int a;
+    double b;
+    char c[20];
+};
+
+template<typename T>
+void uninitializedCopyCase(EfficiencyTestUtil& util, const std::string& typeName, std::size_t n)
+{
+    std::vector<T> src(n);
+    T* dest = static_cast<T*>(::operator new(n * sizeof(T)));
+    util.measure("construct one by one, " + typeName, [&]() {
+        for (int round = 0; round < 20; ++round)
+        {
+            T* d = dest;
+            for (const T* p = src.data(); p != src.data() + n; ++p, ++d)
+            {
+                tstd::impl::_construct(d, *p);
+                doNotOptimizeAway(d);
+            }
+        }
+    });
+    util.measure("tstd::uninitialized_copy, " + typeName, [&]() {
+        for (int round = 0; round < 20; ++round)
+        {
+            doNotOptimizeAway(tstd::uninitialized_copy(src.data(), src.data() + n, dest));
+        }
+    });
+    ::operator delete(dest);
+}
+
+void testUninitializedEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "uninitialized algorithms");
+    util.startGroup("copy int");
+    uninitializedCopyCase<int>(util, "int", 1000000);
+    util.startGroup("copy pod");
+    uninitializedCopyCase<Pod>(util, "pod", 1000000);
+    util.startGroup("fill char");
+    std::size_t n = 1 << 24;
+    char* buf = static_cast<char*>(::operator new(n));
+    util.measure("construct one by one, char", [&]() {
+        for (int round = 0; round < 20; ++round)
+        {
+            for (char* p = buf; p != buf + n; ++p)
+            {
+                tstd::impl::_construct(p, static_cast<char>(round));
+                doNotOptimizeAway(p);
+            }
+        }
+    });
+    util.measure("tstd::uninitialized_fill, char", [&]() {
+        for (int round = 0; round < 20; ++round)
+        {
+            tstd::uninitialized_fill(buf, buf + n, static_cast<char>(round));
+            doNotOptimizeAway(buf[round]);
+        }
+    });
+    ::operator delete(buf);
+    util.showFinalResult();
+}
+
+// vectorized loops over float buffers, offset shifts the start of the loop away from the allocation
+template<typename Vector>
+void saxpyCase(EfficiencyTestUtil& util, const std::string& name, std::size_t n, std::size_t offset)
+{
+    Vector x(n + offset, 1.0f);
+    Vector y(n + offset, 2.0f);
+    util.measure("saxpy " + std::to_string(n) + ", " + name, [&]() {
+        for (int round = 0; round < 2000; ++round)
+        {
+            float* __restrict px = x.data() + offset;
+            float* __restrict py = y.data() + offset;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                py[i] = 1.0001f * px[i] + py[i];
+            }
+            doNotOptimizeAway(py[round % n]);
+        }
+    });
+}
+
+void testAlignedAllocatorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "aligned allocator");
+    using Vector = tstd::vector<float>;
+    using AlignedVector = tstd::vector<float, tstd::aligned_allocator<float>>;
+    for (std::size_t n : {1000, 8000})
+    {
+        util.startGroup("vector<float> of " + std::to_string(n));
+        saxpyCase<Vector>(util, "tstd::allocator", n, 0);
+        saxpyCase<Vector>(util, "tstd::allocator, misaligned by 1 float", n, 1);
+        saxpyCase<AlignedVector>(util, "tstd::aligned_allocator<float, 64>", n, 0);
+    }
+    util.showFinalResult();
+}
+
+// every thread builds and destroys its own list/unordered_map, same work for every thread,
+// so time keeps flat when allocation scales with threads.
+template<typename Allocator>
+void multiThreadChurn(EfficiencyTestUtil& util, const std::string& allocatorName, int threadCount)
+{
+    util.measure(std::to_string(threadCount) + " threads, " + allocatorName, [&]() {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([t]() {
+                std::mt19937 gen(t);
+                tstd::list<int, typename Allocator::template rebind<int>::other> l;
+                tstd::unordered_map<int, int, std::hash<int>, std::equal_to<int>, typename Allocator::template rebind<std::pair<const int, int>>::other> m;
+                for (int round = 0; round < 20; ++round)
+                {
+                    for (int i = 0; i < 10000; ++i)
+                    {
+                        int key = static_cast<int>(gen());
+                        l.push_back(key);
+                        m[key] = key;
+                    }
+                    l.clear();
+                    m.clear();
+                }
+                doNotOptimizeAway(l.size() + m.size());
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    });
+}
+
+void testThreadCacheAllocatorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "thread cache allocator");
+    std::vector<int> threadCounts{1, 2, 4};
+    int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (hardwareThreads > 4)
+    {
+        threadCounts.push_back(hardwareThreads);
+    }
+    util.startGroup("tstd::allocator");
+    for (int n : threadCounts)
+    {
+        multiThreadChurn<tstd::allocator<int>>(util, "tstd::allocator", n);
+    }
+    util.startGroup("tstd::pool_allocator");
+    for (int n : threadCounts)
+    {
+        multiThreadChurn<tstd::pool_allocator<int>>(util, "tstd::pool_allocator", n);
+    }
+    util.startGroup("tstd::thread_cache_allocator");
+    for (int n : threadCounts)
+    {
+        multiThreadChurn<tstd::thread_cache_allocator<int>>(util, "tstd::thread_cache_allocator", n);
+    }
+    util.showFinalResult();
+}
+
+// huge vectors: growth by mremap instead of copying
+template<typename Allocator>
+void hugeVectorGrowth(EfficiencyTestUtil& util, const std::string& allocatorName, std::size_t n)
+{
+    util.measure("push_back " + std::to_string(n) + ", " + allocatorName, [&]() {
+        tstd::vector<std::uint64_t, Allocator> vec;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            vec.push_back(i);
+        }
+        doNotOptimizeAway(vec.size());
+    });
+}
+
+// huge vectors: random access, huge pages reduce TLB misses
+template<typename Allocator>
+void hugeVectorRandomAccess(EfficiencyTestUtil& util, const std::string& allocatorName, std::size_t n, const std::vector<std::size_t>& indices)
+{
+    tstd::vector<std::uint64_t, Allocator> vec(n, 1);
+    util.measure("random access, " + allocatorName, [&]() {
+        std::uint64_t sum = 0;
+        for (std::size_t idx : indices)
+        {
+            sum += vec[idx];
+        }
+        doNotOptimizeAway(sum);
+    });
+}
+
+// huge hash tables: random lookups touch bucket array and nodes
+template<typename Allocator>
+void hugeUnorderedMapCase(EfficiencyTestUtil& util, const std::string& allocatorName, const std::vector<int>& keys)
+{
+    tstd::unordered_map<int, int, std::hash<int>, std::equal_to<int>, typename Allocator::template rebind<std::pair<const int, int>>::other> m;
+    m.reserve(keys.size());
+    for (int key : keys)
+    {
+        m[key] = key;
+    }
+    util.measure("unordered_map find, " + allocatorName, [&]() {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            found += m.count(keys[(i * 7919) % keys.size()]);
+        }
+        doNotOptimizeAway(found);
+    });
+}
+
+void testMmapAllocatorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "mmap allocator");
+    std::size_t n = std::size_t(1) << 25; // 256MB of uint64_t
+    std::vector<std::size_t> indices(10000000);
+    std::mt19937_64 gen(42);
+    for (auto& idx : indices)
+    {
+        idx = gen() % n;
+    }
+    util.startGroup("vector<uint64_t> growth");
+    hugeVectorGrowth<tstd::allocator<std::uint64_t>>(util, "tstd::allocator", n);
+    hugeVectorGrowth<tstd::mmap_allocator<std::uint64_t>>(util, "tstd::mmap_allocator", n);
+    util.startGroup("vector<uint64_t> random access");
+    hugeVectorRandomAccess<tstd::allocator<std::uint64_t>>(util, "tstd::allocator", n, indices);
+    hugeVectorRandomAccess<tstd::mmap_allocator<std::uint64_t>>(util, "tstd::mmap_allocator", n, indices);
+    std::vector<int> keys(1 << 22);
+    std::mt19937 gen32(42);
+    for (auto& key : keys)
+    {
+        key = static_cast<int>(gen32());
+    }
+    util.startGroup("unordered_map<int, int>");
+    hugeUnorderedMapCase<tstd::allocator<int>>(util, "tstd::allocator", keys);
+    hugeUnorderedMapCase<tstd::mmap_allocator<int>>(util, "tstd::mmap_allocator", keys);
+    util.showFinalResult();
+}
+
+// creation and destruction of shared pointers
+template<typename SharedPtr, typename Make>
+void sharedPtrCreate(EfficiencyTestUtil& util, const std::string& name, Make make)
+{
+    util.measure("create 1000000, " + name, [&]() {
+        std::vector<SharedPtr> ptrs;
+        ptrs.reserve(1000000);
+        for (int i = 0; i < 1000000; ++i)
+        {
+            ptrs.push_back(make(i));
+        }
+        doNotOptimizeAway(ptrs.size());
+    });
+}
+
+// copying and destroying of shared pointers, the reference counting
+template<typename SharedPtr>
+void sharedPtrCopy(EfficiencyTestUtil& util, const std::string& name, const SharedPtr& p)
+{
+    util.measure("copy 10000000, " + name, [&]() {
+        for (int i = 0; i < 10000000; ++i)
+        {
+            SharedPtr q = p;
+            doNotOptimizeAway(q.get());
+        }
+    });
+}
+
+void testSharedPtrEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "shared_ptr");
+    util.startGroup("create");
+    sharedPtrCreate<std::shared_ptr<int>>(util, "std::shared_ptr(new)", [](int i) { return std::shared_ptr<int>(new int(i)); });
+    sharedPtrCreate<std::shared_ptr<int>>(util, "std::make_shared", [](int i) { return std::make_shared<int>(i); });
+    sharedPtrCreate<tstd::shared_ptr<int>>(util, "tstd::shared_ptr(new)", [](int i) { return tstd::shared_ptr<int>(new int(i)); });
+    sharedPtrCreate<tstd::shared_ptr<int>>(util, "tstd::make_shared", [](int i) { return tstd::make_shared<int>(i); });
+    sharedPtrCreate<tstd::local_shared_ptr<int>>(util, "tstd::make_local_shared", [](int i) { return tstd::make_local_shared<int>(i); });
+    util.startGroup("copy");
+    sharedPtrCopy(util, "std::shared_ptr", std::make_shared<int>(1));
+    sharedPtrCopy(util, "tstd::shared_ptr", tstd::make_shared<int>(1));
+    sharedPtrCopy(util, "tstd::local_shared_ptr", tstd::make_local_shared<int>(1));
+    util.showFinalResult();
+}
+
+// bytes in use of the heap, for memory per element
+std::size_t heapBytesInUse()
+{
+#if defined(__GLIBC__)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+// memory per element and lookup time of node-based containers
+template<typename Set>
+void nodeContainerFootprint(EfficiencyTestUtil& util, const std::string& name, const std::vector<int>& keys)
+{
+    std::size_t before = heapBytesInUse();
+    Set* st = new Set();
+    util.measure("insert " + std::to_string(keys.size()) + ", " + name, [&]() {
+        for (int key : keys)
+        {
+            st->insert(key);
+        }
+    });
+    std::size_t after = heapBytesInUse();
+    util.measure("find " + std::to_string(keys.size()) + ", " + name, [&]() {
+        std::size_t count = 0;
+        for (int key : keys)
+        {
+            count += st->find(key) != st->end();
+        }
+        doNotOptimizeAway(count);
+    });
+    util.showValue("memory per element, " + name, double(after - before) / st->size(), "bytes");
+    delete st; // slab chunks are never returned, the next slab case reuses them
+}
+
+template<typename List>
+void listFootprint(EfficiencyTestUtil& util, const std::string& name, std::size_t n)
+{
+    std::size_t before = heapBytesInUse();
+    List* l = new List();
+    util.measure("push_back " + std::to_string(n) + ", " + name, [&]() {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            l->push_back(static_cast<int>(i));
+        }
+    });
+    std::size_t after = heapBytesInUse();
+    util.measure("traverse x 10, " + name, [&]() {
+        long long sum = 0;
+        for (int i = 0; i < 10; ++i)
+        {
+            for (int x : *l)
+            {
+                sum += x;
+            }
+        }
+        doNotOptimizeAway(sum);
+    });
+    util.showValue("memory per element, " + name, double(after - before) / l->size(), "bytes");
+    delete l;
+}
+
+void testSlabAllocatorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "slab allocator");
+    std::vector<int> keys(1000000);
+    std::mt19937 gen(42);
+    for (auto& key : keys)
+    {
+        key = static_cast<int>(gen());
+    }
+    util.startGroup("set<int>");
+    nodeContainerFootprint<tstd::set<int>>(util, "tstd::allocator", keys);
+    nodeContainerFootprint<tstd::set<int, std::less<int>, tstd::slab_allocator<int, false>>>(util, "tstd::slab_allocator", keys);
+    util.startGroup("unordered_set<int>");
+    nodeContainerFootprint<tstd::unordered_set<int>>(util, "tstd::allocator", keys);
+    nodeContainerFootprint<tstd::unordered_set<int, std::hash<int>, std::equal_to<int>, tstd::slab_allocator<int, false>>>(util, "tstd::slab_allocator", keys);
+    util.startGroup("list<int>");
+    listFootprint<tstd::list<int>>(util, "tstd::allocator", keys.size());
+    listFootprint<tstd::list<int, tstd::slab_allocator<int, false>>>(util, "tstd::slab_allocator", keys.size());
+    util.showFinalResult();
+}
+
+// build an index in heap and in a mapped file, then reopen the file instead of rebuilding
+template<template<typename> typename MapOf>
+void persistentIndex(EfficiencyTestUtil& util, const std::string& path, const std::vector<int>& keys)
+{
+    using HeapMap = MapOf<tstd::allocator<std::pair<const int, int>>>;
+    using MappedAlloc = tstd::mapped_file_allocator<std::pair<const int, int>>;
+    using MappedMap = MapOf<MappedAlloc>;
+    auto findAll = [&](const auto& m) {
+        std::size_t count = 0;
+        for (int key : keys)
+        {
+            count += m.find(key) != m.end();
+        }
+        doNotOptimizeAway(count);
+    };
+    std::filesystem::remove(path);
+    {
+        HeapMap m;
+        util.measure("build " + std::to_string(keys.size()) + ", tstd::allocator", [&]() {
+            for (std::size_t i = 0; i < keys.size(); ++i)
+            {
+                m[keys[i]] = static_cast<int>(i);
+            }
+        });
+        util.measure("find " + std::to_string(keys.size()) + ", tstd::allocator", [&]() { findAll(m); });
+    }
+    {
+        tstd::mapped_file file(path.c_str(), std::size_t(1) << 30);
+        util.measure("build " + std::to_string(keys.size()) + ", tstd::mapped_file_allocator", [&]() {
+            MappedMap* m = file.find_or_construct<MappedMap>("index", MappedAlloc(file));
+            for (std::size_t i = 0; i < keys.size(); ++i)
+            {
+                (*m)[keys[i]] = static_cast<int>(i);
+            }
+        });
+    }
+    MappedMap* m = nullptr;
+    std::unique_ptr<tstd::mapped_file> file;
+    util.measure("reopen and find root, tstd::mapped_file_allocator", [&]() {
+        file = std::make_unique<tstd::mapped_file>(path.c_str(), 0);
+        m = file->find<MappedMap>("index");
+        doNotOptimizeAway(m->size());
+    });
+    util.measure("find " + std::to_string(keys.size()) + " after reopen, tstd::mapped_file_allocator", [&]() { findAll(*m); });
+    file.reset();
+    std::filesystem::remove(path);
+}
+
+template<typename Allocator>
+using PersistentMap = tstd::map<int, int, std::less<int>, Allocator>;
+template<typename Allocator>
+using PersistentUnorderedMap = tstd::unordered_map<int, int, std::hash<int>, std::equal_to<int>, Allocator>;
+
+void testMappedFileAllocatorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "mapped file allocator");
+    if constexpr (tstd::mapped_file::supported)
+    {
+        std::vector<int> keys(1000000);
+        std::mt19937 gen(42);
+        for (auto& key : keys)
+        {
+            key = static_cast<int>(gen());
+        }
+        std::string path = (std::filesystem::temp_directory_path() / ("tstl_mapped_file_efficiency_" + std::to_string(::getpid()) + ".bin")).string();
+        util.startGroup("map<int, int>");
+        persistentIndex<PersistentMap>(util, path, keys);
+        util.startGroup("unordered_map<int, int>");
+        persistentIndex<PersistentUnorderedMap>(util, path, keys);
+    }
+    util.showFinalResult();
+}
+
+// short-lived local containers of n elements, built and destroyed rounds times
+template<std::size_t ArenaBytes, typename Container, typename Fill>
+void shortLivedContainers(EfficiencyTestUtil& util, const std::string& name, std::size_t rounds, Fill fill)
+{
+    util.measure(name, [&]() {
+        std::size_t sum = 0;
+        for (std::size_t round = 0; round < rounds; ++round)
+        {
+            if constexpr (ArenaBytes == 0)
+            {
+                Container c;
+                fill(c, round);
+                sum += c.size();
+            }
+            else
+            {
+                tstd::inline_arena<ArenaBytes> arena;
+                Container c(arena);
+                fill(c, round);
+                sum += c.size();
+            }
+        }
+        doNotOptimizeAway(sum);
+    });
+}
+
+void testInlineArenaAllocatorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "inline arena allocator");
+    constexpr std::size_t rounds = 1000000;
+    constexpr int n = 32;
+    constexpr std::size_t arenaBytes = 4096;
+    auto fillVector = [](auto& vec, std::size_t round) {
+        vec.reserve(n);
+        for (int i = 0; i < n; ++i)
+        {
+            vec.push_back(i + static_cast<int>(round));
+        }
+    };
+    auto fillVectorGrowing = [](auto& vec, std::size_t round) {
+        for (int i = 0; i < n; ++i)
+        {
+            vec.push_back(i + static_cast<int>(round));
+        }
+    };
+    auto fillList = [](auto& l, std::size_t round) {
+        for (int i = 0; i < n; ++i)
+        {
+            l.push_back(i + static_cast<int>(round));
+        }
+    };
+    auto fillMap = [](auto& m, std::size_t round) {
+        for (int i = 0; i < n; ++i)
+        {
+            m[(i * 7919 + static_cast<int>(round)) % 1024] = i;
+        }
+    };
+    util.startGroup("vector<int> of 32 elements, reserved");
+    shortLivedContainers<0, tstd::vector<int>>(util, "tstd::allocator", rounds, fillVector);
+    shortLivedContainers<arenaBytes, tstd::vector<int, tstd::inline_arena_allocator<int, arenaBytes>>>(util, "tstd::inline_arena_allocator", rounds, fillVector);
+    util.startGroup("vector<int> of 32 elements, growing");
+    shortLivedContainers<0, tstd::vector<int>>(util, "tstd::allocator", rounds, fillVectorGrowing);
+    shortLivedContainers<arenaBytes, tstd::vector<int, tstd::inline_arena_allocator<int, arenaBytes>>>(util, "tstd::inline_arena_allocator", rounds, fillVectorGrowing);
+    util.startGroup("list<int> of 32 elements");
+    shortLivedContainers<0, tstd::list<int>>(util, "tstd::allocator", rounds, fillList);
+    shortLivedContainers<arenaBytes, tstd::list<int, tstd::inline_arena_allocator<int, arenaBytes>>>(util, "tstd::inline_arena_allocator", rounds, fillList);
+    util.startGroup("map<int, int> of 32 elements");
+    using ArenaMapAllocator = tstd::inline_arena_allocator<std::pair<const int, int>, arenaBytes>;
+    shortLivedContainers<0, tstd::map<int, int>>(util, "tstd::allocator", rounds, fillMap);
+    shortLivedContainers<arenaBytes, tstd::map<int, int, std::less<int>, ArenaMapAllocator>>(util, "tstd::inline_arena_allocator", rounds, fillMap);
+    util.showFinalResult();
+}
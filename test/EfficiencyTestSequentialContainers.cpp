@@ -0,0 +1,765 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <array>
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <random>
+#include <tvector.hpp>
+#include <tdeque.hpp>
+#include <tsmall_vector.hpp>
+#include <tstatic_vector.hpp>
+#include <tsoa_vector.hpp>
+#include <tsegmented_vector.hpp>
+#include <tnumeric.hpp>
+#include <tmemory.hpp>
+#include "EfficiencyTestUtil.hpp"
+
+// many small vectors, growth of which benefits from the slack of malloc chunks
+template<typename Vector>
+void smallVectorGrowth(EfficiencyTestUtil& util, const std::string& name)
+{
+    util.measure("100000 vectors push_back 1..40 chars, " + name, [&]() {
+        std::size_t total = 0;
+        for (int i = 0; i < 100000; ++i)
+        {
+            Vector vec;
+            for (int j = 0; j < 1 + i % 40; ++j)
+            {
+                vec.push_back(static_cast<char>(j));
+            }
+            total += vec.capacity();
+        }
+        doNotOptimizeAway(total);
+    });
+}
+
+void testVectorEfficiency(bool showDetails);
+void testSmallVectorEfficiency(bool showDetails);
+void testVectorGrowthPolicyEfficiency(bool showDetails);
+void testVectorBoolEfficiency(bool showDetails);
+void testVectorForOverwriteEfficiency(bool showDetails);
+void testStaticVectorEfficiency(bool showDetails);
+void testSoaVectorEfficiency(bool showDetails);
+void testVectorComparisonEfficiency(bool showDetails);
+void testSegmentedVectorEfficiency(bool showDetails);
+void testDequeBlockSizeEfficiency(bool showDetails);
+void testDequeQueueChurnEfficiency(bool showDetails);
+void testDequeAlgorithmsEfficiency(bool showDetails);
+
+int main(int argc, char const *argv[])
+{
+    bool showDetails = argc >= 2 && std::string(argv[1]) == "-d";
+    testVectorEfficiency(showDetails);
+    testSmallVectorEfficiency(showDetails);
+    testVectorGrowthPolicyEfficiency(showDetails);
+    testVectorBoolEfficiency(showDetails);
+    testVectorForOverwriteEfficiency(showDetails);
+    testStaticVectorEfficiency(showDetails);
+    testSoaVectorEfficiency(showDetails);
+    testVectorComparisonEfficiency(showDetails);
+    testSegmentedVectorEfficiency(showDetails);
+    testDequeBlockSizeEfficiency(showDetails);
+    testDequeQueueChurnEfficiency(showDetails);
+    testDequeAlgorithmsEfficiency(showDetails);
+    return 0;
+}
+
+// relocation of elements when growing
+template<typename Vector>
+void vectorOfVectorGrowth(EfficiencyTestUtil& util, const std::string& name)
+{
+    using Inner = typename Vector::value_type;
+    util.measure("push_back 1000000, " + name, [&]() {
+        Vector vec;
+        for (int i = 0; i < 1000000; ++i)
+        {
+            vec.push_back(Inner(4, i));
+        }
+        doNotOptimizeAway(vec.size());
+    });
+}
+
+// relocation of elements when inserting and erasing
+template<typename Vector>
+void vectorOfVectorShift(EfficiencyTestUtil& util, const std::string& name)
+{
+    using Inner = typename Vector::value_type;
+    util.measure("insert/erase at front 20000, " + name, [&]() {
+        Vector vec;
+        for (int i = 0; i < 20000; ++i)
+        {
+            vec.insert(vec.begin(), Inner(4, i));
+        }
+        while (!vec.empty())
+        {
+            vec.erase(vec.begin());
+        }
+        doNotOptimizeAway(vec.size());
+    });
+}
+
+// appending large batches to an existing vector
+template<typename Vector, typename Source>
+void vectorBatchInsert(EfficiencyTestUtil& util, const std::string& name, const Source& batch, bool middle)
+{
+    util.measure(std::string(middle ? "insert at middle" : "append") + " 200 batches of " + std::to_string(batch.size()) + ", " + name, [&]() {
+        Vector vec(batch.begin(), batch.end());
+        for (int i = 0; i < 200; ++i)
+        {
+            vec.insert(middle ? vec.begin() + vec.size() / 2 : vec.end(), batch.begin(), batch.end());
+        }
+        doNotOptimizeAway(vec.size());
+    });
+}
+
+void testVectorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "vector");
+    util.startGroup("vector<vector<int>> growth");
+    vectorOfVectorGrowth<std::vector<std::vector<int>>>(util, "std::vector");
+    vectorOfVectorGrowth<tstd::vector<tstd::vector<int>>>(util, "tstd::vector");
+    util.startGroup("vector<vector<int>> insert/erase");
+    vectorOfVectorShift<std::vector<std::vector<int>>>(util, "std::vector");
+    vectorOfVectorShift<tstd::vector<tstd::vector<int>>>(util, "tstd::vector");
+    util.startGroup("small vector<char> growth");
+    smallVectorGrowth<std::vector<char>>(util, "std::vector");
+    smallVectorGrowth<tstd::vector<char>>(util, "tstd::vector");
+    std::list<int> intBatch(10000, 1);
+    std::vector<std::string> stringBatch(1000, std::string(32, 'x'));
+    util.startGroup("vector<int> batch insert from list");
+    vectorBatchInsert<std::vector<int>>(util, "std::vector", intBatch, false);
+    vectorBatchInsert<tstd::vector<int>>(util, "tstd::vector", intBatch, false);
+    vectorBatchInsert<std::vector<int>>(util, "std::vector", intBatch, true);
+    vectorBatchInsert<tstd::vector<int>>(util, "tstd::vector", intBatch, true);
+    util.startGroup("vector<string> batch insert");
+    vectorBatchInsert<std::vector<std::string>>(util, "std::vector", stringBatch, false);
+    vectorBatchInsert<tstd::vector<std::string>>(util, "tstd::vector", stringBatch, false);
+    vectorBatchInsert<std::vector<std::string>>(util, "std::vector", stringBatch, true);
+    vectorBatchInsert<tstd::vector<std::string>>(util, "tstd::vector", stringBatch, true);
+    util.showFinalResult();
+}
+
+// build and destroy many vectors of size elements, then read them
+template<typename Vector>
+void tinyVectors(EfficiencyTestUtil& util, const std::string& name, int size)
+{
+    util.measure("1000000 vectors of " + std::to_string(size) + " ints, " + name, [&]() {
+        long long total = 0;
+        for (int i = 0; i < 1000000; ++i)
+        {
+            Vector vec;
+            for (int j = 0; j < size; ++j)
+            {
+                vec.push_back(i + j);
+            }
+            for (int x : vec)
+            {
+                total += x;
+            }
+        }
+        doNotOptimizeAway(total);
+    });
+}
+
+void testSmallVectorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "small_vector");
+    for (int size : {0, 1, 4, 8, 16, 32, 64})
+    {
+        util.startGroup("size " + std::to_string(size));
+        tinyVectors<tstd::vector<int>>(util, "tstd::vector", size);
+        tinyVectors<tstd::small_vector<int, 8>>(util, "tstd::small_vector<int, 8>", size);
+        tinyVectors<tstd::small_vector<int, 32>>(util, "tstd::small_vector<int, 32>", size);
+    }
+    util.showFinalResult();
+}
+
+// push_back n elements: time, reallocations and peak memory of every growth policy
+template<typename Growth>
+void growthPolicyPushBack(EfficiencyTestUtil& util, const std::string& name, int n)
+{
+    struct Tag {};
+    tstd::reset_allocation_stats<Tag>();
+    util.measure("push_back " + std::to_string(n) + " ints, " + name, [&]() {
+        tstd::vector<int, tstd::counting_allocator<int, Tag>, Growth> vec;
+        for (int i = 0; i < n; ++i)
+        {
+            vec.push_back(i);
+        }
+        doNotOptimizeAway(vec.data());
+    });
+    auto stats = tstd::get_allocation_stats<Tag>();
+    util.showValue("allocations, " + name, double(stats.allocations), "");
+    util.showValue("peak memory / element bytes, " + name, double(stats.peak_live_bytes) / (double(n) * sizeof(int)), "");
+}
+
+// fill n elements, erase all but n / 100 of them and keep the vector alive
+template<typename Growth>
+void growthPolicyErase(EfficiencyTestUtil& util, const std::string& name, int n)
+{
+    struct Tag {};
+    tstd::reset_allocation_stats<Tag>();
+    tstd::vector<int, tstd::counting_allocator<int, Tag>, Growth> vec;
+    util.measure("fill " + std::to_string(n) + " and pop_back 99%, " + name, [&]() {
+        for (int round = 0; round < 10; ++round)
+        {
+            for (int i = 0; i < n / 10; ++i)
+            {
+                vec.push_back(i);
+            }
+            while (vec.size() > static_cast<std::size_t>(n / 1000 * (round + 1)))
+            {
+                vec.pop_back();
+            }
+        }
+        doNotOptimizeAway(vec.data());
+    });
+    util.showValue("memory kept after erasing, " + name, double(tstd::get_allocation_stats<Tag>().live_bytes) / 1024, "KB");
+}
+
+void testVectorGrowthPolicyEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "vector growth policy");
+    constexpr int n = 10000000;
+    util.startGroup("push_back");
+    growthPolicyPushBack<tstd::vector_growth_2x>(util, "vector_growth_2x", n);
+    growthPolicyPushBack<tstd::vector_growth_1_5x>(util, "vector_growth_1_5x", n);
+    growthPolicyPushBack<tstd::vector_growth_page<>>(util, "vector_growth_page", n);
+    growthPolicyPushBack<tstd::vector_auto_shrink<>>(util, "vector_auto_shrink", n);
+    util.startGroup("erase");
+    growthPolicyErase<tstd::vector_growth_2x>(util, "vector_growth_2x", n);
+    growthPolicyErase<tstd::vector_growth_1_5x>(util, "vector_growth_1_5x", n);
+    growthPolicyErase<tstd::vector_auto_shrink<>>(util, "vector_auto_shrink", n);
+    growthPolicyErase<tstd::vector_auto_shrink<tstd::vector_growth_1_5x>>(util, "vector_auto_shrink<1.5x>", n);
+    util.showFinalResult();
+}
+
+// algorithms of std and tstd, to test containers with their own algorithms
+struct StdAlgorithms
+{
+    template<typename... Args> static auto count(Args... args) { return std::count(args...); }
+    template<typename... Args> static auto find(Args... args) { return std::find(args...); }
+    template<typename... Args> static auto fill(Args... args) { return std::fill(args...); }
+    template<typename... Args> static auto copy(Args... args) { return std::copy(args...); }
+    template<typename... Args> static auto for_each(Args... args) { return std::for_each(args...); }
+    template<typename... Args> static auto accumulate(Args... args) { return std::accumulate(args...); }
+};
+struct TstdAlgorithms
+{
+    template<typename... Args> static auto count(Args... args) { return tstd::count(args...); }
+    template<typename... Args> static auto find(Args... args) { return tstd::find(args...); }
+    template<typename... Args> static auto fill(Args... args) { return tstd::fill(args...); }
+    template<typename... Args> static auto copy(Args... args) { return tstd::copy(args...); }
+    template<typename... Args> static auto for_each(Args... args) { return tstd::for_each(args...); }
+    template<typename... Args> static auto accumulate(Args... args) { return tstd::accumulate(args...); }
+};
+
+// a bitmap of n flags: build, count, find a sparse flag, fill and copy unaligned ranges
+template<typename Vector, typename Algorithms>
+void bitmapOperations(EfficiencyTestUtil& util, const std::string& name, std::size_t n)
+{
+    Vector bitmap;
+    util.measure("push_back " + std::to_string(n) + ", " + name, [&]() {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            bitmap.push_back(i % 3 == 0);
+        }
+        doNotOptimizeAway(bitmap.size());
+    });
+    util.showValue("memory, " + name, double(bitmap.capacity() * sizeof(typename Vector::value_type) / (std::is_same_v<typename Vector::value_type, bool> ? 8 : 1)) / 1024 / 1024, "MB");
+    util.measure("count 10 times, " + name, [&]() {
+        std::ptrdiff_t total = 0;
+        for (int i = 0; i < 10; ++i)
+        {
+            total += Algorithms::count(bitmap.begin() + i, bitmap.end(), true);
+        }
+        doNotOptimizeAway(total);
+    });
+    Algorithms::fill(bitmap.begin(), bitmap.end(), false);
+    bitmap[n - 1] = true;
+    util.measure("find last flag 10 times, " + name, [&]() {
+        std::ptrdiff_t total = 0;
+        for (int i = 0; i < 10; ++i)
+        {
+            total += Algorithms::find(bitmap.begin() + i, bitmap.end(), true) - bitmap.begin();
+        }
+        doNotOptimizeAway(total);
+    });
+    util.measure("fill 10 times, " + name, [&]() {
+        for (int i = 0; i < 10; ++i)
+        {
+            Algorithms::fill(bitmap.begin() + i, bitmap.end() - i, i % 2 == 0);
+        }
+        doNotOptimizeAway(bitmap.back());
+    });
+    Vector target(n, false);
+    util.measure("copy to unaligned position 10 times, " + name, [&]() {
+        for (int i = 0; i < 10; ++i)
+        {
+            Algorithms::copy(bitmap.begin(), bitmap.end() - 10, target.begin() + i + 1);
+        }
+        doNotOptimizeAway(target.back());
+    });
+}
+
+void testVectorBoolEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "vector<bool>");
+    constexpr std::size_t n = 100000000;
+    util.startGroup("bitmap of " + std::to_string(n) + " flags");
+    bitmapOperations<std::vector<bool>, StdAlgorithms>(util, "std::vector<bool>", n);
+    bitmapOperations<tstd::vector<bool>, TstdAlgorithms>(util, "tstd::vector<bool>", n);
+    bitmapOperations<tstd::vector<char>, TstdAlgorithms>(util, "tstd::vector<char>", n);
+    util.showFinalResult();
+}
+
+// fill a fresh I/O buffer of bytes from a source block, many times
+template<typename Vector>
+void ioBufferFill(EfficiencyTestUtil& util, const std::string& name, const std::vector<char>& block, bool forOverwrite)
+{
+    util.measure(std::string(forOverwrite ? "resize_for_overwrite" : "resize") + " and fill 64KB buffers 10000 times, " + name, [&]() {
+        std::size_t total = 0;
+        for (int i = 0; i < 10000; ++i)
+        {
+            Vector buf;
+            if constexpr (requires { buf.resize_for_overwrite(block.size()); })
+            {
+                if (forOverwrite)
+                {
+                    buf.resize_for_overwrite(block.size());
+                }
+                else
+                {
+                    buf.resize(block.size());
+                }
+            }
+            else
+            {
+                buf.resize(block.size());
+            }
+            std::memcpy(buf.data(), block.data(), block.size());
+            total += static_cast<unsigned char>(buf[i % block.size()]);
+        }
+        doNotOptimizeAway(total);
+    });
+}
+
+// refill a reused scratch buffer of n floats many times, with or without capacity checks
+template<typename Vector>
+void scratchAppend(EfficiencyTestUtil& util, const std::string& name, int n, bool unchecked)
+{
+    util.measure(std::string(unchecked ? "push_back_unchecked " : "push_back ") + std::to_string(n) + " floats 1000 times, " + name, [&]() {
+        Vector vec;
+        vec.reserve(n);
+        for (int round = 0; round < 1000; ++round)
+        {
+            vec.clear();
+            for (int i = 0; i < n; ++i)
+            {
+                if constexpr (requires { vec.push_back_unchecked(1.0f); })
+                {
+                    if (unchecked)
+                    {
+                        vec.push_back_unchecked(static_cast<float>(i + round) * 0.5f);
+                        continue;
+                    }
+                }
+                vec.push_back(static_cast<float>(i + round) * 0.5f);
+            }
+            doNotOptimizeAway(vec.data());
+        }
+    });
+}
+
+void testVectorForOverwriteEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "vector resize_for_overwrite/push_back_unchecked");
+    std::vector<char> block(65536, 'x');
+    util.startGroup("I/O buffer");
+    ioBufferFill<std::vector<char>>(util, "std::vector", block, false);
+    ioBufferFill<tstd::vector<char>>(util, "tstd::vector", block, false);
+    ioBufferFill<tstd::vector<char>>(util, "tstd::vector", block, true);
+    util.startGroup("scratch buffer");
+    constexpr int n = 100000;
+    scratchAppend<std::vector<float>>(util, "std::vector", n, false);
+    scratchAppend<tstd::vector<float>>(util, "tstd::vector", n, false);
+    scratchAppend<tstd::vector<float>>(util, "tstd::vector", n, true);
+    util.showFinalResult();
+}
+
+void testStaticVectorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "static_vector");
+    for (int size : {1, 4, 16, 64})
+    {
+        util.startGroup("size " + std::to_string(size));
+        tinyVectors<std::vector<int>>(util, "std::vector", size);
+        tinyVectors<tstd::small_vector<int, 16>>(util, "tstd::small_vector<int, 16>", size);
+        tinyVectors<tstd::static_vector<int, 64>>(util, "tstd::static_vector<int, 64>", size);
+    }
+    util.showFinalResult();
+}
+
+// a record of 64 bytes, queries only read quantity and price
+struct Order
+{
+    long long id;
+    int quantity;
+    int flags;
+    double price;
+    double fee;
+    char symbol[24];
+};
+
+void testSoaVectorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "soa_vector");
+    constexpr int n = 10000000;
+    tstd::vector<Order> aos;
+    tstd::soa_vector<long long, int, int, double, double, std::array<char, 24>> soa;
+    util.startGroup(std::to_string(n) + " orders");
+    util.measure("push_back, tstd::vector<Order>", [&]() {
+        for (int i = 0; i < n; ++i)
+        {
+            aos.push_back(Order{i, i % 100, 0, i * 0.25, 0.0, {}});
+        }
+        doNotOptimizeAway(aos.data());
+    });
+    util.measure("emplace_back, tstd::soa_vector", [&]() {
+        for (int i = 0; i < n; ++i)
+        {
+            soa.emplace_back(i, i % 100, 0, i * 0.25, 0.0, std::array<char, 24>{});
+        }
+        doNotOptimizeAway(soa.data<0>());
+    });
+    util.startGroup("sum price where quantity < 10, 10 times");
+    util.measure("tstd::vector<Order>", [&]() {
+        double total = 0;
+        for (int round = 0; round < 10; ++round)
+        {
+            total += tstd::transform_reduce(aos.begin(), aos.end(), 0.0, std::plus<double>(),
+                [](const Order& order) { return order.quantity < 10 ? order.price : 0.0; });
+        }
+        doNotOptimizeAway(total);
+    });
+    util.measure("tstd::soa_vector, columns", [&]() {
+        double total = 0;
+        auto quantity = soa.column<1>();
+        auto price = soa.column<3>();
+        for (int round = 0; round < 10; ++round)
+        {
+            total += tstd::transform_reduce(quantity.begin(), quantity.end(), price.begin(), 0.0, std::plus<double>(),
+                [](int q, double p) { return q < 10 ? p : 0.0; });
+        }
+        doNotOptimizeAway(total);
+    });
+    util.measure("tstd::soa_vector, rows", [&]() {
+        double total = 0;
+        for (int round = 0; round < 10; ++round)
+        {
+            total += tstd::transform_reduce(soa.begin(), soa.end(), 0.0, std::plus<double>(),
+                [](const auto& row) { return row.template get<1>() < 10 ? row.template get<3>() : 0.0; });
+        }
+        doNotOptimizeAway(total);
+    });
+    util.showFinalResult();
+}
+
+// compare equal vectors, vectors differing at the last element and vectors of different sizes, 100 times each
+template<typename Vector>
+void vectorComparisons(EfficiencyTestUtil& util, const std::string& name, std::size_t n)
+{
+    using T = typename Vector::value_type;
+    Vector v1(n, T(7));
+    Vector v2(v1);
+    Vector v3(v1);
+    v3[n - 1] = T(8);
+    Vector v4(v1);
+    v4.pop_back();
+    util.measure("==, " + name, [&]() {
+        int count = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            count += (v1 == v2) + (v1 == v3) + (v1 == v4);
+            doNotOptimizeAway(count); // clobber memory, the comparisons are not hoisted
+        }
+        doNotOptimizeAway(count);
+    });
+    util.measure("<, " + name, [&]() {
+        int count = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            count += (v1 < v2) + (v1 < v3) + (v4 < v1);
+            doNotOptimizeAway(count);
+        }
+        doNotOptimizeAway(count);
+    });
+}
+
+void testVectorComparisonEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "vector comparisons");
+    constexpr std::size_t n = 1 << 20;
+    util.startGroup(std::to_string(n) + " unsigned chars");
+    vectorComparisons<std::vector<unsigned char>>(util, "std::vector", n);
+    vectorComparisons<tstd::vector<unsigned char>>(util, "tstd::vector", n);
+    util.startGroup(std::to_string(n) + " ints");
+    vectorComparisons<std::vector<int>>(util, "std::vector", n);
+    vectorComparisons<tstd::vector<int>>(util, "tstd::vector", n);
+    util.showFinalResult();
+}
+
+// push_back n elements, report peak memory against the bytes of elements
+template<template<typename> typename Vector, typename T, typename Gen>
+void segmentedVectorPushBack(EfficiencyTestUtil& util, const std::string& name, int n, Gen&& gen)
+{
+    struct Tag {};
+    tstd::reset_allocation_stats<Tag>();
+    util.measure("push_back, " + name, [&]() {
+        Vector<tstd::counting_allocator<T, Tag>> vec;
+        for (int i = 0; i < n; ++i)
+        {
+            vec.push_back(gen(i));
+        }
+        doNotOptimizeAway(&vec.back());
+    });
+    auto stats = tstd::get_allocation_stats<Tag>();
+    util.showValue("peak memory / element bytes, " + name, double(stats.peak_live_bytes) / (double(n) * sizeof(T)), "");
+}
+
+template<typename Vector>
+void segmentedVectorTraverse(EfficiencyTestUtil& util, const std::string& name, int n)
+{
+    Vector vec(n, 1);
+    util.measure("indexing, " + name, [&]() {
+        long long sum = 0;
+        for (int round = 0; round < 10; ++round)
+        {
+            for (std::size_t i = 0; i < vec.size(); ++i)
+            {
+                sum += vec[i];
+            }
+        }
+        doNotOptimizeAway(sum);
+    });
+    util.measure("iterating, " + name, [&]() {
+        long long sum = 0;
+        for (int round = 0; round < 10; ++round)
+        {
+            for (int x : vec)
+            {
+                sum += x;
+            }
+        }
+        doNotOptimizeAway(sum);
+    });
+}
+
+template<typename Alloc> using IntVector = tstd::vector<int, Alloc>;
+template<typename Alloc> using IntSegmentedVector = tstd::segmented_vector<int, tstd::impl::segmented_vector_chunk_size<int>, Alloc>;
+template<typename Alloc> using StringVector = tstd::vector<std::string, Alloc>;
+template<typename Alloc> using StringSegmentedVector = tstd::segmented_vector<std::string, tstd::impl::segmented_vector_chunk_size<std::string>, Alloc>;
+
+void testSegmentedVectorEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "segmented_vector");
+    constexpr int n = 10000000;
+    util.startGroup("push_back " + std::to_string(n) + " ints");
+    auto makeInt = [](int i) { return i; };
+    segmentedVectorPushBack<IntVector, int>(util, "tstd::vector", n, makeInt);
+    segmentedVectorPushBack<IntSegmentedVector, int>(util, "tstd::segmented_vector", n, makeInt);
+    util.startGroup("push_back " + std::to_string(n / 10) + " strings");
+    auto makeString = [](int i) { return std::to_string(i); };
+    segmentedVectorPushBack<StringVector, std::string>(util, "tstd::vector", n / 10, makeString);
+    segmentedVectorPushBack<StringSegmentedVector, std::string>(util, "tstd::segmented_vector", n / 10, makeString);
+    util.startGroup("traverse " + std::to_string(n) + " ints");
+    segmentedVectorTraverse<tstd::vector<int>>(util, "tstd::vector", n);
+    segmentedVectorTraverse<tstd::segmented_vector<int>>(util, "tstd::segmented_vector", n);
+    util.showFinalResult();
+}
+
+// element of given bytes for deque block size tests
+template<std::size_t Bytes>
+struct DequeElement
+{
+    int value;
+    char padding[Bytes - sizeof(int)];
+    DequeElement(int i = 0) : value(i) {}
+};
+template<>
+struct DequeElement<1>
+{
+    char value;
+    DequeElement(int i = 0) : value(static_cast<char>(i)) {}
+};
+template<>
+struct DequeElement<sizeof(int)>
+{
+    int value;
+    DequeElement(int i = 0) : value(i) {}
+};
+
+template<typename Deque>
+void dequeOperations(EfficiencyTestUtil& util, const std::string& name, int n)
+{
+    Deque dq;
+    util.measure("push_back, " + name, [&]() {
+        for (int i = 0; i < n; ++i)
+        {
+            dq.push_back(i);
+        }
+        doNotOptimizeAway(&dq.back());
+    });
+    std::vector<std::size_t> indices(n);
+    std::mt19937 gen(5);
+    for (auto& index : indices)
+    {
+        index = gen() % n;
+    }
+    util.measure("random access, " + name, [&]() {
+        long long sum = 0;
+        for (std::size_t index : indices)
+        {
+            sum += dq[index].value;
+        }
+        doNotOptimizeAway(sum);
+    });
+    util.measure("pop_front, " + name, [&]() {
+        while (!dq.empty())
+        {
+            dq.pop_front();
+        }
+        doNotOptimizeAway(&dq);
+    });
+}
+
+template<std::size_t Bytes>
+void dequeBlockSizes(EfficiencyTestUtil& util, int n)
+{
+    using T = DequeElement<Bytes>;
+    util.startGroup(std::to_string(n) + " elements of " + std::to_string(Bytes) + " bytes");
+    dequeOperations<std::deque<T>>(util, "std::deque", n);
+    dequeOperations<tstd::deque<T, tstd::allocator<T>, 64 * sizeof(T)>>(util, "tstd::deque, 64 elements", n);
+    dequeOperations<tstd::deque<T, tstd::allocator<T>, 512>>(util, "tstd::deque, 512 bytes", n);
+    dequeOperations<tstd::deque<T>>(util, "tstd::deque, 4096 bytes", n);
+    dequeOperations<tstd::deque<T, tstd::allocator<T>, 65536>>(util, "tstd::deque, 65536 bytes", n);
+}
+
+void testDequeBlockSizeEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "deque block size");
+    dequeBlockSizes<1>(util, 10000000);
+    dequeBlockSizes<4>(util, 10000000);
+    dequeBlockSizes<64>(util, 1000000);
+    dequeBlockSizes<1024>(util, 100000);
+    util.showFinalResult();
+}
+
+// queue of steady length: push one and pop one, buffers are freed at front and allocated at back
+template<typename Deque>
+void queueChurn(EfficiencyTestUtil& util, const std::string& name, int length, int n)
+{
+    Deque dq(length, 1);
+    util.measure("push_back and pop_front, " + name, [&]() {
+        long long sum = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            dq.push_back(i);
+            sum += dq.front();
+            dq.pop_front();
+        }
+        doNotOptimizeAway(sum);
+    });
+}
+
+void testDequeQueueChurnEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "deque as queue");
+    struct Tag {};
+    constexpr int n = 10000000;
+    for (int length : {10, 1000, 100000})
+    {
+        util.startGroup("queue of " + std::to_string(length) + " ints");
+        queueChurn<std::deque<int>>(util, "std::deque", length, n);
+        queueChurn<tstd::deque<int>>(util, "tstd::deque", length, n);
+        tstd::reset_allocation_stats<Tag>();
+        queueChurn<tstd::deque<int, tstd::counting_allocator<int, Tag>>>(util, "tstd::deque with counting_allocator", length, n);
+        util.showValue("allocations, tstd::deque", double(tstd::get_allocation_stats<Tag>().allocations), "");
+    }
+    util.showFinalResult();
+}
+
+// algorithms over a whole deque, tstd algorithms run per buffer on iterators of tstd::deque
+template<typename Deque, typename Algorithms>
+void dequeAlgorithms(EfficiencyTestUtil& util, const std::string& name, int n)
+{
+    using T = typename Deque::value_type;
+    Deque dq(n, T(1));
+    std::vector<T> buffer(n, T(2));
+    util.measure("count, " + name, [&]() {
+        for (int i = 0; i < 10; ++i)
+        {
+            doNotOptimizeAway(Algorithms::count(dq.begin(), dq.end(), T(2)));
+        }
+    });
+    util.measure("find, " + name, [&]() {
+        for (int i = 0; i < 10; ++i)
+        {
+            doNotOptimizeAway(&*Algorithms::find(dq.begin(), dq.end() - 1, T(2)));
+        }
+    });
+    util.measure("accumulate, " + name, [&]() {
+        for (int i = 0; i < 10; ++i)
+        {
+            doNotOptimizeAway(Algorithms::accumulate(dq.begin(), dq.end(), 0LL));
+        }
+    });
+    util.measure("for_each, " + name, [&]() {
+        long long sum = 0;
+        for (int i = 0; i < 10; ++i)
+        {
+            Algorithms::for_each(dq.begin(), dq.end(), [&sum](T x) { sum += x; });
+        }
+        doNotOptimizeAway(sum);
+    });
+    util.measure("fill, " + name, [&]() {
+        for (int i = 0; i < 10; ++i)
+        {
+            Algorithms::fill(dq.begin(), dq.end(), T(i));
+            doNotOptimizeAway(&dq.back());
+        }
+    });
+    util.measure("copy to vector, " + name, [&]() {
+        for (int i = 0; i < 10; ++i)
+        {
+            Algorithms::copy(dq.begin(), dq.end(), buffer.begin());
+            doNotOptimizeAway(buffer.data());
+        }
+    });
+    util.measure("copy from vector, " + name, [&]() {
+        for (int i = 0; i < 10; ++i)
+        {
+            Algorithms::copy(buffer.begin(), buffer.end(), dq.begin());
+            doNotOptimizeAway(&dq.back());
+        }
+    });
+}
+
+void testDequeAlgorithmsEfficiency(bool showDetails)
+{
+    EfficiencyTestUtil util(showDetails, "algorithms on deque");
+    constexpr int n = 10000000;
+    util.startGroup(std::to_string(n) + " ints");
+    dequeAlgorithms<std::deque<int>, StdAlgorithms>(util, "std::deque, std algorithms", n);
+    dequeAlgorithms<tstd::deque<int>, StdAlgorithms>(util, "tstd::deque, std algorithms", n);
+    dequeAlgorithms<tstd::deque<int>, TstdAlgorithms>(util, "tstd::deque, tstd algorithms", n);
+    util.startGroup(std::to_string(n) + " chars");
+    dequeAlgorithms<std::deque<char>, StdAlgorithms>(util, "std::deque, std algorithms", n);
+    dequeAlgorithms<tstd::deque<char>, StdAlgorithms>(util, "tstd::deque, std algorithms", n);
+    dequeAlgorithms<tstd::deque<char>, TstdAlgorithms>(util, "tstd::deque, tstd algorithms", n);
+    util.showFinalResult();
+}
@@ -0,0 +1,90 @@
+#ifndef EFFICIENCYTESTUTIL_HPP
+#define EFFICIENCYTESTUTIL_HPP
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <utility>
+
+// prevent compiler from optimizing away the result of a computation
+template<typename T>
+inline void doNotOptimizeAway(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// efficiency test utilities
+// every case is measured once, time of first case of a group is the baseline of the group.
+class EfficiencyTestUtil
+{
+public:
+    EfficiencyTestUtil(bool _show, const std::string& _target, int _nameWidth = 60)
+        : showDetails(_show)
+        , target(_target)
+        , nameWidth(_nameWidth)
+    {
+        std::cout << "Efficiency test of " << target << ": " << std::endl;
+    }
+
+    // start a new group of cases, later cases of the group are compared with the first one
+    void startGroup(const std::string& group)
+    {
+        baseline = -1.0;
+        std::cout << "  " << group << std::endl;
+    }
+
+    bool detailed() const
+    {
+        return showDetails;
+    }
+
+    // measure the time of calling f, return the time in milliseconds
+    template<typename Func>
+    double measure(const std::string& name, Func&& f)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        std::forward<Func>(f)();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+        if (baseline < 0)
+        {
+            baseline = ms;
+        }
+        results.emplace_back(name, ms);
+        std::cout << std::fixed << std::setprecision(3)
+            << "    " << std::left << std::setw(nameWidth) << name << std::right
+            << std::setw(12) << ms << " ms";
+        if (baseline > 0)
+        {
+            std::cout << std::setw(10) << std::setprecision(2) << ms / baseline << "x";
+        }
+        std::cout << std::endl;
+        std::cout << std::defaultfloat;
+        return ms;
+    }
+
+    // show a measured value other than time (e.g. bytes per element), not compared with the baseline
+    void showValue(const std::string& name, double value, const std::string& unit)
+    {
+        std::cout << std::fixed << std::setprecision(3)
+            << "    " << std::left << std::setw(nameWidth) << name << std::right
+            << std::setw(12) << value << " " << unit << std::endl;
+        std::cout << std::defaultfloat;
+    }
+
+    void showFinalResult()
+    {
+        std::cout << "Efficiency test of " << target << ": " << results.size() << " cases measured" << std::endl;
+        std::cout << std::endl;
+    }
+private:
+    bool showDetails;
+    std::string target;
+    int nameWidth;
+    double baseline = -1.0;
+    std::vector<std::pair<std::string, double>> results;
+};
+
+#endif
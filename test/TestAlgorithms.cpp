@@ -10,6 +10,8 @@
 #include <talgorithm.hpp>
 #include <tnumeric.hpp>
 #include <tvector.hpp>
+#include <tdeque.hpp>
+#include <tsegmented_vector.hpp>
 #include "TestUtil.hpp"
 
 void testNumericAlgorithms(bool showDetails);
@@ -24,6 +26,7 @@ void testHeapAlgorithms(bool showDetails);
 void testMinimumMaximumAlgorithms(bool showDetails);
 void testComparisonAlgorithms(bool showDetails);
 void testPermutationAlgorithms(bool showDetails);
+void testSegmentedIteratorAlgorithms(bool showDetails);
 
 int main(int argc, char const *argv[])
 {
@@ -42,6 +45,7 @@ int main(int argc, char const *argv[])
     testMinimumMaximumAlgorithms(showDetails);
     testComparisonAlgorithms(showDetails);
     testPermutationAlgorithms(showDetails);
+    testSegmentedIteratorAlgorithms(showDetails);
     std::cout << std::endl;
     return 0;
 }
@@ -1649,6 +1653,54 @@ void testComparisonAlgorithms(bool showDetails)
         res2 = tstd::lexicographical_compare_three_way(tmp1.begin(), tmp1.end(), tmp2.begin(), tmp2.end());
         util.assertEqual(res1 == res2, true);
     }
+    // ranges of different lengths
+    {
+        std::vector<int> tmp(vec.begin(), vec.begin() + 50);
+        util.assertEqual(tstd::equal(vec.begin(), vec.end(), tmp.begin(), tmp.end()), false);
+        util.assertEqual(tstd::equal(tmp.begin(), tmp.end(), vec.begin(), vec.end(), std::equal_to<int>()), false);
+        util.assertEqual(tstd::lexicographical_compare(tmp.begin(), tmp.end(), vec.begin(), vec.end()), true);
+        util.assertEqual(tstd::lexicographical_compare(vec.begin(), vec.end(), tmp.begin(), tmp.end()), false);
+    }
+    // memcmp on pointers to integers, compared with std on random ranges
+    {
+        auto check = [&util]<typename T>(T*) {
+            std::mt19937 rng(11);
+            bool ok = true;
+            std::vector<T> a;
+            std::vector<T> b;
+            for (int i = 0; i < 1000; ++i)
+            {
+                a.resize(rng() % 700);
+                for (auto& x : a)
+                {
+                    x = static_cast<T>(rng() % 4 == 0 ? rng() : 1);
+                }
+                b.assign(a.begin(), a.begin() + rng() % (a.size() + 1));
+                if (!b.empty() && rng() % 2)
+                {
+                    b[rng() % b.size()] = static_cast<T>(rng());
+                }
+                const T* pa = a.data();
+                const T* pb = b.data();
+                ok = ok && tstd::equal(pa, pa + a.size(), pb, pb + b.size()) == std::equal(pa, pa + a.size(), pb, pb + b.size());
+                ok = ok && (b.size() > a.size() || tstd::equal(pb, pb + b.size(), pa) == std::equal(pb, pb + b.size(), pa));
+                ok = ok && tstd::lexicographical_compare(pa, pa + a.size(), pb, pb + b.size()) == std::lexicographical_compare(pa, pa + a.size(), pb, pb + b.size());
+                ok = ok && tstd::lexicographical_compare(pb, pb + b.size(), pa, pa + a.size()) == std::lexicographical_compare(pb, pb + b.size(), pa, pa + a.size());
+                ok = ok && tstd::lexicographical_compare_three_way(pa, pa + a.size(), pb, pb + b.size()) == std::lexicographical_compare_three_way(pa, pa + a.size(), pb, pb + b.size());
+            }
+            util.assertEqual(ok, true);
+        };
+        check(static_cast<unsigned char*>(nullptr));
+        check(static_cast<signed char*>(nullptr));
+        check(static_cast<int*>(nullptr));
+        check(static_cast<unsigned long long*>(nullptr));
+        static_assert([]() {
+            int a[] = {1, 2, -3};
+            int b[] = {1, 2, 3};
+            return !tstd::equal(a, a + 3, b) && tstd::lexicographical_compare(a, a + 3, b, b + 3)
+                && tstd::lexicographical_compare_three_way(b, b + 3, a, a + 3) > 0;
+        }());
+    }
     util.showFinalResult();
 }
 
@@ -1731,4 +1783,119 @@ void testPermutationAlgorithms(bool showDetails)
         }
     }
     util.showFinalResult();
-}
\ No newline at end of file
+}
+// compare algorithms on segmented iterators with std algorithms on a std::vector of same elements,
+// for subranges starting and ending at any position of segments
+template<typename Container>
+bool segmentedAlgorithmsLikeStd(Container& cont)
+{
+    using T = typename Container::value_type;
+    std::vector<T> vec(cont.begin(), cont.end());
+    std::mt19937 rng(3);
+    bool ok = true;
+    for (int round = 0; round < 200; ++round)
+    {
+        std::size_t first = rng() % (vec.size() + 1);
+        std::size_t last = first + rng() % (vec.size() - first + 1);
+        auto cfirst = cont.begin() + first;
+        auto clast = cont.begin() + last;
+        T value = vec[rng() % vec.size()];
+        ok = ok && tstd::count(cfirst, clast, value) == std::count(vec.begin() + first, vec.begin() + last, value);
+        ok = ok && tstd::find(cfirst, clast, value) - cont.begin() == std::find(vec.begin() + first, vec.begin() + last, value) - vec.begin();
+        ok = ok && tstd::accumulate(cfirst, clast, 0LL) == std::accumulate(vec.begin() + first, vec.begin() + last, 0LL);
+        ok = ok && tstd::accumulate(cfirst, clast, 0LL, std::minus<long long>()) == std::accumulate(vec.begin() + first, vec.begin() + last, 0LL, std::minus<long long>());
+        long long sum = 0;
+        tstd::for_each(cfirst, clast, [&sum](const T& x) { sum += x; });
+        ok = ok && sum == std::accumulate(vec.begin() + first, vec.begin() + last, 0LL);
+        // segmented source
+        std::vector<T> out(last - first);
+        ok = ok && tstd::copy(cfirst, clast, out.begin()) == out.end();
+        ok = ok && std::equal(out.begin(), out.end(), vec.begin() + first);
+        // segmented destination
+        std::size_t dest = rng() % (vec.size() - out.size() + 1);
+        std::reverse(out.begin(), out.end());
+        ok = ok && tstd::copy(out.begin(), out.end(), cont.begin() + dest) == cont.begin() + dest + out.size();
+        std::copy(out.begin(), out.end(), vec.begin() + dest);
+        // fill
+        std::size_t fill_first = rng() % (vec.size() + 1);
+        std::size_t fill_last = fill_first + rng() % (vec.size() - fill_first + 1);
+        tstd::fill(cont.begin() + fill_first, cont.begin() + fill_last, T(round));
+        std::fill(vec.begin() + fill_first, vec.begin() + fill_last, T(round));
+        ok = ok && std::equal(vec.begin(), vec.end(), cont.begin());
+    }
+    return ok;
+}
+
+constexpr int constexprCopyAndFill()
+{
+    int a[4] = {1, 2, 3, 4};
+    int b[4] = {};
+    tstd::copy(a, a + 4, b);
+    tstd::fill(b, b + 2, 7);
+    return b[0] + b[1] + b[2] + b[3];
+}
+
+void testSegmentedIteratorAlgorithms(bool showDetails)
+{
+    TestUtil util(showDetails, "algorithms on segmented iterators");
+    static_assert(tstd::segmented_iterator<tstd::deque<int>::iterator>);
+    static_assert(tstd::segmented_iterator<tstd::deque<int>::const_iterator>);
+    static_assert(tstd::segmented_iterator<tstd::segmented_vector<int>::iterator>);
+    static_assert(!tstd::segmented_iterator<int*>);
+    static_assert(!tstd::segmented_iterator<std::vector<int>::iterator>);
+    static_assert(constexprCopyAndFill() == 21);
+    {
+        tstd::deque<int, tstd::allocator<int>, 64> dq; // 16 elements in a buffer
+        for (int i = 0; i < 500; ++i)
+        {
+            dq.push_back(i % 37);
+            dq.push_front(i % 11);
+        }
+        util.assertEqual(segmentedAlgorithmsLikeStd(dq), true);
+        const auto& cdq = dq;
+        util.assertEqual(tstd::count(cdq.begin(), cdq.end(), cdq[100]), std::count(cdq.begin(), cdq.end(), cdq[100]));
+        // deque to deque
+        tstd::deque<int, tstd::allocator<int>, 64> dq2(dq.size() + 5);
+        util.assertEqual(tstd::copy(dq.begin(), dq.end(), dq2.begin() + 5) == dq2.end(), true);
+        util.assertEqual(std::equal(dq.begin(), dq.end(), dq2.begin() + 5), true);
+    }
+    {
+        tstd::deque<unsigned char, tstd::allocator<unsigned char>, 16> dq(300, 1); // memset and memchr sized elements
+        util.assertEqual(segmentedAlgorithmsLikeStd(dq), true);
+    }
+    {
+        tstd::segmented_vector<int, 16> vec;
+        for (int i = 0; i < 1100; ++i)
+        {
+            vec.push_back(i * 7 % 101);
+        }
+        util.assertEqual(segmentedAlgorithmsLikeStd(vec), true);
+        tstd::segmented_vector<int, 16> vec2(1024, 1); // end() is at the begin of an unallocated chunk
+        util.assertEqual(tstd::find(vec2.begin(), vec2.end(), 2) == vec2.end(), true);
+        util.assertEqual(tstd::copy(vec.begin(), vec.begin() + 1024, vec2.begin()) == vec2.end(), true);
+        util.assertEqual(std::equal(vec2.begin(), vec2.end(), vec.begin()), true);
+    }
+    // contiguous fast paths
+    {
+        std::vector<int> src(1000);
+        std::iota(src.begin(), src.end(), 0);
+        std::vector<int> dst(1000);
+        util.assertEqual(tstd::copy(src.data(), src.data() + 1000, dst.data()) == dst.data() + 1000, true);
+        util.assertSequenceEqual(dst, src);
+        std::string str(100, 'a');
+        tstd::fill(str.data() + 10, str.data() + 20, 'b');
+        util.assertEqual(str, std::string(10, 'a') + std::string(10, 'b') + std::string(80, 'a'));
+        bool found = true;
+        for (int x : {0, 5, 15, 16, 17, 300, 998, 999, 1000, -1})
+        {
+            found = found && tstd::find(src.data(), src.data() + 1000, x) == std::find(src.data(), src.data() + 1000, x);
+            found = found && tstd::find(src.data() + 1, src.data() + 999, x) == std::find(src.data() + 1, src.data() + 999, x);
+        }
+        util.assertEqual(found, true);
+        util.assertEqual(tstd::find(str.data(), str.data() + 100, 'b') - str.data(), std::ptrdiff_t(10));
+        util.assertEqual(tstd::find(str.data(), str.data() + 10, 'b') - str.data(), std::ptrdiff_t(10));
+    }
+
+    // final result
+    util.showFinalResult();
+}
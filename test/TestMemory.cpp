@@ -1,18 +1,58 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <numeric>
 #include <unordered_map>
 #include <random>
+#include <map>
+#include <list>
+#include <deque>
+#include <thread>
+#include <filesystem>
+#include <stdexcept>
 #include <tmemory.hpp>
+#include <tlist.hpp>
+#include <tmap.hpp>
+#include <tset.hpp>
+#include <tunordered_map.hpp>
+#include <tunordered_set.hpp>
+#include <tvector.hpp>
+#include <tdeque.hpp>
+#include <talgorithm.hpp>
 #include "TestUtil.hpp"
 
 void testAllocator(bool showDetails);
 void testUnintialized(bool showDetails);
+void testPoolAllocator(bool showDetails);
+void testMemoryResource(bool showDetails);
+void testAlignedAllocator(bool showDetails);
+void testCountingAllocator(bool showDetails);
+void testThreadCacheAllocator(bool showDetails);
+void testMmapAllocator(bool showDetails);
+void testAllocateAtLeast(bool showDetails);
+void testUniquePtr(bool showDetails);
+void testSharedPtr(bool showDetails);
+void testSlabAllocator(bool showDetails);
+void testMappedFileAllocator(bool showDetails);
+void testInlineArenaAllocator(bool showDetails);
 
 int main(int argc, char const *argv[])
 {
     bool showDetails = parseDetailFlag(argc, argv);
     testAllocator(showDetails);
     testUnintialized(showDetails);
+    testPoolAllocator(showDetails);
+    testMemoryResource(showDetails);
+    testAlignedAllocator(showDetails);
+    testCountingAllocator(showDetails);
+    testThreadCacheAllocator(showDetails);
+    testMmapAllocator(showDetails);
+    testAllocateAtLeast(showDetails);
+    testUniquePtr(showDetails);
+    testSharedPtr(showDetails);
+    testSlabAllocator(showDetails);
+    testMappedFileAllocator(showDetails);
+    testInlineArenaAllocator(showDetails);
     std::cout << std::endl;
     return 0;
 }
@@ -65,6 +105,23 @@ void testAllocator(bool showDetails)
 }
 
 // uninitilized memory operations
+// the construction after constructions_left constructions throws, live counts objects alive
+struct ThrowingConstruct
+{
+    static inline int live = 0;
+    static inline int constructions_left = 0;
+    ThrowingConstruct()
+    {
+        if (constructions_left-- == 0)
+        {
+            throw std::runtime_error("construct");
+        }
+        ++live;
+    }
+    ThrowingConstruct(const ThrowingConstruct&) : ThrowingConstruct() {}
+    ~ThrowingConstruct() { --live; }
+};
+
 void testUnintialized(bool showDetails)
 {
     TestUtil util(showDetails, "unintialized algorithms");
@@ -86,6 +143,1362 @@ void testUnintialized(bool showDetails)
     tstd::uninitialized_fill_n(pi, 3, 100);
     vec = {100, 100, 100};
     util.assertRangeEqual(vec.begin(), vec.end(), pi);
+    ::operator delete(p);
+
+    // trivially copyable types on pointers (memmove/memset path)
+    {
+        struct Point { int x; double y; };
+        const Point src[4] = {{1, 1.0}, {2, 2.0}, {3, 3.0}, {4, 4.0}};
+        Point* dest = static_cast<Point*>(::operator new(4 * sizeof(Point)));
+        util.assertEqual(tstd::uninitialized_copy(src, src + 4, dest), dest + 4);
+        util.assertEqual(dest[3].x == 4 && dest[3].y == 4.0, true);
+        util.assertEqual(tstd::uninitialized_move_n(src, 0, dest), dest); // copy nothing
+        ::operator delete(dest);
+
+        double d1[5] = {1.0, 2.0, 3.0, 4.0, 5.0};
+        double* d2 = static_cast<double*>(::operator new(5 * sizeof(double)));
+        util.assertEqual(tstd::uninitialized_move(d1, d1 + 5, d2), d2 + 5);
+        util.assertRangeEqual(d1, d1 + 5, d2);
+        util.assertEqual(tstd::uninitialized_copy_n(d1 + 1, 3, d2), d2 + 3);
+        util.assertRangeEqual(d1 + 1, d1 + 4, d2);
+        ::operator delete(d2);
+
+        char* buf = static_cast<char*>(::operator new(16));
+        tstd::uninitialized_fill(buf, buf + 16, 'x');
+        util.assertEqual(std::string(buf, 16), std::string(16, 'x'));
+        util.assertEqual((void*)tstd::uninitialized_fill_n(buf, 8, 'y'), (void*)(buf + 8));
+        util.assertEqual(std::string(buf, 16), std::string(8, 'y') + std::string(8, 'x'));
+        bool* bits = reinterpret_cast<bool*>(buf);
+        tstd::uninitialized_fill_n(bits, 16, true);
+        util.assertEqual(std::all_of(bits, bits + 16, [](bool b) { return b; }), true);
+        ::operator delete(buf);
+    }
+
+    // non-trivial types still construct elements one by one
+    {
+        const std::vector<std::string> expected{"hello", "world", "tstd"};
+        std::vector<std::string> strs = expected;
+        std::string* dest = static_cast<std::string*>(::operator new(3 * sizeof(std::string)));
+        tstd::uninitialized_copy(strs.data(), strs.data() + 3, dest);
+        util.assertRangeEqual(strs.begin(), strs.end(), dest);
+        tstd::destroy(dest, dest + 3);
+        tstd::uninitialized_move(strs.data(), strs.data() + 3, dest);
+        util.assertRangeEqual(expected.begin(), expected.end(), dest);
+        tstd::destroy(dest, dest + 3);
+        tstd::uninitialized_default_construct(dest, dest + 2);
+        util.assertEqual(tstd::uninitialized_default_construct_n(dest + 2, 1), dest + 3);
+        util.assertEqual(dest[0].empty() && dest[2].empty(), true);
+        tstd::destroy(dest, dest + 3);
+        ::operator delete(dest);
+        int* ints = static_cast<int*>(::operator new(4 * sizeof(int)));
+        util.assertEqual(tstd::uninitialized_default_construct_n(ints, 4), ints + 4); // nothing is written
+        ::operator delete(ints);
+    }
+
+    // constructed elements are destroyed when a constructor throws
+    {
+        auto throws = [](auto&& construct) {
+            try
+            {
+                construct();
+            }
+            catch (const std::runtime_error&)
+            {
+                return true;
+            }
+            return false;
+        };
+        ThrowingConstruct* dest = static_cast<ThrowingConstruct*>(::operator new(4 * sizeof(ThrowingConstruct)));
+        ThrowingConstruct::constructions_left = 2;
+        util.assertEqual(throws([&]() { tstd::uninitialized_default_construct(dest, dest + 4); }), true);
+        util.assertEqual(ThrowingConstruct::live, 0);
+        ThrowingConstruct::constructions_left = 3;
+        util.assertEqual(throws([&]() { tstd::uninitialized_default_construct_n(dest, 4); }), true);
+        util.assertEqual(ThrowingConstruct::live, 0);
+        ThrowingConstruct::constructions_left = 2;
+        ThrowingConstruct value;
+        util.assertEqual(throws([&]() { tstd::uninitialized_fill_n(dest, 4, value); }), true);
+        util.assertEqual(ThrowingConstruct::live, 1);
+        ::operator delete(dest);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+
+// pool allocator
+void testPoolAllocator(bool showDetails)
+{
+    TestUtil util(showDetails, "pool allocator");
+
+    // allocation of all size classes and large blocks
+    {
+        tstd::pool_allocator<char> alloc;
+        std::vector<std::pair<char*, std::size_t>> blocks;
+        for (std::size_t n = 0; n <= 300; ++n)
+        {
+            char* p = alloc.allocate(n);
+            std::fill(p, p + n, (char)n);
+            blocks.emplace_back(p, n);
+        }
+        bool ok = true;
+        for (auto& [p, n] : blocks)
+        {
+            ok = ok && std::all_of(p, p + n, [n](char c) { return c == (char)n; });
+            alloc.deallocate(p, n);
+        }
+        util.assertEqual(ok, true);
+        // freed blocks are reused
+        char* p1 = alloc.allocate(24);
+        alloc.deallocate(p1, 24);
+        char* p2 = alloc.allocate(24);
+        util.assertEqual((void*)p1, (void*)p2);
+        alloc.deallocate(p2, 24);
+    }
+
+    // construction and destruction
+    {
+        std::vector<Foo, tstd::pool_allocator<Foo>> vec;
+        vec.emplace_back();
+        vec.emplace_back(1, 2, 3);
+        vec.emplace_back(2.0);
+        vec.pop_back();
+        util.assertEqual(Foo::count, 2);
+    }
+    util.assertEqual(Foo::count, 0);
+
+    // node containers
+    {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> dist(0, 1000);
+        tstd::list<int, tstd::pool_allocator<int>> l1;
+        std::list<int> l2;
+        tstd::map<int, std::string, std::less<int>, tstd::pool_allocator<std::pair<const int, std::string>>> m1;
+        std::map<int, std::string> m2;
+        tstd::unordered_map<int, int, std::hash<int>, std::equal_to<int>, tstd::pool_allocator<std::pair<const int, int>>> um1;
+        std::unordered_map<int, int> um2;
+        for (int i = 0; i < 10000; ++i)
+        {
+            int x = dist(gen);
+            if (x % 3 == 0 && !l2.empty())
+            {
+                l1.pop_front();
+                l2.pop_front();
+                m1.erase(x);
+                m2.erase(x);
+                um1.erase(x);
+                um2.erase(x);
+            }
+            else
+            {
+                l1.push_back(x);
+                l2.push_back(x);
+                m1[x] = std::to_string(x);
+                m2[x] = std::to_string(x);
+                um1[x] = x;
+                um2[x] = x;
+            }
+        }
+        util.assertSequenceEqual(l1, l2);
+        util.assertSequenceEqual(m1, m2);
+        util.assertSetEqual(um1, um2);
+    }
+
+    // equal
+    util.assertEqual(tstd::pool_allocator<int>() == tstd::pool_allocator<Foo>(), true);
+    util.assertEqual(tstd::pool_allocator<int>() != tstd::pool_allocator<Foo>(), false);
+
+    // final result
+    util.showFinalResult();
+}
+
+// memory resources and polymorphic allocator
+void testMemoryResource(bool showDetails)
+{
+    TestUtil util(showDetails, "memory resource");
+
+    // default resource
+    util.assertEqual(tstd::pmr::get_default_resource(), tstd::pmr::new_delete_resource());
+    util.assertEqual(tstd::pmr::set_default_resource(tstd::pmr::null_memory_resource()), tstd::pmr::new_delete_resource());
+    util.assertEqual(tstd::pmr::polymorphic_allocator<int>().resource(), tstd::pmr::null_memory_resource());
+    util.assertEqual(tstd::pmr::set_default_resource(nullptr), tstd::pmr::null_memory_resource());
+    util.assertEqual(tstd::pmr::get_default_resource(), tstd::pmr::new_delete_resource());
+
+    // monotonic buffer on stack, never touch upstream
+    {
+        alignas(std::max_align_t) char buffer[4096];
+        tstd::pmr::monotonic_buffer_resource mbr(buffer, sizeof(buffer), tstd::pmr::null_memory_resource());
+        tstd::pmr::vector<int> vec(&mbr);
+        vec.reserve(100);
+        for (int i = 0; i < 100; ++i)
+        {
+            vec.push_back(i);
+        }
+        bool inBuffer = (char*)vec.data() >= buffer && (char*)(vec.data() + vec.size()) <= buffer + sizeof(buffer);
+        util.assertEqual(inBuffer, true);
+        void* p = mbr.allocate(8, 64);
+        util.assertEqual(reinterpret_cast<std::uintptr_t>(p) % 64, std::uintptr_t(0));
+        bool thrown = false;
+        try
+        {
+            (void)mbr.allocate(8192);
+        }
+        catch (const std::bad_alloc&)
+        {
+            thrown = true;
+        }
+        util.assertEqual(thrown, true);
+    }
+
+    // monotonic buffer grows from upstream, release and reuse
+    {
+        tstd::pmr::monotonic_buffer_resource mbr(64);
+        std::vector<int*> ptrs;
+        for (int i = 0; i < 1000; ++i)
+        {
+            int* p = static_cast<int*>(mbr.allocate(sizeof(int), alignof(int)));
+            *p = i;
+            ptrs.push_back(p);
+        }
+        bool ok = true;
+        for (int i = 0; i < 1000; ++i)
+        {
+            ok = ok && *ptrs[i] == i;
+        }
+        util.assertEqual(ok, true);
+        mbr.release();
+        util.assertEqual(mbr.upstream_resource(), tstd::pmr::get_default_resource());
+    }
+
+    // pool resources
+    {
+        tstd::pmr::unsynchronized_pool_resource pool(tstd::pmr::pool_options{16, 512});
+        util.assertEqual(pool.options().max_blocks_per_chunk, std::size_t(16));
+        util.assertEqual(pool.options().largest_required_pool_block, std::size_t(512));
+        void* p1 = pool.allocate(24);
+        pool.deallocate(p1, 24);
+        void* p2 = pool.allocate(24);
+        util.assertEqual(p1, p2); // freed blocks are reused
+        void* large = pool.allocate(100000, 256);
+        util.assertEqual(reinterpret_cast<std::uintptr_t>(large) % 256, std::uintptr_t(0));
+        pool.deallocate(large, 100000, 256);
+        std::vector<std::pair<char*, std::size_t>> blocks;
+        for (std::size_t n = 1; n <= 2000; n += 7)
+        {
+            char* p = static_cast<char*>(pool.allocate(n));
+            std::fill(p, p + n, (char)n);
+            blocks.emplace_back(p, n);
+        }
+        bool ok = true;
+        for (auto& [p, n] : blocks)
+        {
+            ok = ok && std::all_of(p, p + n, [n](char c) { return c == (char)n; });
+        }
+        util.assertEqual(ok, true);
+        pool.release(); // the rest are freed by release
+
+        tstd::pmr::synchronized_pool_resource spool;
+        tstd::pmr::map<int, int> m(&spool);
+        std::map<int, int> m2;
+        for (int i = 0; i < 1000; ++i)
+        {
+            m[i * 7 % 1000] = i;
+            m2[i * 7 % 1000] = i;
+        }
+        util.assertSequenceEqual(m, m2);
+    }
+
+    // containers
+    {
+        tstd::pmr::unsynchronized_pool_resource pool;
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> dist(0, 1000);
+        tstd::pmr::vector<int> vec(&pool);
+        std::vector<int> vec2;
+        tstd::pmr::deque<int> deq(&pool);
+        std::deque<int> deq2;
+        tstd::pmr::list<int> l(&pool);
+        std::list<int> l2;
+        tstd::pmr::unordered_map<int, int> um(&pool);
+        std::unordered_map<int, int> um2;
+        for (int i = 0; i < 10000; ++i)
+        {
+            int x = dist(gen);
+            if (x % 3 == 0 && !vec2.empty())
+            {
+                vec.pop_back();
+                vec2.pop_back();
+                deq.pop_front();
+                deq2.pop_front();
+                l.pop_front();
+                l2.pop_front();
+                um.erase(x);
+                um2.erase(x);
+            }
+            else
+            {
+                vec.push_back(x);
+                vec2.push_back(x);
+                deq.push_back(x);
+                deq2.push_back(x);
+                l.push_back(x);
+                l2.push_back(x);
+                um[x] = x;
+                um2[x] = x;
+            }
+        }
+        util.assertSequenceEqual(vec, vec2);
+        util.assertSequenceEqual(deq, deq2);
+        util.assertSequenceEqual(l, l2);
+        util.assertSetEqual(um, um2);
+        util.assertEqual(vec.get_allocator().resource(), (tstd::pmr::memory_resource*)&pool);
+
+        // move between containers with different resources
+        tstd::pmr::monotonic_buffer_resource mbr;
+        tstd::pmr::vector<int> vec3(&mbr);
+        vec3 = std::move(vec);
+        util.assertSequenceEqual(vec3, vec2);
+        util.assertEqual(vec3.get_allocator().resource(), (tstd::pmr::memory_resource*)&mbr);
+        tstd::pmr::list<int> l3(&mbr);
+        l3 = std::move(l);
+        util.assertSequenceEqual(l3, l2);
+        tstd::pmr::deque<int> deq3(&mbr);
+        deq3 = std::move(deq);
+        util.assertSequenceEqual(deq3, deq2);
+        tstd::pmr::vector<int> vec4(std::move(vec3), &pool);
+        util.assertSequenceEqual(vec4, vec2);
+    }
+
+    // resource is propagated to nested elements
+    {
+        tstd::pmr::monotonic_buffer_resource mbr;
+        tstd::pmr::vector<tstd::pmr::vector<int>> vec(&mbr);
+        vec.emplace_back();
+        vec.emplace_back(3, 1);
+        util.assertEqual(vec[0].get_allocator().resource(), (tstd::pmr::memory_resource*)&mbr);
+        util.assertEqual(vec[1].get_allocator().resource(), (tstd::pmr::memory_resource*)&mbr);
+        util.assertSequenceEqual(vec[1], std::vector<int>{1, 1, 1});
+    }
+
+    // equal
+    {
+        tstd::pmr::monotonic_buffer_resource mbr;
+        tstd::pmr::polymorphic_allocator<int> a1(&mbr), a2(&mbr), a3;
+        util.assertEqual(a1 == a2, true);
+        util.assertEqual(a1 != a3, true);
+        util.assertEqual(tstd::pmr::polymorphic_allocator<Foo>(a1) == a1, true);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// over-aligned allocation and aligned allocator
+void testAlignedAllocator(bool showDetails)
+{
+    TestUtil util(showDetails, "aligned allocator");
+    auto aligned = [](const void* p, std::size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+    };
+
+    // over-aligned types are honoured by allocator and pool_allocator
+    {
+        struct alignas(128) Block { char data[40]; };
+        tstd::allocator<Block> alloc;
+        Block* p = alloc.allocate(3);
+        util.assertEqual(aligned(p, 128), true);
+        alloc.deallocate(p, 3);
+        tstd::pool_allocator<Block> palloc;
+        Block* p2 = palloc.allocate(1);
+        util.assertEqual(aligned(p2, 128), true);
+        palloc.deallocate(p2, 1);
+        tstd::vector<Block> vec(10);
+        util.assertEqual(aligned(vec.data(), 128), true);
+    }
+
+    // aligned allocator
+    {
+        using Alloc = tstd::aligned_allocator<float>;
+        util.assertEqual(Alloc::alignment, std::size_t(64));
+        util.assertEqual(tstd::aligned_allocator<char, 4096>::alignment, std::size_t(4096));
+        util.assertEqual(tstd::aligned_allocator<long double, 1>::alignment, alignof(long double));
+        tstd::vector<float, Alloc> vec;
+        bool allAligned = true;
+        for (int i = 0; i < 1000; ++i)
+        {
+            vec.push_back((float)i);
+            allAligned = allAligned && aligned(vec.data(), 64);
+        }
+        util.assertEqual(allAligned, true);
+        util.assertEqual(vec[999], 999.0f);
+        tstd::deque<int, tstd::aligned_allocator<int, 256>> deq;
+        std::deque<int> deq2;
+        for (int i = 0; i < 1000; ++i)
+        {
+            deq.push_front(i);
+            deq2.push_front(i);
+        }
+        util.assertSequenceEqual(deq, deq2);
+        tstd::unordered_map<int, int, std::hash<int>, std::equal_to<int>, tstd::aligned_allocator<std::pair<const int, int>>> um;
+        std::unordered_map<int, int> um2;
+        for (int i = 0; i < 1000; ++i)
+        {
+            um[i * 31 % 1000] = i;
+            um2[i * 31 % 1000] = i;
+        }
+        util.assertSetEqual(um, um2);
+        util.assertEqual(tstd::aligned_allocator<int>() == tstd::aligned_allocator<float>(), true);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// counting allocator and allocation report
+void testCountingAllocator(bool showDetails)
+{
+    TestUtil util(showDetails, "counting allocator");
+
+    // size classes
+    util.assertEqual(tstd::allocation_stats::size_class_of(0), std::size_t(0));
+    util.assertEqual(tstd::allocation_stats::size_class_of(8), std::size_t(0));
+    util.assertEqual(tstd::allocation_stats::size_class_of(9), std::size_t(1));
+    util.assertEqual(tstd::allocation_stats::size_class_of(16), std::size_t(1));
+    util.assertEqual(tstd::allocation_stats::size_class_of(1024), std::size_t(7));
+    util.assertEqual(tstd::allocation_stats::size_class_of(std::size_t(1) << 30), tstd::allocation_stats::size_class_count - 1);
+
+    // vector: one allocation after reserve
+    {
+        struct VectorTag;
+        using Alloc = tstd::counting_allocator<int, VectorTag>;
+        {
+            tstd::vector<int, Alloc> vec;
+            vec.reserve(100);
+            for (int i = 0; i < 100; ++i)
+            {
+                vec.push_back(i);
+            }
+            auto stats = Alloc::stats();
+            util.assertEqual(stats.allocations, std::size_t(1));
+            util.assertEqual(stats.live_bytes, 100 * sizeof(int));
+            util.assertEqual(stats.size_classes[tstd::allocation_stats::size_class_of(400)], std::size_t(1));
+        }
+        auto stats = tstd::get_allocation_stats<VectorTag>();
+        util.assertEqual(stats.deallocations, std::size_t(1));
+        util.assertEqual(stats.live_bytes, std::size_t(0));
+        util.assertEqual(stats.peak_live_bytes, 100 * sizeof(int));
+        util.showAllocationReport("vector", stats);
+        tstd::reset_allocation_stats<VectorTag>();
+        util.assertEqual(Alloc::stats().allocations, std::size_t(0));
+    }
+
+    // node containers: every T shares counters of the tag
+    {
+        struct MapTag;
+        using Alloc = tstd::counting_allocator<std::pair<const int, int>, MapTag>;
+        tstd::map<int, int, std::less<int>, Alloc> m;
+        std::size_t before = tstd::get_allocation_stats<MapTag>().allocations;
+        for (int i = 0; i < 100; ++i)
+        {
+            m[i] = i;
+        }
+        auto stats = tstd::get_allocation_stats<MapTag>();
+        util.assertEqual(stats.allocations - before, std::size_t(100)); // one node for every insertion
+        for (int i = 0; i < 50; ++i)
+        {
+            m.erase(i);
+        }
+        util.assertEqual(tstd::get_allocation_stats<MapTag>().deallocations, std::size_t(50));
+        util.showAllocationReport("map", tstd::get_allocation_stats<MapTag>());
+
+        struct UnorderedMapTag;
+        tstd::unordered_map<int, int, std::hash<int>, std::equal_to<int>, tstd::counting_allocator<std::pair<const int, int>, UnorderedMapTag>> um;
+        for (int i = 0; i < 100; ++i)
+        {
+            um[i] = i;
+        }
+        tstd::reset_allocation_stats<UnorderedMapTag>();
+        um.rehash(1000);
+        stats = tstd::get_allocation_stats<UnorderedMapTag>();
+        util.assertEqual(stats.allocations, std::size_t(1)); // only new buckets, nodes are relinked
+        util.assertEqual(stats.deallocations, std::size_t(1));
+        util.showAllocationReport("unordered_map rehash", stats);
+    }
+
+    // forward to another allocator
+    {
+        struct PoolTag;
+        using Alloc = tstd::counting_allocator<int, PoolTag, tstd::pool_allocator<int>>;
+        tstd::list<int, Alloc> l{1, 2, 3};
+        util.assertEqual(Alloc::stats().allocations >= 3, true);
+        util.assertEqual(Alloc() == Alloc::rebind<double>::other(), true);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// thread caching allocator
+// constructed before the thread cache of the main thread, so destroyed after it at exit
+tstd::vector<int, tstd::thread_cache_allocator<int>> threadCacheStaticVector;
+
+void testThreadCacheAllocator(bool showDetails)
+{
+    TestUtil util(showDetails, "thread cache allocator");
+
+    // allocation of all size classes and large blocks
+    {
+        tstd::thread_cache_allocator<char> alloc;
+        std::vector<std::pair<char*, std::size_t>> blocks;
+        for (std::size_t n = 0; n <= 300; ++n)
+        {
+            char* p = alloc.allocate(n);
+            std::fill(p, p + n, (char)n);
+            blocks.emplace_back(p, n);
+        }
+        bool ok = true;
+        for (auto& [p, n] : blocks)
+        {
+            ok = ok && std::all_of(p, p + n, [n](char c) { return c == (char)n; });
+            alloc.deallocate(p, n);
+        }
+        util.assertEqual(ok, true);
+        // freed blocks are reused by the same thread
+        char* p1 = alloc.allocate(40);
+        alloc.deallocate(p1, 40);
+        char* p2 = alloc.allocate(40);
+        util.assertEqual((void*)p1, (void*)p2);
+        alloc.deallocate(p2, 40);
+        struct alignas(64) Block { char data[64]; };
+        tstd::thread_cache_allocator<Block> balloc;
+        Block* b = balloc.allocate(1);
+        util.assertEqual(reinterpret_cast<std::uintptr_t>(b) % 64, std::uintptr_t(0));
+        balloc.deallocate(b, 1);
+    }
+
+    // node containers built by several threads, blocks are freed by other threads (remote free)
+    {
+        const int threadCount = 4;
+        std::vector<tstd::list<int, tstd::thread_cache_allocator<int>>> lists(threadCount);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&lists, t]() {
+                std::mt19937 gen(t);
+                tstd::unordered_map<int, int, std::hash<int>, std::equal_to<int>, tstd::thread_cache_allocator<std::pair<const int, int>>> um;
+                for (int i = 0; i < 20000; ++i)
+                {
+                    int x = static_cast<int>(gen() % 1000);
+                    um[x] = i;
+                    if (i % 3 == 0)
+                    {
+                        um.erase(x);
+                    }
+                    lists[t].push_back(i);
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        threads.clear();
+        // every thread frees the list built by the next thread
+        std::vector<char> oks(threadCount, false);
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&lists, &oks, t, threadCount]() {
+                auto& l = lists[(t + 1) % threadCount];
+                int expected = 0;
+                bool ok = true;
+                for (int x : l)
+                {
+                    ok = ok && x == expected++;
+                }
+                oks[t] = ok && expected == 20000;
+                l.clear();
+                tstd::list<int, tstd::thread_cache_allocator<int>> l2(1000, t);
+                oks[t] = oks[t] && l2.size() == 1000 && l2.back() == t;
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        util.assertEqual(std::all_of(oks.begin(), oks.end(), [](char b) { return b; }), true);
+    }
+
+    // compare with std containers
+    {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> dist(0, 1000);
+        tstd::map<int, std::string, std::less<int>, tstd::thread_cache_allocator<std::pair<const int, std::string>>> m1;
+        std::map<int, std::string> m2;
+        for (int i = 0; i < 10000; ++i)
+        {
+            int x = dist(gen);
+            if (x % 3 == 0)
+            {
+                m1.erase(x);
+                m2.erase(x);
+            }
+            else
+            {
+                m1[x] = std::to_string(x);
+                m2[x] = std::to_string(x);
+            }
+        }
+        util.assertSequenceEqual(m1, m2);
+    }
+
+    // blocks freed after the thread cache is destroyed go back to the depot
+    {
+        using base = tstd::impl::thread_cache_alloc_base;
+        threadCacheStaticVector.assign(10, 1); // freed at exit
+        std::size_t before = base::depot_blocks(32);
+        std::thread t([]() {
+            thread_local tstd::vector<std::uint64_t, tstd::thread_cache_allocator<std::uint64_t>> vec;
+            vec.reserve(4); // 32 bytes, the thread cache is created here and destroyed before vec
+        });
+        t.join();
+        util.assertEqual(base::depot_blocks(32), before > 0 ? before : base::BatchSize);
+    }
+
+    // equal
+    util.assertEqual(tstd::thread_cache_allocator<int>() == tstd::thread_cache_allocator<Foo>(), true);
+
+    // final result
+    util.showFinalResult();
+}
+
+// mmap allocator counting new blocks and remapped ones
+template<typename T>
+struct RemapCountingAllocator : tstd::mmap_allocator<T, 4096>
+{
+    using base = tstd::mmap_allocator<T, 4096>;
+    template<typename U> struct rebind {
+        using other = RemapCountingAllocator<U>;
+    };
+    static inline std::size_t allocations = 0;
+    static inline std::size_t remaps = 0;
+    RemapCountingAllocator() = default;
+    template<typename U>
+    RemapCountingAllocator(const RemapCountingAllocator<U>&) noexcept {}
+    T* allocate(std::size_t n)
+    {
+        ++allocations;
+        return base::allocate(n);
+    }
+    T* try_reallocate(T* p, std::size_t old_n, std::size_t new_n)
+    {
+        T* new_p = base::try_reallocate(p, old_n, new_n);
+        remaps += new_p != nullptr;
+        return new_p;
+    }
+};
+
+// mmap allocator
+void testMmapAllocator(bool showDetails)
+{
+    TestUtil util(showDetails, "mmap allocator");
+    using Alloc = tstd::mmap_allocator<int, 4096>;
+    util.assertEqual(Alloc::is_mapped(100), false);
+    util.assertEqual(Alloc::is_mapped(1024), tstd::impl::mmap_alloc_base::mmap_supported);
+
+    // small and mapped blocks
+    {
+        Alloc alloc;
+        int* small = alloc.allocate(100);
+        int* large = alloc.allocate(100000);
+        std::fill(small, small + 100, 1);
+        std::fill(large, large + 100000, 2);
+        util.assertEqual(std::count(large, large + 100000, 2), 100000);
+        // grow and shrink mapped block keeping content
+        int* p = alloc.try_reallocate(large, 100000, 1000000);
+        util.assertEqual(p != nullptr, tstd::impl::mmap_alloc_base::mmap_supported);
+        if (p)
+        {
+            large = p;
+            util.assertEqual(std::count(large, large + 100000, 2), 100000);
+            std::fill(large + 100000, large + 1000000, 3);
+            large = alloc.try_reallocate(large, 1000000, 200000);
+            util.assertEqual(large[199999], 3);
+            alloc.deallocate(large, 200000);
+        }
+        else
+        {
+            alloc.deallocate(large, 100000);
+        }
+        util.assertEqual(alloc.try_reallocate(small, 100, 200), (int*)nullptr); // small blocks could not be remapped
+        alloc.deallocate(small, 100);
+    }
+
+    // vector growth by mremap and hash bucket arrays
+    {
+        static_assert(tstd::impl::has_try_reallocate_v<Alloc>);
+        static_assert(!tstd::impl::has_try_reallocate_v<tstd::allocator<int>>);
+        tstd::vector<int, Alloc> vec;
+        std::vector<int> vec2;
+        for (int i = 0; i < 1000000; ++i)
+        {
+            vec.push_back(i);
+            vec2.push_back(i);
+        }
+        util.assertSequenceEqual(vec, vec2);
+        vec.shrink_to_fit();
+        util.assertSequenceEqual(vec, vec2);
+        tstd::vector<std::string, tstd::mmap_allocator<std::string, 4096>> strs(1000, "hello");
+        strs.reserve(10000); // non-trivially relocatable elements are relocated one by one
+        util.assertEqual(std::count(strs.begin(), strs.end(), "hello"), 1000);
+        tstd::unordered_map<int, int, std::hash<int>, std::equal_to<int>, tstd::mmap_allocator<std::pair<const int, int>, 4096>> um;
+        std::unordered_map<int, int> um2;
+        for (int i = 0; i < 5000; ++i)
+        {
+            um[i * 7] = i;
+            um2[i * 7] = i;
+        }
+        util.assertSetEqual(um, um2);
+    }
+    // appending by insert/emplace grows mapped storage by mremap
+    {
+        using CountingAlloc = RemapCountingAllocator<int>;
+        tstd::vector<int, CountingAlloc> vec(2000, 1);
+        std::vector<int> vec2(2000, 1);
+        std::vector<int> src(100000, 2);
+        CountingAlloc::allocations = CountingAlloc::remaps = 0;
+        vec.insert(vec.end(), src.begin(), src.end());
+        vec2.insert(vec2.end(), src.begin(), src.end());
+        vec.insert(vec.end(), 50000, 3);
+        vec2.insert(vec2.end(), 50000, 3);
+        vec.shrink_to_fit();
+        vec.emplace(vec.end(), vec[0]); // the argument refers to an element
+        vec2.emplace(vec2.end(), vec2[0]);
+        vec.insert(vec.end(), {4, 5, 6});
+        vec2.insert(vec2.end(), {4, 5, 6});
+        util.assertSequenceEqual(vec, vec2);
+        constexpr bool mapped = tstd::impl::mmap_alloc_base::mmap_supported;
+        util.assertEqual(CountingAlloc::allocations == 0, mapped);
+        util.assertEqual(CountingAlloc::remaps > 0, mapped);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// allocate_at_least
+void testAllocateAtLeast(bool showDetails)
+{
+    TestUtil util(showDetails, "allocate at least");
+    static_assert(tstd::impl::has_allocate_at_least_v<tstd::allocator<int>>);
+    static_assert(!tstd::impl::has_allocate_at_least_v<tstd::pool_allocator<int>>);
+
+    // the whole block is usable
+    {
+        tstd::allocator<char> alloc;
+        for (std::size_t n : {0, 1, 13, 100, 4000})
+        {
+            auto [p, count] = alloc.allocate_at_least(n);
+            util.assertEqual(count >= n, true);
+            std::fill(p, p + count, 'a');
+            util.assertEqual(std::count(p, p + count, 'a'), (std::ptrdiff_t)count);
+            alloc.deallocate(p, count);
+        }
+        tstd::aligned_allocator<int, 128> aligned_alloc;
+        auto [p, count] = tstd::impl::_allocate_at_least(aligned_alloc, 10); // fallback to allocate
+        util.assertEqual(count, 10);
+        aligned_alloc.deallocate(p, count);
+    }
+
+    // vector adopts the real capacity
+    {
+        tstd::allocator<char> alloc;
+        auto [p, count] = alloc.allocate_at_least(1);
+        alloc.deallocate(p, count);
+        tstd::vector<char> vec;
+        vec.reserve(1);
+        util.assertEqual(vec.capacity(), count); // e.g. 24 on glibc
+        std::string s;
+        for (int i = 0; i < 1000; ++i)
+        {
+            vec.push_back('a' + i % 26);
+            s.push_back('a' + i % 26);
+        }
+        util.assertSequenceEqual(vec, s);
+        util.assertEqual(vec.capacity() >= vec.size(), true);
+        vec.shrink_to_fit();
+        util.assertSequenceEqual(vec, s);
+    }
+
+    // deque map and temporary buffer of algorithms
+    {
+        tstd::deque<int> dq;
+        std::deque<int> dq2;
+        for (int i = 0; i < 100000; ++i)
+        {
+            dq.push_front(i);
+            dq2.push_front(i);
+            dq.push_back(i);
+            dq2.push_back(i);
+        }
+        util.assertSequenceEqual(dq, dq2);
+        tstd::vector<int> vec(1000);
+        for (int i = 0; i < 1000; ++i)
+        {
+            vec[i] = (i * 37) % 101;
+        }
+        std::vector<int> vec2(vec.begin(), vec.end());
+        tstd::stable_sort(vec.begin(), vec.end());
+        std::stable_sort(vec2.begin(), vec2.end());
+        util.assertSequenceEqual(vec, vec2);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// unique_ptr
+void testUniquePtr(bool showDetails)
+{
+    TestUtil util(showDetails, "unique_ptr");
+    // empty deleters take no space
+    {
+        auto del = [](int* p) { delete p; };
+        static_assert(sizeof(tstd::unique_ptr<int>) == sizeof(int*));
+        static_assert(sizeof(tstd::unique_ptr<int[]>) == sizeof(int*));
+        static_assert(sizeof(tstd::unique_ptr<int, decltype(del)>) == sizeof(int*));
+        static_assert(sizeof(tstd::unique_ptr<int, void(*)(int*)>) == 2 * sizeof(int*));
+    }
+    // ownership
+    {
+        tstd::unique_ptr<int> p1 = tstd::make_unique<int>(10);
+        util.assertEqual(*p1, 10);
+        tstd::unique_ptr<int> p2(std::move(p1));
+        util.assertEqual(p1.get(), (int*)nullptr);
+        util.assertEqual(p1 == nullptr, true);
+        util.assertEqual(*p2, 10);
+        int* raw = p2.release();
+        util.assertEqual(!p2, true);
+        p1.reset(raw);
+        util.assertEqual(p1.get(), raw);
+        p1 = nullptr;
+        util.assertEqual(bool(p1), false);
+        tstd::unique_ptr<std::string> ps = tstd::make_unique<std::string>(5, 'a');
+        util.assertEqual(ps->size(), 5);
+        util.assertEqual(*ps, std::string("aaaaa"));
+        tstd::swap(p1, p2);
+        util.assertEqual(p1 == p2, true);
+    }
+    // deleters and conversion
+    {
+        int deleted = 0;
+        auto del = [&deleted](int* p) { ++deleted; delete p; };
+        {
+            tstd::unique_ptr<int, decltype(del)> p(new int(1), del);
+            tstd::unique_ptr<int, decltype(del)> q(std::move(p));
+            q.reset(new int(2));
+            util.assertEqual(deleted, 1);
+        }
+        util.assertEqual(deleted, 2);
+        struct Base
+        {
+            virtual ~Base() = default;
+        };
+        struct Derived : Base
+        {
+            int value = 3;
+        };
+        tstd::unique_ptr<Base> pb = tstd::make_unique<Derived>();
+        util.assertEqual(static_cast<Derived*>(pb.get())->value, 3);
+    }
+    // array
+    {
+        tstd::unique_ptr<int[]> arr = tstd::make_unique<int[]>(10);
+        util.assertEqual(arr[9], 0); // value initialized
+        for (int i = 0; i < 10; ++i)
+        {
+            arr[i] = i;
+        }
+        util.assertSequenceEqual(std::vector<int>(arr.get(), arr.get() + 10), std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+        arr.reset();
+        util.assertEqual(arr.get(), (int*)nullptr);
+    }
+    // comparisons and hash
+    {
+        tstd::unique_ptr<int[]> arr(new int[2]);
+        tstd::unique_ptr<int> p(new int);
+        util.assertEqual(std::hash<tstd::unique_ptr<int>>()(p), std::hash<int*>()(p.get()));
+        util.assertEqual(p != nullptr, true);
+        util.assertEqual(nullptr < p, std::less<int*>()(nullptr, p.get()));
+        util.assertEqual(p >= p, true);
+    }
+    util.showFinalResult();
+}
+
+// shared_ptr and local_shared_ptr
+template<template<typename> typename SharedPtr, template<typename> typename WeakPtr, template<typename> typename EnableSharedFromThis,
+    typename MakeShared>
+void testSharedPtrImpl(TestUtil& util, MakeShared makeShared)
+{
+    struct Base
+    {
+        virtual ~Base() = default;
+        int base = 1;
+    };
+    struct Derived : Base, EnableSharedFromThis<Derived>
+    {
+        Derived() = default;
+        Derived(int x) : value(x) {}
+        int value = 2;
+    };
+    // reference counts
+    {
+        SharedPtr<int> p1 = makeShared.template operator()<int>(10);
+        util.assertEqual(*p1, 10);
+        util.assertEqual(p1.use_count(), 1);
+        SharedPtr<int> p2 = p1;
+        util.assertEqual(p1.use_count(), 2);
+        WeakPtr<int> w = p1;
+        util.assertEqual(w.use_count(), 2);
+        util.assertEqual(*w.lock(), 10);
+        p1.reset();
+        util.assertEqual(w.expired(), false);
+        SharedPtr<int> p3 = std::move(p2);
+        util.assertEqual(p2.get(), (int*)nullptr);
+        util.assertEqual(p3.use_count(), 1);
+        p3 = nullptr;
+        util.assertEqual(w.expired(), true);
+        util.assertEqual(w.lock() == nullptr, true);
+        bool thrown = false;
+        try
+        {
+            SharedPtr<int> p4(w);
+        }
+        catch (const tstd::bad_weak_ptr&)
+        {
+            thrown = true;
+        }
+        util.assertEqual(thrown, true);
+    }
+    // deleters and owning raw pointers
+    {
+        int deleted = 0;
+        auto del = [&deleted](int* p) { ++deleted; delete p; };
+        {
+            SharedPtr<int> p(new int(5), del);
+            SharedPtr<int> q = p;
+            util.assertEqual(tstd::get_deleter<decltype(del)>(p) != nullptr, true);
+            util.assertEqual(tstd::get_deleter<int>(p) == nullptr, true);
+        }
+        util.assertEqual(deleted, 1);
+        SharedPtr<int[]> arr(new int[4]{1, 2, 3, 4});
+        util.assertEqual(arr[3], 4);
+        SharedPtr<int> fromUnique(tstd::make_unique<int>(7));
+        util.assertEqual(*fromUnique, 7);
+    }
+    // conversions, aliasing and casts
+    {
+        SharedPtr<Derived> d = makeShared.template operator()<Derived>(3);
+        SharedPtr<Base> b = d;
+        util.assertEqual(b.use_count(), 2);
+        util.assertEqual(b->base, 1);
+        SharedPtr<int> alias(d, &d->value);
+        util.assertEqual(*alias, 3);
+        util.assertEqual(d.use_count(), 3);
+        util.assertEqual(tstd::dynamic_pointer_cast<Derived>(b) == d, true);
+        util.assertEqual(tstd::static_pointer_cast<Derived>(b)->value, 3);
+        util.assertEqual(alias.owner_before(d) || d.owner_before(alias), false);
+        WeakPtr<Base> wb = WeakPtr<Derived>(d);
+        util.assertEqual(wb.lock() == b, true);
+    }
+    // enable_shared_from_this
+    {
+        SharedPtr<Derived> d1 = makeShared.template operator()<Derived>();
+        SharedPtr<Derived> d2 = d1->shared_from_this();
+        util.assertEqual(d1 == d2, true);
+        util.assertEqual(d1.use_count(), 2);
+        SharedPtr<Derived> d3(new Derived);
+        util.assertEqual(d3->weak_from_this().lock() == d3, true);
+        Derived unowned;
+        util.assertEqual(unowned.weak_from_this().expired(), true);
+    }
+    // owner_less and hash
+    {
+        SharedPtr<int> p1 = makeShared.template operator()<int>(1);
+        SharedPtr<int> p2 = makeShared.template operator()<int>(1);
+        std::map<WeakPtr<int>, int, tstd::owner_less<WeakPtr<int>>> m;
+        m[p1] = 1;
+        m[p2] = 2;
+        m[WeakPtr<int>(p1)] = 3;
+        util.assertEqual(m.size(), 2);
+        util.assertEqual(m[p1], 3);
+        util.assertEqual(std::hash<SharedPtr<int>>()(p1), std::hash<int*>()(p1.get()));
+        util.assertEqual(p1 != p2, true);
+        util.assertEqual(p1 < p2, std::less<int*>()(p1.get(), p2.get()));
+    }
+}
+
+void testSharedPtr(bool showDetails)
+{
+    TestUtil util(showDetails, "shared_ptr");
+    testSharedPtrImpl<tstd::shared_ptr, tstd::weak_ptr, tstd::enable_shared_from_this>(util,
+        []<typename T, typename... Args>(Args&&... args) { return tstd::make_shared<T>(std::forward<Args>(args)...); });
+    testSharedPtrImpl<tstd::local_shared_ptr, tstd::local_weak_ptr, tstd::enable_local_shared_from_this>(util,
+        []<typename T, typename... Args>(Args&&... args) { return tstd::make_local_shared<T>(std::forward<Args>(args)...); });
+
+    // make_shared uses one allocation
+    {
+        struct SharedTag;
+        using Alloc = tstd::counting_allocator<std::string, SharedTag>;
+        tstd::reset_allocation_stats<SharedTag>();
+        {
+            tstd::shared_ptr<std::string> p = tstd::allocate_shared<std::string>(Alloc(), "hello");
+            tstd::weak_ptr<std::string> w = p;
+            util.assertEqual(*p, std::string("hello"));
+            util.assertEqual(tstd::get_allocation_stats<SharedTag>().allocations, 1);
+            p.reset();
+            util.assertEqual(tstd::get_allocation_stats<SharedTag>().deallocations, 0); // weak_ptr keeps the block
+        }
+        util.assertEqual(tstd::get_allocation_stats<SharedTag>().deallocations, 1);
+        tstd::local_shared_ptr<std::string> lp = tstd::allocate_local_shared<std::string>(Alloc(), 3, 'x');
+        util.assertEqual(*lp, std::string("xxx"));
+        util.assertEqual(tstd::get_allocation_stats<SharedTag>().allocations, 2);
+    }
+
+    // shared_ptr copies shared by threads
+    {
+        tstd::shared_ptr<int> p = tstd::make_shared<int>(1);
+        tstd::weak_ptr<int> w = p;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+        {
+            threads.emplace_back([p]() {
+                for (int j = 0; j < 10000; ++j)
+                {
+                    tstd::shared_ptr<int> q = p;
+                    tstd::weak_ptr<int> wq = q;
+                    (void)wq.lock();
+                }
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        util.assertEqual(p.use_count(), 1);
+        p.reset();
+        util.assertEqual(w.expired(), true);
+    }
+    util.showFinalResult();
+}
+
+// slab allocator with 32-bit fancy pointers
+void testSlabAllocator(bool showDetails)
+{
+    TestUtil util(showDetails, "slab allocator");
+    // slab_ptr
+    {
+        static_assert(sizeof(tstd::slab_ptr<int>) == 4);
+        using Traits = std::pointer_traits<tstd::slab_ptr<int>>;
+        static_assert(std::is_same_v<Traits::rebind<double>, tstd::slab_ptr<double>>);
+        static_assert(std::is_same_v<std::allocator_traits<tstd::slab_allocator<int>>::pointer, tstd::slab_ptr<int>>);
+        tstd::slab_allocator<std::string> alloc;
+        std::vector<tstd::slab_ptr<std::string>> ptrs;
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto p = alloc.allocate(1);
+            alloc.construct(p.get(), std::to_string(i));
+            ptrs.push_back(p);
+        }
+        bool ok = true;
+        for (int i = 0; i < 1000; ++i)
+        {
+            ok = ok && *ptrs[i] == std::to_string(i) && tstd::slab_ptr<std::string>::pointer_to(*ptrs[i]) == ptrs[i];
+        }
+        util.assertEqual(ok, true);
+        tstd::slab_ptr<const std::string> cp = ptrs[10];
+        util.assertEqual(cp->size(), 2);
+        util.assertEqual(tstd::slab_ptr<int>() == nullptr, true);
+        util.assertEqual(tstd::slab_ptr<int>().get(), (int*)nullptr);
+        for (auto p : ptrs)
+        {
+            alloc.destroy(p.get());
+            alloc.deallocate(p, 1);
+        }
+        auto p = alloc.allocate(1); // reuse freed slot
+        util.assertEqual(std::find(ptrs.begin(), ptrs.end(), p) != ptrs.end(), true);
+        alloc.deallocate(p, 1);
+        bool thrown = false;
+        try
+        {
+            (void)alloc.allocate(2);
+        }
+        catch (const std::bad_array_new_length&)
+        {
+            thrown = true;
+        }
+        util.assertEqual(thrown, true);
+    }
+
+    // node-based containers with 32-bit links
+    {
+        tstd::map<int, int, std::less<int>, tstd::slab_allocator<std::pair<const int, int>>> m;
+        std::map<int, int> m2;
+        for (int i = 0; i < 10000; ++i)
+        {
+            int key = (i * 7919) % 10007;
+            m[key] = i;
+            m2[key] = i;
+        }
+        for (int i = 0; i < 10000; i += 3)
+        {
+            m.erase(i);
+            m2.erase(i);
+        }
+        util.assertSequenceEqual(m, m2);
+        auto m3 = m;
+        util.assertSequenceEqual(m3, m2);
+        tstd::set<int, std::less<int>, tstd::slab_allocator<int, false>> st{5, 3, 1, 4, 2};
+        util.assertSequenceEqual(st, std::vector<int>{1, 2, 3, 4, 5});
+
+        tstd::list<int, tstd::slab_allocator<int>> l;
+        std::list<int> l2;
+        for (int i = 0; i < 1000; ++i)
+        {
+            l.push_back(i % 17);
+            l.push_front(i % 13);
+            l2.push_back(i % 17);
+            l2.push_front(i % 13);
+        }
+        l.sort();
+        l2.sort();
+        l.unique();
+        l2.unique();
+        util.assertSequenceEqual(l, l2);
+
+        tstd::unordered_map<int, std::string, std::hash<int>, std::equal_to<int>, tstd::slab_allocator<std::pair<const int, std::string>>> um;
+        std::unordered_map<int, std::string> um2;
+        for (int i = 0; i < 5000; ++i)
+        {
+            um[i * 3] = std::to_string(i);
+            um2[i * 3] = std::to_string(i);
+        }
+        for (int i = 0; i < 5000; i += 2)
+        {
+            um.erase(i * 3);
+            um2.erase(i * 3);
+        }
+        util.assertSetEqual(um, um2);
+        util.assertEqual(um.find(3)->second, std::string("1"));
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// mapped file allocator
+void testMappedFileAllocator(bool showDetails)
+{
+    TestUtil util(showDetails, "mapped file allocator");
+    // offset_ptr
+    {
+        static_assert(std::is_same_v<std::pointer_traits<tstd::offset_ptr<int>>::rebind<double>, tstd::offset_ptr<double>>);
+        int arr[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        tstd::offset_ptr<int> p = arr;
+        auto q = std::make_unique<tstd::offset_ptr<int>>(p); // copy at another address points to same object
+        util.assertEqual(q->get(), arr);
+        util.assertEqual(*(*q + 3), 3);
+        util.assertEqual((p + 9) - p, 9);
+        util.assertEqual(p[5], 5);
+        tstd::offset_ptr<const int> cp = p;
+        util.assertEqual(cp == tstd::offset_ptr<const int>(arr), true);
+        p = nullptr;
+        util.assertEqual(p == nullptr, true);
+        util.assertEqual(p.get(), (int*)nullptr);
+        util.assertEqual(static_cast<bool>(*q), true);
+    }
+    if constexpr (tstd::mapped_file::supported)
+    {
+        using MapAlloc = tstd::mapped_file_allocator<std::pair<const int, int>>;
+        using Map = tstd::map<int, int, std::less<int>, MapAlloc>;
+        using UnorderedMap = tstd::unordered_map<int, int, std::hash<int>, std::equal_to<int>, MapAlloc>;
+        using List = tstd::list<int, tstd::mapped_file_allocator<int>>;
+        static_assert(std::is_same_v<std::allocator_traits<MapAlloc>::pointer, tstd::offset_ptr<std::pair<const int, int>>>);
+        std::string path = (std::filesystem::temp_directory_path() / ("tstl_mapped_file_" + std::to_string(::getpid()) + ".bin")).string();
+        std::filesystem::remove(path);
+        std::map<int, int> m2;
+        std::unordered_map<int, int> um2;
+        std::list<int> l2;
+        // build containers in a new file
+        {
+            tstd::mapped_file file(path.c_str(), std::size_t(64) << 20);
+            util.assertEqual(file.created(), true);
+            Map* m = file.find_or_construct<Map>("map", MapAlloc(file));
+            UnorderedMap* um = file.find_or_construct<UnorderedMap>("unordered_map", MapAlloc(file));
+            List* l = file.find_or_construct<List>("list", tstd::mapped_file_allocator<int>(file));
+            std::mt19937 gen(42);
+            for (int i = 0; i < 20000; ++i)
+            {
+                int key = static_cast<int>(gen() % 100000);
+                (*m)[key] = i;
+                m2[key] = i;
+                (*um)[key] = i;
+                um2[key] = i;
+                l->push_back(key);
+                l2.push_back(key);
+            }
+            util.assertEqual(file.find_or_construct<Map>("map", MapAlloc(file)), m); // found, not constructed again
+            util.assertEqual(file.find<Map>("none"), (Map*)nullptr);
+        }
+        // reopen the file twice, the two mappings are at different addresses and share the same pages
+        {
+            tstd::mapped_file file(path.c_str(), 0);
+            tstd::mapped_file file2(path.c_str(), 0);
+            util.assertEqual(file.created(), false);
+            util.assertEqual(file.size(), std::size_t(64) << 20);
+            Map* m = file.find<Map>("map");
+            Map* m_view = file2.find<Map>("map");
+            util.assertEqual(m != nullptr && m != m_view, true);
+            util.assertSequenceEqual(*m, m2);
+            util.assertSequenceEqual(*m_view, m2);
+            util.assertSetEqual(*file.find<UnorderedMap>("unordered_map"), um2);
+            util.assertSequenceEqual(*file.find<List>("list"), l2);
+            // modify by one mapping, see it by the other
+            for (int key = 0; key < 50000; ++key)
+            {
+                m->erase(key);
+                m2.erase(key);
+            }
+            (*file.find<UnorderedMap>("unordered_map"))[-1] = -1;
+            um2[-1] = -1;
+            util.assertSequenceEqual(*m_view, m2);
+            util.assertSetEqual(*file2.find<UnorderedMap>("unordered_map"), um2);
+            file.flush();
+        }
+        // freed blocks are reused
+        {
+            tstd::mapped_file file(path.c_str(), 0);
+            List* l = file.find<List>("list");
+            std::size_t used = file.used();
+            l->clear();
+            util.assertEqual(file.used() < used, true);
+            l->assign(l2.begin(), l2.end());
+            util.assertEqual(file.used(), used);
+            util.assertEqual(file.destroy<List>("list"), true);
+            util.assertEqual(file.destroy<List>("list"), false);
+            util.assertEqual(file.destroy<Map>("map"), true);
+            util.assertEqual(file.destroy<UnorderedMap>("unordered_map"), true);
+            util.assertEqual(file.used(), std::size_t(0));
+        }
+        // full file and invalid file
+        {
+            std::filesystem::remove(path);
+            tstd::mapped_file file(path.c_str(), 1 << 16);
+            List* l = file.find_or_construct<List>("list", tstd::mapped_file_allocator<int>(file));
+            bool thrown = false;
+            try
+            {
+                for (int i = 0; i < (1 << 16); ++i)
+                {
+                    l->push_back(i);
+                }
+            }
+            catch (const std::bad_alloc&)
+            {
+                thrown = true;
+            }
+            util.assertEqual(thrown, true);
+            int expected = 0;
+            bool ok = l->size() > 0;
+            for (int x : *l)
+            {
+                ok = ok && x == expected++;
+            }
+            util.assertEqual(ok, true);
+        }
+        {
+            std::filesystem::resize_file(path, 1 << 12);
+            std::FILE* f = std::fopen(path.c_str(), "r+b");
+            std::fputs("not a mapped file", f);
+            std::fclose(f);
+            bool thrown = false;
+            try
+            {
+                tstd::mapped_file file(path.c_str(), 0);
+            }
+            catch (const std::runtime_error&)
+            {
+                thrown = true;
+            }
+            util.assertEqual(thrown, true);
+        }
+        std::filesystem::remove(path);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// inline arena allocator
+void testInlineArenaAllocator(bool showDetails)
+{
+    TestUtil util(showDetails, "inline arena allocator");
+    // vector in arena, spill to heap on overflow
+    {
+        tstd::inline_arena<256> arena;
+        tstd::vector<int, tstd::inline_arena_allocator<int, 256>> vec(arena);
+        vec.reserve(32);
+        util.assertEqual(arena.owns(vec.data()), true);
+        util.assertEqual(arena.used(), std::size_t(128));
+        for (int i = 0; i < 32; ++i)
+        {
+            vec.push_back(i);
+        }
+        util.assertEqual(arena.owns(vec.data()), true);
+        vec.push_back(32); // 64 ints do not fit in the rest 128 bytes
+        util.assertEqual(arena.owns(vec.data()), false);
+        util.assertEqual(arena.used(), std::size_t(0)); // the old block was the last one
+        std::vector<int> vec2(33);
+        std::iota(vec2.begin(), vec2.end(), 0);
+        util.assertSequenceEqual(vec, vec2);
+    }
+    // node containers share an arena by rebound allocators
+    {
+        tstd::inline_arena<4096> arena;
+        tstd::list<int, tstd::inline_arena_allocator<int, 4096>> l(arena);
+        tstd::map<int, int, std::less<int>, tstd::inline_arena_allocator<std::pair<const int, int>, 4096>> m(arena);
+        std::map<int, int> m2;
+        for (int i = 0; i < 20; ++i)
+        {
+            l.push_back(i);
+            m[i * 3] = i;
+            m2[i * 3] = i;
+        }
+        util.assertEqual(arena.owns(&l.back()), true);
+        util.assertEqual(arena.owns(&m[0]), true);
+        util.assertSequenceEqual(m, m2);
+        util.assertEqual(l.size(), std::size_t(20));
+        util.assertEqual(l.get_allocator() == tstd::inline_arena_allocator<double, 4096>(arena), true);
+        tstd::inline_arena<4096> other;
+        util.assertEqual(l.get_allocator() == tstd::inline_arena_allocator<int, 4096>(other), false);
+    }
+    // LIFO reclaim and reset
+    {
+        tstd::inline_arena<64, 8> arena;
+        tstd::inline_arena_allocator<char, 64, 8> alloc(arena);
+        char* a = alloc.allocate(3);
+        char* b = alloc.allocate(9);
+        util.assertEqual(arena.used(), std::size_t(24));
+        alloc.deallocate(a, 3); // not the last block, kept
+        util.assertEqual(arena.used(), std::size_t(24));
+        alloc.deallocate(b, 9);
+        util.assertEqual(arena.used(), std::size_t(8));
+        arena.reset();
+        util.assertEqual(arena.used(), std::size_t(0));
+        char* c = alloc.allocate(100);
+        util.assertEqual(arena.owns(c), false);
+        alloc.deallocate(c, 100);
+    }
 
     // final result
     util.showFinalResult();
@@ -9,12 +9,21 @@
 #include <functional>
 #include <string>
 #include <random>
+#include <sstream>
+#include <stdexcept>
 #include <tmemory.hpp>
 #include <tvector.hpp>
 #include <tarray.hpp>
 #include <tlist.hpp>
 #include <tforward_list.hpp>
 #include <tdeque.hpp>
+#include <tsmall_vector.hpp>
+#include <tstatic_vector.hpp>
+#include <tsoa_vector.hpp>
+#include <tsegmented_vector.hpp>
+#include <tstack.hpp>
+#include <tqueue.hpp>
+#include <tnumeric.hpp>
 #include "TestUtil.hpp"
 
 void testVector(bool showDetails);
@@ -24,6 +33,18 @@ void testArray(bool showDetails);
 void testList(bool showDetails);
 void testForwardList(bool showDetails);
 void testDeque(bool showDetails);
+void testSmallVector(bool showDetails);
+void testVectorGrowthPolicy(bool showDetails);
+void testVectorBulkInsert(bool showDetails);
+void testVectorInsertSafety(bool showDetails);
+void testVectorBool(bool showDetails);
+void testVectorForOverwrite(bool showDetails);
+void testStaticVector(bool showDetails);
+void testSoaVector(bool showDetails);
+void testContiguousComparisons(bool showDetails);
+void testSegmentedVector(bool showDetails);
+void testDequeBlockSize(bool showDetails);
+void testDequeBlockCache(bool showDetails);
 
 int main(int argc, char const *argv[])
 {
@@ -33,6 +54,18 @@ int main(int argc, char const *argv[])
     testList(showDetails);
     testForwardList(showDetails);
     testDeque(showDetails);
+    testSmallVector(showDetails);
+    testVectorGrowthPolicy(showDetails);
+    testVectorBulkInsert(showDetails);
+    testVectorInsertSafety(showDetails);
+    testVectorBool(showDetails);
+    testVectorForOverwrite(showDetails);
+    testStaticVector(showDetails);
+    testSoaVector(showDetails);
+    testContiguousComparisons(showDetails);
+    testSegmentedVector(showDetails);
+    testDequeBlockSize(showDetails);
+    testDequeBlockCache(showDetails);
     std::cout << std::endl;
     return 0;
 }
@@ -174,8 +207,12 @@ void testVector(bool showDetails)
             std::vector<int> vec2;
             vec1.reserve(100);
             vec2.reserve(100);
-            util.assertEqual(vec1.capacity(), vec2.capacity());
-            util.assertEqual(vec1.capacity(), 100);
+            // the real size of the block is adopted
+            tstd::allocator<int> alloc;
+            auto block = alloc.allocate_at_least(100);
+            util.assertEqual(vec1.capacity(), block.count);
+            util.assertEqual(vec1.capacity() >= vec2.capacity(), true);
+            alloc.deallocate(block.ptr, block.count);
         }
         // modifiers
         // clear
@@ -278,6 +315,71 @@ void testVector(bool showDetails)
             util.assertSequenceEqual(tmp1, tmp2);
         }
     }
+    // relocation of trivially relocatable elements
+    {
+        static_assert(tstd::is_trivially_relocatable_v<int>);
+        static_assert(tstd::is_trivially_relocatable_v<tstd::vector<int>>);
+        static_assert(tstd::is_trivially_relocatable_v<tstd::deque<std::string>>);
+        static_assert(!tstd::is_trivially_relocatable_v<std::string>);
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> dist(0, 100);
+        tstd::vector<tstd::vector<int>> vec1;
+        std::vector<std::vector<int>> vec2;
+        auto equal = [&]() {
+            return std::equal(vec1.begin(), vec1.end(), vec2.begin(), vec2.end(), [](const auto& a, const auto& b) {
+                return std::equal(a.begin(), a.end(), b.begin(), b.end());
+            });
+        };
+        for (int i = 0; i < 1000; ++i)
+        {
+            int x = dist(gen);
+            std::size_t idx = vec2.empty() ? 0 : x % vec2.size();
+            if (x < 50)
+            {
+                vec1.push_back(tstd::vector<int>(x, x));
+                vec2.push_back(std::vector<int>(x, x));
+            }
+            else if (x < 70)
+            {
+                vec1.insert(vec1.begin() + idx, tstd::vector<int>(x, x));
+                vec2.insert(vec2.begin() + idx, std::vector<int>(x, x));
+            }
+            else if (x < 80)
+            {
+                vec1.insert(vec1.begin() + idx, 3, tstd::vector<int>{x});
+                vec2.insert(vec2.begin() + idx, 3, std::vector<int>{x});
+            }
+            else if (x < 85)
+            {
+                vec1.emplace(vec1.begin() + idx, 2, x);
+                vec2.emplace(vec2.begin() + idx, 2, x);
+            }
+            else if (!vec2.empty())
+            {
+                std::size_t count = std::min<std::size_t>(vec2.size() - idx, 3);
+                vec1.erase(vec1.begin() + idx, vec1.begin() + idx + count);
+                vec2.erase(vec2.begin() + idx, vec2.begin() + idx + count);
+            }
+        }
+        util.assertEqual(equal(), true);
+        vec1.shrink_to_fit();
+        util.assertEqual(equal(), true);
+        // non-trivially relocatable elements
+        tstd::vector<std::string> strs1;
+        std::vector<std::string> strs2;
+        for (int i = 0; i < 200; ++i)
+        {
+            std::string str(i % 30, 'a' + i % 26);
+            strs1.insert(strs1.begin() + i / 2, str);
+            strs2.insert(strs2.begin() + i / 2, str);
+            if (i % 3 == 0)
+            {
+                strs1.erase(strs1.begin() + i / 3);
+                strs2.erase(strs2.begin() + i / 3);
+            }
+        }
+        util.assertSequenceEqual(strs1, strs2);
+    }
     // non-member operations
     {
         // comparisons
@@ -1677,3 +1779,1274 @@ void testDeque(bool showDetails)
     }
     util.showFinalResult();
 }
+
+// copying throws after copies_left copies, live counts objects alive
+template<bool Relocatable>
+struct InsertThrower
+{
+    static inline int live = 0;
+    static inline int copies_left = -1; // -1: never throw
+    int value;
+    InsertThrower(int v) : value(v) { ++live; }
+    InsertThrower(const InsertThrower& other) : value(other.value)
+    {
+        if (copies_left == 0)
+        {
+            throw std::runtime_error("copy");
+        }
+        if (copies_left > 0)
+        {
+            --copies_left;
+        }
+        ++live;
+    }
+    InsertThrower(InsertThrower&& other) noexcept : value(other.value) { ++live; }
+    InsertThrower& operator=(const InsertThrower&) = default;
+    ~InsertThrower() { --live; }
+    bool operator==(const InsertThrower&) const = default;
+    friend std::ostream& operator<<(std::ostream& os, const InsertThrower& t)
+    {
+        return os << t.value;
+    }
+};
+
+template<>
+struct tstd::is_trivially_relocatable<InsertThrower<true>> : std::true_type {};
+
+// a throwing copy during insert leaves the container unchanged
+template<typename Vec>
+void insertThrowingCopies(TestUtil& util)
+{
+    using Elem = typename Vec::value_type;
+    auto tryInsert = [](auto&& insert) {
+        try
+        {
+            insert();
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    };
+    {
+        Vec vec{1, 2, 3, 4, 5};
+        std::vector<Elem> expected(vec.begin(), vec.end());
+        Elem value(9);
+        // reallocating, the 3rd copy throws
+        Elem::copies_left = 2;
+        util.assertEqual(tryInsert([&]() { vec.insert(vec.begin() + 1, 4, value); }), true);
+        util.assertSequenceEqual(vec, expected);
+        // in place, the 3rd copy throws and the tail is shifted back
+        Elem::copies_left = -1;
+        vec.reserve(20);
+        Elem::copies_left = 2;
+        util.assertEqual(tryInsert([&]() { vec.insert(vec.begin() + 1, 4, value); }), true);
+        util.assertSequenceEqual(vec, expected);
+        Elem::copies_left = 0;
+        util.assertEqual(tryInsert([&]() { vec.insert(vec.begin(), value); }), true);
+        util.assertSequenceEqual(vec, expected);
+        Elem::copies_left = -1;
+        vec.insert(vec.begin() + 2, 2, value);
+        expected.insert(expected.begin() + 2, 2, value);
+        util.assertSequenceEqual(vec, expected);
+    }
+    util.assertEqual(Elem::live, 0);
+}
+
+// random operations on a vector-like container and std::vector, inserts stop near max_size().
+// small_vector elements spill to heap and come back by shrink_to_fit.
+template<typename Vec, typename Gen>
+void randomVectorOperations(TestUtil& util, Gen&& gen, unsigned seed)
+{
+    using T = typename Vec::value_type;
+    Vec vec1;
+    std::vector<T> vec2;
+    std::mt19937 rng(seed);
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::size_t pos = vec2.empty() ? 0 : rng() % (vec2.size() + 1);
+        T value = gen(i);
+        bool full = vec2.size() + 3 > vec1.max_size();
+        switch (rng() % 8)
+        {
+        case 0: case 1:
+            if (!full)
+            {
+                vec1.push_back(value);
+                vec2.push_back(value);
+            }
+            break;
+        case 2:
+            if (!full)
+            {
+                vec1.insert(vec1.begin() + pos, value);
+                vec2.insert(vec2.begin() + pos, value);
+            }
+            break;
+        case 3:
+            if (!full)
+            {
+                vec1.insert(vec1.begin() + pos, 3, value);
+                vec2.insert(vec2.begin() + pos, 3, value);
+            }
+            break;
+        case 4:
+            if (pos < vec2.size())
+            {
+                vec1.erase(vec1.begin() + pos);
+                vec2.erase(vec2.begin() + pos);
+            }
+            break;
+        case 5:
+        {
+            std::size_t last = tstd::min(vec2.size(), pos + rng() % 8);
+            vec1.erase(vec1.begin() + pos, vec1.begin() + last);
+            vec2.erase(vec2.begin() + pos, vec2.begin() + last);
+            break;
+        }
+        case 6:
+            vec1.resize(vec2.size() / 2, value);
+            vec2.resize(vec2.size() / 2, value);
+            vec1.shrink_to_fit();
+            break;
+        case 7:
+        {
+            Vec other(3, value);
+            vec1.swap(other);
+            vec1.swap(other);
+            Vec moved(std::move(vec1)); // both inline and heap elements of small_vector
+            vec1 = std::move(moved);
+            break;
+        }
+        }
+        util.assertSequenceEqual(vec1, vec2);
+        if constexpr (requires { Vec::inline_capacity; })
+        {
+            util.assertEqual(vec1.capacity() == Vec::inline_capacity, vec1.is_inline());
+        }
+    }
+}
+
+void testSmallVector(bool showDetails)
+{
+    TestUtil util(showDetails, "small_vector");
+    // constructors
+    {
+        tstd::small_vector<int, 8> vec1;
+        util.assertEqual(vec1.is_inline(), true);
+        util.assertEqual(vec1.capacity(), std::size_t(8));
+        tstd::small_vector<int, 8> vec2(5, 99);
+        util.assertSequenceEqual(vec2, std::vector<int>(5, 99));
+        util.assertEqual(vec2.is_inline(), true);
+        tstd::small_vector<int, 8> vec3(20);
+        util.assertSequenceEqual(vec3, std::vector<int>(20));
+        util.assertEqual(vec3.is_inline(), false);
+        std::vector<int> vec(100);
+        std::iota(vec.begin(), vec.end(), 1);
+        tstd::small_vector<int, 8> vec4(vec.begin(), vec.end());
+        util.assertSequenceEqual(vec4, vec);
+        tstd::small_vector<int, 8> vec5(vec4);
+        util.assertSequenceEqual(vec5, vec);
+        tstd::small_vector<int, 8> vec6(std::move(vec5));
+        util.assertSequenceEqual(vec6, vec);
+        util.assertEqual(vec5.empty() && vec5.is_inline(), true);
+        tstd::small_vector<std::string, 4> vec7{"hello", "world"};
+        tstd::small_vector<std::string, 4> vec8(std::move(vec7)); // inline elements are moved one by one
+        util.assertSequenceEqual(vec8, std::vector<std::string>{"hello", "world"});
+        util.assertEqual(vec7.empty(), true);
+    }
+    // assignment, comparison and swap of inline and heap vectors
+    {
+        tstd::small_vector<std::string, 4> small{"a", "b"};
+        tstd::small_vector<std::string, 4> large(10, "x");
+        tstd::small_vector<std::string, 4> copy;
+        copy = large;
+        util.assertEqual(copy == large, true);
+        copy = small;
+        util.assertEqual(copy == small, true);
+        util.assertEqual(small < large, true);
+        small.swap(large);
+        util.assertSequenceEqual(small, std::vector<std::string>(10, "x"));
+        util.assertSequenceEqual(large, std::vector<std::string>{"a", "b"});
+        util.assertEqual(large.is_inline() && !small.is_inline(), true);
+        tstd::swap(small, large);
+        util.assertSequenceEqual(small, std::vector<std::string>{"a", "b"});
+        large = {"1", "2", "3", "4", "5"};
+        util.assertSequenceEqual(large, std::vector<std::string>{"1", "2", "3", "4", "5"});
+        util.assertEqual(large.at(4), std::string("5"));
+    }
+    // elements referring to themselves
+    {
+        tstd::small_vector<std::string, 2> vec{"abc", "def"};
+        vec.push_back(vec[0]); // growth from inline storage
+        vec.insert(vec.begin(), vec[2]);
+        vec.emplace(vec.begin() + 1, vec.back());
+        util.assertSequenceEqual(vec, std::vector<std::string>{"abc", "abc", "abc", "def", "abc"});
+        vec.resize(8, vec[3]);
+        util.assertEqual(vec.back(), std::string("def"));
+        util.assertEqual(vec.emplace_back("ghi"), std::string("ghi"));
+    }
+    // shrink_to_fit goes back to inline storage
+    {
+        tstd::small_vector<int, 16> vec(100, 1);
+        vec.resize(10);
+        vec.shrink_to_fit();
+        util.assertEqual(vec.is_inline(), true);
+        util.assertSequenceEqual(vec, std::vector<int>(10, 1));
+        vec.reserve(17);
+        util.assertEqual(vec.is_inline(), false);
+        util.assertEqual(vec.capacity() >= 17, true);
+    }
+    randomVectorOperations<tstd::small_vector<int, 8>>(util, [](int i) { return i; }, 42);
+    randomVectorOperations<tstd::small_vector<std::string, 4>>(util, [](int i) { return std::to_string(i) + std::string(20, 'x'); }, 42);
+    insertThrowingCopies<tstd::small_vector<InsertThrower<false>, 4>>(util);
+    insertThrowingCopies<tstd::small_vector<InsertThrower<true>, 4>>(util);
+
+    // final result
+    util.showFinalResult();
+}
+
+// capacities seen while pushing back n elements, real block sizes are not adopted by counting_allocator
+template<typename Growth>
+std::vector<std::size_t> vectorCapacities(int n)
+{
+    tstd::vector<int, tstd::counting_allocator<int>, Growth> vec;
+    std::vector<std::size_t> capacities;
+    for (int i = 0; i < n; ++i)
+    {
+        vec.push_back(i);
+        if (capacities.empty() || capacities.back() != vec.capacity())
+        {
+            capacities.push_back(vec.capacity());
+        }
+    }
+    return capacities;
+}
+
+// grow by fixed 10 elements, a user-defined growth policy
+struct GrowthBy10
+{
+    static constexpr std::size_t grow(std::size_t capacity, std::size_t required, std::size_t)
+    {
+        return tstd::max(capacity + 10, required);
+    }
+    static constexpr std::size_t shrink(std::size_t capacity, std::size_t, std::size_t)
+    {
+        return capacity;
+    }
+};
+
+void testVectorGrowthPolicy(bool showDetails)
+{
+    TestUtil util(showDetails, "vector growth policy");
+    // growth
+    {
+        util.assertSequenceEqual(vectorCapacities<tstd::vector_growth_2x>(20), std::vector<std::size_t>{1, 2, 4, 8, 16, 32});
+        util.assertSequenceEqual(vectorCapacities<tstd::vector_growth_1_5x>(20), std::vector<std::size_t>{1, 2, 3, 4, 6, 9, 13, 19, 28});
+        util.assertSequenceEqual(vectorCapacities<GrowthBy10>(35), std::vector<std::size_t>{10, 20, 30, 40});
+        std::vector<std::size_t> pages = vectorCapacities<tstd::vector_growth_page<4096>>(5000);
+        util.assertSequenceEqual(pages, std::vector<std::size_t>{1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192});
+        util.assertEqual(tstd::vector_growth_page<4096>::grow(1000, 1001, 12) * 12 % 4096, std::size_t(0)); // 2000 * 12 bytes rounded up to pages
+        util.assertEqual(tstd::vector_growth_page<4096>::grow(1000, 1001, 12) >= 2000, true);
+        tstd::vector<int, tstd::allocator<int>, GrowthBy10> vec(5, 1);
+        vec.insert(vec.begin(), 30, 2); // one reallocation for the whole insertion
+        util.assertEqual(vec.size(), std::size_t(35));
+        util.assertEqual(std::count(vec.begin(), vec.end(), 2), 30);
+    }
+    // auto shrink
+    {
+        using Vec = tstd::vector<int, tstd::counting_allocator<int>, tstd::vector_auto_shrink<>>;
+        Vec vec(10000, 1);
+        std::vector<int> vec2(10000, 1);
+        std::iota(vec.begin(), vec.end(), 0);
+        std::iota(vec2.begin(), vec2.end(), 0);
+        auto iter = vec.erase(vec.begin() + 100, vec.end() - 100);
+        vec2.erase(vec2.begin() + 100, vec2.end() - 100);
+        util.assertSequenceEqual(vec, vec2);
+        util.assertEqual(*iter, 9900); // erase returns valid iterator after shrinking
+        util.assertEqual(vec.capacity(), std::size_t(400));
+        vec.resize(50);
+        util.assertEqual(vec.capacity(), std::size_t(400)); // 200 bytes are less than MinBytes
+        Vec vec3(10000, 1);
+        while (vec3.size() > 1000)
+        {
+            vec3.pop_back();
+        }
+        util.assertEqual(vec3.capacity() < 10000, true);
+        vec3.clear();
+        util.assertEqual(vec3.capacity(), std::size_t(0));
+        // default policy never shrinks
+        tstd::vector<int> vec4(10000, 1);
+        vec4.erase(vec4.begin() + 10, vec4.end());
+        vec4.clear();
+        util.assertEqual(vec4.capacity() >= 10000, true);
+        vec4.assign(10, 1);
+        vec4.shrink_to_fit();
+        util.assertEqual(vec4.capacity() < 10000, true);
+        util.assertSequenceEqual(vec4, std::vector<int>(10, 1));
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+struct BulkInsertTag {};
+
+void testVectorBulkInsert(bool showDetails)
+{
+    TestUtil util(showDetails, "vector bulk insert");
+    using Vec = tstd::vector<int, tstd::counting_allocator<int, BulkInsertTag>>;
+    auto allocations = []() { return tstd::get_allocation_stats<BulkInsertTag>().allocations; };
+    // forward iterators: one allocation at most
+    {
+        std::list<int> lst(1000);
+        std::iota(lst.begin(), lst.end(), 0);
+        Vec vec(lst.begin(), lst.end());
+        util.assertSequenceEqual(vec, lst);
+        util.assertEqual(vec.capacity(), std::size_t(1000));
+        std::vector<int> vec2(lst.begin(), lst.end());
+        tstd::reset_allocation_stats<BulkInsertTag>();
+        vec.insert(vec.begin() + 500, lst.begin(), lst.end());
+        vec2.insert(vec2.begin() + 500, lst.begin(), lst.end());
+        util.assertSequenceEqual(vec, vec2);
+        util.assertEqual(allocations(), std::size_t(1));
+        vec.insert(vec.end(), lst.begin(), lst.end()); // append
+        vec2.insert(vec2.end(), lst.begin(), lst.end());
+        util.assertSequenceEqual(vec, vec2);
+        util.assertEqual(allocations(), std::size_t(2));
+        util.assertEqual(vec.capacity() >= vec.size() + 10, true);
+        vec.insert(vec.begin(), lst.begin(), std::next(lst.begin(), 10)); // in place
+        vec2.insert(vec2.begin(), lst.begin(), std::next(lst.begin(), 10));
+        util.assertSequenceEqual(vec, vec2);
+        util.assertEqual(allocations(), std::size_t(2));
+        vec.insert(vec.begin() + 3, lst.begin(), lst.begin()); // empty range
+        util.assertSequenceEqual(vec, vec2);
+        // assign reuses the storage
+        std::size_t cap = vec.capacity();
+        vec.assign(lst.begin(), lst.end());
+        util.assertSequenceEqual(vec, lst);
+        util.assertEqual(vec.capacity(), cap);
+        util.assertEqual(allocations(), std::size_t(2));
+        std::vector<int> big(cap + 1, 7);
+        vec.assign(big.begin(), big.end());
+        util.assertSequenceEqual(vec, big);
+        util.assertEqual(allocations(), std::size_t(3));
+    }
+    // non-trivially relocatable elements
+    {
+        std::vector<std::string> src{"a", "b", "c", "d"};
+        tstd::vector<std::string> vec{"x", "y", "z"};
+        std::vector<std::string> vec2{"x", "y", "z"};
+        vec.insert(vec.begin() + 1, src.begin(), src.end());
+        vec2.insert(vec2.begin() + 1, src.begin(), src.end());
+        util.assertSequenceEqual(vec, vec2);
+        vec.reserve(20);
+        vec.insert(vec.begin() + 2, src.begin(), src.end());
+        vec2.insert(vec2.begin() + 2, src.begin(), src.end());
+        util.assertSequenceEqual(vec, vec2);
+        vec.assign(src.begin(), src.begin() + 2);
+        util.assertSequenceEqual(vec, std::vector<std::string>{"a", "b"});
+    }
+    // input iterators
+    {
+        std::istringstream is("1 2 3 4 5");
+        tstd::vector<int> vec{10, 20, 30};
+        vec.insert(vec.begin() + 1, std::istream_iterator<int>(is), std::istream_iterator<int>());
+        util.assertSequenceEqual(vec, std::vector<int>{10, 1, 2, 3, 4, 5, 20, 30});
+        std::istringstream is2("6 7");
+        vec.assign(std::istream_iterator<int>(is2), std::istream_iterator<int>());
+        util.assertSequenceEqual(vec, std::vector<int>{6, 7});
+        std::istringstream is3("8 9");
+        tstd::vector<int> vec2(std::istream_iterator<int>(is3), (std::istream_iterator<int>()));
+        util.assertSequenceEqual(vec2, std::vector<int>{8, 9});
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+void testVectorInsertSafety(bool showDetails)
+{
+    TestUtil util(showDetails, "vector insert safety");
+    // the inserted value refers to an element of the vector
+    {
+        tstd::vector<int> vec{1, 2, 3};
+        vec.reserve(10);
+        vec.insert(vec.begin(), 2, vec[2]);
+        util.assertSequenceEqual(vec, std::vector<int>{3, 3, 1, 2, 3});
+        vec.insert(vec.begin() + 1, vec.back());
+        util.assertSequenceEqual(vec, std::vector<int>{3, 3, 3, 1, 2, 3});
+        vec.shrink_to_fit();
+        vec.insert(vec.begin(), 3, vec[3]); // reallocating
+        util.assertSequenceEqual(vec, std::vector<int>{1, 1, 1, 3, 3, 3, 1, 2, 3});
+    }
+    {
+        tstd::vector<std::string> vec{"a", "b", "c"};
+        vec.shrink_to_fit();
+        vec.insert(vec.begin(), vec.back()); // reallocating
+        util.assertSequenceEqual(vec, std::vector<std::string>{"c", "a", "b", "c"});
+        vec.reserve(10);
+        vec.insert(vec.begin(), vec.back());
+        util.assertSequenceEqual(vec, std::vector<std::string>{"c", "c", "a", "b", "c"});
+        vec.emplace(vec.begin() + 1, vec[3]);
+        util.assertSequenceEqual(vec, std::vector<std::string>{"c", "b", "c", "a", "b", "c"});
+        vec.insert(vec.begin(), 2, vec[3]);
+        util.assertSequenceEqual(vec, std::vector<std::string>{"a", "a", "c", "b", "c", "a", "b", "c"});
+    }
+    // a throwing copy leaves the vector unchanged
+    insertThrowingCopies<tstd::vector<InsertThrower<false>>>(util);
+    insertThrowingCopies<tstd::vector<InsertThrower<true>>>(util);
+
+    // final result
+    util.showFinalResult();
+}
+
+// random operations on tstd::vector<bool> and std::vector<bool>
+void testVectorBool(bool showDetails)
+{
+    TestUtil util(showDetails, "vector<bool>");
+    // basic operations
+    {
+        tstd::vector<bool> vec{true, false, true};
+        util.assertSequenceEqual(vec, std::vector<bool>{true, false, true});
+        vec[1] = true;
+        vec.back() = false;
+        vec.front().flip();
+        util.assertSequenceEqual(vec, std::vector<bool>{false, true, false});
+        vec.push_back(true);
+        vec.emplace_back(1);
+        util.assertEqual(vec.size(), std::size_t(5));
+        util.assertEqual(vec.capacity() % 64, std::size_t(0)); // whole words
+        util.assertEqual(vec.at(4), true);
+        tstd::vector<bool>::swap(vec[0], vec[1]);
+        util.assertSequenceEqual(vec, std::vector<bool>{true, false, false, true, true});
+        vec.flip();
+        util.assertSequenceEqual(vec, std::vector<bool>{false, true, true, false, false});
+        const tstd::vector<bool>& cvec = vec;
+        util.assertEqual(cvec[1], true);
+        util.assertEqual(std::count(cvec.rbegin(), cvec.rend(), true), 2);
+        tstd::vector<bool> vec2(vec);
+        util.assertEqual(vec2 == vec, true);
+        vec2.pop_back();
+        util.assertEqual(vec2 < vec, true);
+        std::sort(vec.begin(), vec.end());
+        util.assertSequenceEqual(vec, std::vector<bool>{false, false, false, true, true});
+        tstd::vector<bool> vec3(1000, true);
+        vec3.erase(vec3.begin() + 10, vec3.end() - 10);
+        util.assertEqual(vec3.size(), std::size_t(20));
+        util.assertEqual(tstd::count(vec3.begin(), vec3.end(), true), std::ptrdiff_t(20));
+        vec3.shrink_to_fit();
+        util.assertEqual(vec3.capacity() < 1000, true);
+    }
+    // random operations
+    {
+        std::mt19937 gen(17);
+        tstd::vector<bool> vec;
+        std::vector<bool> vec2;
+        bool ok = true;
+        for (int i = 0; i < 3000 && ok; ++i)
+        {
+            std::size_t pos = vec2.empty() ? 0 : gen() % (vec2.size() + 1);
+            bool value = gen() % 2;
+            switch (gen() % 8)
+            {
+            case 0:
+                vec.push_back(value);
+                vec2.push_back(value);
+                break;
+            case 1:
+            {
+                std::size_t count = gen() % 200;
+                vec.insert(vec.begin() + pos, count, value);
+                vec2.insert(vec2.begin() + pos, count, value);
+                break;
+            }
+            case 2:
+            {
+                std::vector<bool> src(gen() % 300);
+                for (std::size_t k = 0; k < src.size(); ++k)
+                {
+                    src[k] = gen() % 3 == 0;
+                }
+                tstd::vector<bool> tsrc(src.begin(), src.end());
+                vec.insert(vec.begin() + pos, tsrc.begin(), tsrc.end());
+                vec2.insert(vec2.begin() + pos, src.begin(), src.end());
+                break;
+            }
+            case 3:
+            {
+                std::size_t count = std::min<std::size_t>(gen() % 150, vec2.size() - pos);
+                vec.erase(vec.begin() + pos, vec.begin() + pos + count);
+                vec2.erase(vec2.begin() + pos, vec2.begin() + pos + count);
+                break;
+            }
+            case 4:
+            {
+                std::size_t last = pos + gen() % (vec2.size() - pos + 1);
+                tstd::fill(vec.begin() + pos, vec.begin() + last, value);
+                std::fill(vec2.begin() + pos, vec2.begin() + last, value);
+                break;
+            }
+            case 5:
+            {
+                // overlapping copies in both directions
+                std::size_t count = gen() % (vec2.size() - pos + 1);
+                std::size_t dest = gen() % (vec2.size() - count + 1);
+                if (dest <= pos)
+                {
+                    tstd::copy(vec.begin() + pos, vec.begin() + pos + count, vec.begin() + dest);
+                    std::copy(vec2.begin() + pos, vec2.begin() + pos + count, vec2.begin() + dest);
+                }
+                else
+                {
+                    tstd::copy_backward(vec.begin() + pos, vec.begin() + pos + count, vec.begin() + dest + count);
+                    std::copy_backward(vec2.begin() + pos, vec2.begin() + pos + count, vec2.begin() + dest + count);
+                }
+                break;
+            }
+            case 6:
+            {
+                std::size_t count = pos + gen() % 100;
+                vec.resize(count, value);
+                vec2.resize(count, value);
+                break;
+            }
+            case 7:
+                if (!vec2.empty())
+                {
+                    vec.pop_back();
+                    vec2.pop_back();
+                }
+                break;
+            }
+            ok = std::equal(vec.begin(), vec.end(), vec2.begin(), vec2.end());
+            pos = gen() % (vec2.size() + 1);
+            std::size_t last = pos + gen() % (vec2.size() - pos + 1);
+            if (ok)
+            {
+                ok = tstd::count(vec.cbegin() + pos, vec.cbegin() + last, value) == std::count(vec2.begin() + pos, vec2.begin() + last, value)
+                    && tstd::find(vec.cbegin() + pos, vec.cbegin() + last, value) - vec.cbegin() == std::find(vec2.begin() + pos, vec2.begin() + last, value) - vec2.begin();
+            }
+        }
+        util.assertEqual(ok, true);
+        util.assertSequenceEqual(vec, vec2);
+    }
+    // word-at-a-time algorithms
+    {
+        tstd::vector<bool> vec(1000, false);
+        vec[777] = true;
+        util.assertEqual(tstd::find(vec.begin(), vec.end(), true) - vec.begin(), std::ptrdiff_t(777));
+        util.assertEqual(tstd::find(vec.begin() + 778, vec.end(), true) == vec.end(), true);
+        util.assertEqual(tstd::find(vec.begin(), vec.end(), 2) == vec.end(), true); // 2 equals neither true nor false
+        util.assertEqual(tstd::count(vec.begin(), vec.end(), false), std::ptrdiff_t(999));
+        util.assertEqual(tstd::count(vec.begin(), vec.end(), 2), std::ptrdiff_t(0));
+        std::array<bool, 1> trues{true};
+        std::array<bool, 2> both{true, false};
+        util.assertEqual(tstd::find_first_of(vec.begin() + 3, vec.end(), trues.begin(), trues.end()) - vec.begin(), std::ptrdiff_t(777));
+        util.assertEqual(tstd::find_first_of(vec.begin() + 3, vec.end(), both.begin(), both.end()) - vec.begin(), std::ptrdiff_t(3));
+        util.assertEqual(tstd::find_first_of(vec.begin() + 3, vec.end(), both.begin(), both.begin()) == vec.end(), true);
+        auto iter = tstd::fill_n(vec.begin() + 5, 300, true);
+        util.assertEqual(iter - vec.begin(), std::ptrdiff_t(305));
+        util.assertEqual(tstd::count(vec.begin(), vec.end(), true), std::ptrdiff_t(301));
+        std::vector<int> ints(100);
+        tstd::copy(vec.begin(), vec.begin() + 100, ints.begin()); // generic version
+        util.assertEqual(std::accumulate(ints.begin(), ints.end(), 0), 95);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// default-initialized resize and unchecked append
+void testVectorForOverwrite(bool showDetails)
+{
+    TestUtil util(showDetails, "vector resize_for_overwrite/push_back_unchecked");
+    {
+        tstd::vector<char> buf{'a', 'b'};
+        buf.resize_for_overwrite(1000);
+        util.assertEqual(buf.size(), std::size_t(1000));
+        util.assertEqual(buf[0] == 'a' && buf[1] == 'b', true);
+        std::fill(buf.begin() + 2, buf.end(), 'c');
+        util.assertEqual(std::count(buf.begin(), buf.end(), 'c'), std::ptrdiff_t(998));
+        buf.resize_for_overwrite(1);
+        util.assertSequenceEqual(buf, std::vector<char>{'a'});
+        tstd::vector<std::string> strs{"x"};
+        strs.resize_for_overwrite(3); // non-trivial types are still constructed
+        util.assertSequenceEqual(strs, std::vector<std::string>{"x", "", ""});
+    }
+    {
+        tstd::vector<std::string> vec;
+        vec.reserve(100);
+        std::string* data = vec.data();
+        for (int i = 0; i < 100; ++i)
+        {
+            if (i % 2)
+            {
+                vec.push_back_unchecked(std::to_string(i));
+            }
+            else
+            {
+                util.assertEqual(vec.emplace_back_unchecked(3, 'a' + i % 26).size(), std::size_t(3));
+            }
+        }
+        util.assertEqual(vec.data(), data); // no reallocation
+        util.assertEqual(vec.size(), std::size_t(100));
+        util.assertEqual(vec[99], std::string("99"));
+        util.assertEqual(vec[98], std::string("uuu"));
+        std::string& last = vec.emplace_back("last");
+        util.assertEqual(&last, &vec.back()); // emplace_back returns the new element
+        util.assertEqual(vec.back(), std::string("last"));
+    }
+    {
+        tstd::small_vector<float, 4> vec{1.0f};
+        vec.resize_for_overwrite(3);
+        vec.push_back_unchecked(4.0f);
+        util.assertEqual(vec.size(), std::size_t(4));
+        util.assertEqual(vec.is_inline(), true);
+        vec.resize_for_overwrite(100);
+        util.assertEqual(vec.size(), std::size_t(100));
+        util.assertEqual(vec[0] == 1.0f && vec[3] == 4.0f, true);
+        vec.reserve(101);
+        util.assertEqual(vec.emplace_back_unchecked(5.0f), 5.0f);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// built in a constant expression
+constexpr int staticVectorSum()
+{
+    tstd::static_vector<int, 8> vec{5, 1, 4};
+    vec.push_back(2);
+    vec.insert(vec.begin() + 1, 3);
+    vec.erase(vec.begin());
+    tstd::static_vector<int, 8> copy = vec;
+    copy.resize(6, 10);
+    int sum = 0;
+    for (int x : copy)
+    {
+        sum += x;
+    }
+    return sum; // 3 + 1 + 4 + 2 + 10 + 10
+}
+
+
+void testStaticVector(bool showDetails)
+{
+    TestUtil util(showDetails, "static_vector");
+    static_assert(staticVectorSum() == 30);
+    static_assert(sizeof(tstd::static_vector<std::uint8_t, 15>) == 16); // 1-byte size
+    static_assert(std::is_trivially_destructible_v<tstd::static_vector<int, 4>>);
+    // basic operations
+    {
+        tstd::static_vector<std::string, 4> vec{"a", "b"};
+        util.assertEqual(vec.capacity(), std::size_t(4));
+        vec.emplace_back(2, 'c');
+        vec.insert(vec.begin(), "z");
+        util.assertSequenceEqual(vec, std::vector<std::string>{"z", "a", "b", "cc"});
+        util.assertEqual(vec.try_push_back("d") == nullptr, true); // full
+        bool thrown = false;
+        try
+        {
+            vec.push_back("d");
+        }
+        catch (const std::bad_alloc&)
+        {
+            thrown = true;
+        }
+        util.assertEqual(thrown, true);
+        util.assertEqual(vec.size(), std::size_t(4));
+        thrown = false;
+        try
+        {
+            vec.at(4);
+        }
+        catch (const std::out_of_range&)
+        {
+            thrown = true;
+        }
+        util.assertEqual(thrown, true);
+        vec.pop_back();
+        util.assertEqual(*vec.try_emplace_back(3, 'e'), std::string("eee"));
+        tstd::static_vector<std::string, 4> vec2(vec);
+        util.assertEqual(vec2 == vec, true);
+        vec2.erase(vec2.begin() + 1, vec2.end());
+        vec2.push_back_unchecked("y");
+        util.assertSequenceEqual(vec2, std::vector<std::string>{"z", "y"});
+        util.assertEqual(vec2 > vec, true);
+        tstd::swap(vec, vec2);
+        util.assertSequenceEqual(vec, std::vector<std::string>{"z", "y"});
+        util.assertSequenceEqual(vec2, std::vector<std::string>{"z", "a", "b", "eee"});
+        vec.assign(vec2.rbegin(), vec2.rend());
+        util.assertSequenceEqual(vec, std::vector<std::string>{"eee", "b", "a", "z"});
+    }
+    randomVectorOperations<tstd::static_vector<int, 64>>(util, [](int i) { return i; }, 7);
+    randomVectorOperations<tstd::static_vector<std::string, 32>>(util, [](int i) { return std::to_string(i) + std::string(20, 'x'); }, 7);
+    // container of adaptors
+    {
+        tstd::stack<int, tstd::static_vector<int, 16>> stk;
+        tstd::priority_queue<int, tstd::static_vector<int, 16>> pq;
+        for (int x : {3, 1, 4, 1, 5, 9, 2, 6})
+        {
+            stk.push(x);
+            pq.push(x);
+        }
+        util.assertEqual(stk.top(), 6);
+        util.assertEqual(stk.size(), std::size_t(8));
+        std::vector<int> sorted;
+        while (!pq.empty())
+        {
+            sorted.push_back(pq.top());
+            pq.pop();
+        }
+        util.assertSequenceEqual(sorted, std::vector<int>{9, 6, 5, 4, 3, 2, 1, 1});
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// copy a column span of soa_vector, for assertSequenceEqual
+template<typename T>
+std::vector<std::remove_const_t<T>> columnToVector(std::span<T> column)
+{
+    return std::vector<std::remove_const_t<T>>(column.begin(), column.end());
+}
+
+void testSoaVector(bool showDetails)
+{
+    TestUtil util(showDetails, "soa_vector");
+    using Row = std::tuple<int, double, std::string>;
+    // basic operations
+    {
+        tstd::soa_vector<int, double, std::string> vec{{3, 1.5, "c"}, {1, 2.5, "a"}};
+        vec.push_back(Row(2, 0.5, "b"));
+        vec.emplace_back(5, 4.0, "e");
+        util.assertEqual(vec.size(), std::size_t(4));
+        util.assertSequenceEqual(columnToVector(vec.column<0>()), std::vector<int>{3, 1, 2, 5});
+        util.assertSequenceEqual(columnToVector(vec.column<2>()), std::vector<std::string>{"c", "a", "b", "e"});
+        util.assertEqual(vec.data<1>() + 1 == &vec.column<1>()[1], true);
+        auto [id, price, name] = vec[1];
+        price = 3.5;
+        util.assertEqual(vec.column<1>()[1], 3.5);
+        util.assertEqual(name, std::string("a"));
+        util.assertEqual(id, 1);
+        vec[0] = Row(4, 1.0, "d");
+        util.assertEqual(Row(vec.front()) == Row(4, 1.0, "d"), true);
+        util.assertEqual(vec.back() == Row(5, 4.0, "e"), true);
+        vec.insert(vec.begin() + 1, Row(0, 0.0, "z"));
+        util.assertSequenceEqual(columnToVector(vec.column<2>()), std::vector<std::string>{"d", "z", "a", "b", "e"});
+        vec.erase(vec.begin(), vec.begin() + 2);
+        vec.pop_back();
+        util.assertSequenceEqual(columnToVector(vec.column<0>()), std::vector<int>{1, 2});
+        bool thrown = false;
+        try
+        {
+            vec.at(2);
+        }
+        catch (const std::out_of_range&)
+        {
+            thrown = true;
+        }
+        util.assertEqual(thrown, true);
+        tstd::soa_vector<int, double, std::string> copy(vec);
+        util.assertEqual(copy == vec, true);
+        copy.resize(4, Row(7, 7.0, "g"));
+        copy.shrink_to_fit();
+        util.assertEqual(copy.capacity(), std::size_t(4));
+        util.assertSequenceEqual(columnToVector(copy.column<2>()), std::vector<std::string>{"a", "b", "g", "g"});
+        tstd::swap(copy, vec);
+        util.assertEqual(vec.size(), std::size_t(4));
+        util.assertEqual(copy.size(), std::size_t(2));
+        vec = std::move(copy);
+        util.assertEqual(vec.size(), std::size_t(2));
+        vec.resize(3);
+        util.assertEqual(vec.back() == Row(0, 0.0, ""), true);
+        // growth from an argument referring to a row
+        tstd::soa_vector<std::string, int> strs;
+        strs.emplace_back(std::string(30, 'x'), 1);
+        for (int i = 0; i < 10; ++i)
+        {
+            strs.emplace_back(strs.column<0>()[0], i);
+        }
+        util.assertEqual(tstd::count(strs.column<0>().begin(), strs.column<0>().end(), std::string(30, 'x')), std::ptrdiff_t(11));
+    }
+    // a throwing copy destroys the columns already copied
+    {
+        using Counted = InsertThrower<false>;
+        using Thrower = InsertThrower<true>;
+        {
+            tstd::soa_vector<Counted, Thrower> vec;
+            for (int i = 0; i < 4; ++i)
+            {
+                vec.emplace_back(i, i);
+            }
+            Thrower::copies_left = 2;
+            bool thrown = false;
+            try
+            {
+                tstd::soa_vector<Counted, Thrower> copy(vec);
+            }
+            catch (const std::runtime_error&)
+            {
+                thrown = true;
+            }
+            Thrower::copies_left = -1;
+            util.assertEqual(thrown, true);
+            util.assertEqual(Counted::live, 4);
+            util.assertEqual(Thrower::live, 4);
+        }
+        util.assertEqual(Counted::live, 0);
+    }
+    // algorithms on rows and columns
+    {
+        tstd::soa_vector<int, double, std::string> vec;
+        std::vector<Row> rows;
+        std::mt19937 rng(5);
+        for (int i = 0; i < 500; ++i)
+        {
+            Row row(static_cast<int>(rng() % 50), static_cast<double>(rng() % 1000) / 8, std::to_string(rng() % 100) + std::string(20, 'x'));
+            vec.push_back(row);
+            rows.push_back(row);
+        }
+        tstd::sort(vec.begin(), vec.end());
+        std::sort(rows.begin(), rows.end());
+        util.assertEqual(std::equal(vec.begin(), vec.end(), rows.begin()), true);
+        auto byPrice = [](const auto& lhs, const auto& rhs) {
+            using std::get;
+            return get<1>(lhs) < get<1>(rhs);
+        };
+        tstd::stable_sort(vec.begin(), vec.end(), byPrice);
+        std::stable_sort(rows.begin(), rows.end(), byPrice);
+        util.assertEqual(std::equal(vec.begin(), vec.end(), rows.begin()), true);
+        tstd::reverse(vec.begin(), vec.end());
+        std::reverse(rows.begin(), rows.end());
+        util.assertEqual(std::equal(vec.begin(), vec.end(), rows.begin()), true);
+        auto it = tstd::remove_if(vec.begin(), vec.end(), [](const auto& row) { return row.template get<0>() % 3 == 0; });
+        vec.erase(it, vec.end());
+        rows.erase(std::remove_if(rows.begin(), rows.end(), [](const Row& row) { return std::get<0>(row) % 3 == 0; }), rows.end());
+        util.assertEqual(vec.size(), rows.size());
+        util.assertEqual(std::equal(vec.begin(), vec.end(), rows.begin()), true);
+        // filter on one column and sum another
+        auto ids = vec.column<0>();
+        auto prices = vec.column<1>();
+        double sum1 = tstd::transform_reduce(ids.begin(), ids.end(), prices.begin(), 0.0, std::plus<double>(),
+            [](int id, double price) { return id < 25 ? price : 0.0; });
+        double sum2 = tstd::transform_reduce(vec.cbegin(), vec.cend(), 0.0, std::plus<double>(),
+            [](const auto& row) { return row.template get<0>() < 25 ? row.template get<1>() : 0.0; });
+        double sum3 = 0;
+        for (const Row& row : rows)
+        {
+            sum3 += std::get<0>(row) < 25 ? std::get<1>(row) : 0.0;
+        }
+        util.assertEqual(sum1, sum3);
+        util.assertEqual(sum2, sum3);
+        auto found = tstd::find(vec.begin(), vec.end(), rows[rows.size() / 2]);
+        util.assertEqual(found - vec.begin(), static_cast<std::ptrdiff_t>(std::find(rows.begin(), rows.end(), rows[rows.size() / 2]) - rows.begin()));
+        util.assertEqual(tstd::is_sorted(vec.crbegin(), vec.crend(), byPrice), true);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// comparisons of contiguous containers of integers and pointers go through memcmp
+template<typename T>
+void compareLikeStd(TestUtil& util, std::size_t n)
+{
+    std::mt19937 rng(3);
+    auto make = [](unsigned x) {
+        if constexpr (std::is_same_v<T, std::string>)
+        {
+            return std::to_string(x % 4);
+        }
+        else
+        {
+            return static_cast<T>(x);
+        }
+    };
+    bool ok = true;
+    for (int i = 0; i < 200; ++i)
+    {
+        std::vector<T> v1(rng() % n, make(1));
+        std::vector<T> v2(v1.begin(), v1.begin() + rng() % (v1.size() + 1));
+        v2.resize(v2.size() + rng() % 3, make(rng()));
+        if (!v1.empty() && rng() % 2)
+        {
+            v1[rng() % v1.size()] = make(rng());
+        }
+        tstd::vector<T> t1(v1.begin(), v1.end());
+        tstd::vector<T> t2(v2.begin(), v2.end());
+        tstd::small_vector<T, 8> s1(v1.begin(), v1.end());
+        tstd::small_vector<T, 8> s2(v2.begin(), v2.end());
+        ok = ok && (t1 == t2) == (v1 == v2) && (t1 != t2) == (v1 != v2) && (t1 < t2) == (v1 < v2) && (t1 >= t2) == (v1 >= v2);
+        ok = ok && (s1 == s2) == (v1 == v2) && (s1 < s2) == (v1 < v2) && (s2 > s1) == (v2 > v1);
+    }
+    util.assertEqual(ok, true);
+}
+
+void testContiguousComparisons(bool showDetails)
+{
+    TestUtil util(showDetails, "comparisons of contiguous containers");
+    compareLikeStd<unsigned char>(util, 1000);
+    compareLikeStd<char>(util, 1000);
+    compareLikeStd<int>(util, 1000);
+    compareLikeStd<long long>(util, 100);
+    compareLikeStd<std::string>(util, 50);
+    {
+        int values[3] = {};
+        tstd::vector<int*> ptrs1{values, values + 1, values + 2};
+        tstd::vector<int*> ptrs2{values, values + 2};
+        util.assertEqual(ptrs1 < ptrs2, true);
+        util.assertEqual(ptrs1 == ptrs2, false);
+        ptrs2.insert(ptrs2.begin() + 1, values + 1);
+        util.assertEqual(ptrs1 == ptrs2, true);
+    }
+    {
+        tstd::array<int, 4> a1{1, 2, 3, -4};
+        tstd::array<int, 4> a2{1, 2, 3, 4};
+        util.assertEqual(a1 < a2, true);
+        util.assertEqual(a1 == a2, false);
+        a1[3] = 4;
+        util.assertEqual(a1 == a2, true);
+        util.assertEqual(a1 >= a2, true);
+        static_assert(tstd::array<int, 2>{1, -1} < tstd::array<int, 2>{1, 0});
+        static_assert(tstd::static_vector<int, 4>{1, 2} < tstd::static_vector<int, 4>{1, 2, 0});
+        static_assert(tstd::static_vector<unsigned char, 4>{1, 2} != tstd::static_vector<unsigned char, 4>{1, 3});
+    }
+    {
+        tstd::deque<int> d1{1, 2, 3};
+        tstd::deque<int> d2{1, 2, 3, 4};
+        util.assertEqual(d1 == d2, false);
+        util.assertEqual(d1 < d2, true);
+        d2.pop_back();
+        util.assertEqual(d1 == d2, true);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+struct SegmentedVectorTag {};
+
+void testSegmentedVector(bool showDetails)
+{
+    TestUtil util(showDetails, "segmented_vector");
+    static_assert(tstd::segmented_vector<int>::chunk_size == 1024);
+    static_assert(tstd::segmented_vector<std::string>::chunk_size * sizeof(std::string) <= 4096);
+    // basic operations
+    {
+        tstd::segmented_vector<int, 4> vec;
+        util.assertEqual(vec.begin() == vec.end(), true);
+        for (int i = 0; i < 10; ++i)
+        {
+            vec.push_back(i);
+        }
+        util.assertEqual(vec.capacity(), std::size_t(12));
+        util.assertSequenceEqual(vec, std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+        util.assertEqual(vec[5] + vec.at(9) + vec.front() + vec.back(), 23);
+        util.assertEqual(vec.end() - vec.begin(), std::ptrdiff_t(10));
+        util.assertEqual(*(vec.end() - 5), 5);
+        util.assertEqual(*(vec.begin() + 7 - 6), 1);
+        util.assertSequenceEqual(std::vector<int>(vec.rbegin(), vec.rbegin() + 3), std::vector<int>{9, 8, 7});
+        bool thrown = false;
+        try
+        {
+            vec.at(10);
+        }
+        catch (const std::out_of_range&)
+        {
+            thrown = true;
+        }
+        util.assertEqual(thrown, true);
+        vec.resize(4);
+        util.assertEqual(vec.capacity(), std::size_t(12)); // chunks are kept
+        vec.shrink_to_fit();
+        util.assertEqual(vec.capacity(), std::size_t(4));
+        vec.push_back(4);
+        util.assertEqual(vec.capacity(), std::size_t(8));
+        tstd::segmented_vector<int, 4> vec2{0, 1, 2, 3, 4};
+        util.assertEqual(vec == vec2, true);
+        vec2.pop_back();
+        util.assertEqual(vec2 < vec, true);
+        tstd::swap(vec, vec2);
+        util.assertEqual(vec.size(), std::size_t(4));
+        vec = vec2;
+        util.assertEqual(vec == vec2, true);
+    }
+    // element addresses never change while growing
+    {
+        tstd::segmented_vector<std::string, 8> vec;
+        std::vector<const std::string*> addresses;
+        for (int i = 0; i < 1000; ++i)
+        {
+            addresses.push_back(&vec.emplace_back(std::to_string(i)));
+        }
+        bool stable = true;
+        for (int i = 0; i < 1000; ++i)
+        {
+            stable = stable && addresses[i] == &vec[i] && *addresses[i] == std::to_string(i);
+        }
+        util.assertEqual(stable, true);
+        vec.emplace_back(vec.front()); // argument refers to an element
+        util.assertEqual(vec.back(), std::string("0"));
+    }
+    // compare with std::vector
+    {
+        tstd::segmented_vector<std::string, 16> vec1;
+        std::vector<std::string> vec2;
+        std::mt19937 rng(11);
+        bool ok = true;
+        for (int i = 0; i < 3000; ++i)
+        {
+            std::string value = std::to_string(i) + std::string(20, 'x');
+            switch (rng() % 8)
+            {
+            case 0: case 1: case 2:
+                vec1.push_back(value);
+                vec2.push_back(value);
+                break;
+            case 3:
+                if (!vec2.empty())
+                {
+                    vec1.pop_back();
+                    vec2.pop_back();
+                }
+                break;
+            case 4:
+            {
+                std::size_t n = vec2.size() + rng() % 40;
+                vec1.resize(n, value);
+                vec2.resize(n, value);
+                break;
+            }
+            case 5:
+                vec1.resize(vec2.size() / 2);
+                vec2.resize(vec2.size() / 2);
+                break;
+            case 6:
+            {
+                tstd::segmented_vector<std::string, 16> copy(vec1);
+                vec1 = std::move(copy);
+                break;
+            }
+            case 7:
+                if (rng() % 8 == 0)
+                {
+                    vec1.shrink_to_fit();
+                }
+                break;
+            }
+            ok = ok && vec1.size() == vec2.size() && std::equal(vec1.begin(), vec1.end(), vec2.begin());
+        }
+        util.assertEqual(ok, true);
+        std::sort(vec1.begin(), vec1.end());
+        std::sort(vec2.begin(), vec2.end());
+        util.assertSequenceEqual(vec1, vec2);
+    }
+    // growth allocates chunks and a small chunk table, never a block of all elements
+    {
+        using Alloc = tstd::counting_allocator<int, SegmentedVectorTag>;
+        tstd::reset_allocation_stats<SegmentedVectorTag>();
+        {
+            tstd::segmented_vector<int, 1024, Alloc> vec;
+            for (int i = 0; i < 100000; ++i)
+            {
+                vec.push_back(i);
+            }
+            util.assertEqual(vec[99999], 99999);
+        }
+        auto stats = tstd::get_allocation_stats<SegmentedVectorTag>();
+        util.assertEqual(stats.live_bytes, std::size_t(0));
+        // 98 chunks of 4KB and the last chunk table of 128 slots
+        util.assertEqual(stats.peak_live_bytes <= 98 * 4096 + 128 * sizeof(int*) + 64 * sizeof(int*), true);
+        util.assertEqual(stats.peak_live_bytes < 100000 * sizeof(int) * 11 / 10, true);
+    }
+    // copies select their allocator by select_on_container_copy_construction
+    {
+        tstd::pmr::monotonic_buffer_resource res;
+        tstd::segmented_vector<int, 16, tstd::pmr::polymorphic_allocator<int>> vec(&res);
+        vec.assign({1, 2, 3});
+        auto copy(vec);
+        util.assertSequenceEqual(copy, vec);
+        util.assertEqual(vec.get_allocator().resource() == &res, true);
+        util.assertEqual(copy.get_allocator().resource() == tstd::pmr::get_default_resource(), true);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+// random operations on tstd::deque of given block bytes and std::deque
+template<typename T, std::size_t BlockBytes, typename Gen>
+void randomDequeOperations(TestUtil& util, Gen&& gen)
+{
+    tstd::deque<T, tstd::allocator<T>, BlockBytes> dq1;
+    std::deque<T> dq2;
+    std::mt19937 rng(23);
+    bool ok = true;
+    for (int i = 0; i < 3000; ++i)
+    {
+        std::size_t pos = dq2.empty() ? 0 : rng() % (dq2.size() + 1);
+        T value = gen(i);
+        switch (rng() % 8)
+        {
+        case 0:
+            dq1.push_back(value);
+            dq2.push_back(value);
+            break;
+        case 1:
+            dq1.push_front(value);
+            dq2.push_front(value);
+            break;
+        case 2:
+            if (!dq2.empty())
+            {
+                dq1.pop_front();
+                dq2.pop_front();
+            }
+            break;
+        case 3:
+            if (!dq2.empty())
+            {
+                dq1.pop_back();
+                dq2.pop_back();
+            }
+            break;
+        case 4:
+            dq1.insert(dq1.begin() + pos, rng() % 20, value);
+            dq2.insert(dq2.begin() + pos, dq1.size() - dq2.size(), value);
+            break;
+        case 5:
+        {
+            std::size_t last = tstd::min(dq2.size(), pos + rng() % 20);
+            dq1.erase(dq1.begin() + pos, dq1.begin() + last);
+            dq2.erase(dq2.begin() + pos, dq2.begin() + last);
+            break;
+        }
+        case 6:
+            if (pos < dq2.size())
+            {
+                ok = ok && dq1[pos] == dq2[pos] && dq1.at(pos) == dq2.at(pos);
+                ok = ok && *(dq1.end() - (dq2.size() - pos)) == dq2[pos];
+                ok = ok && dq1.end() - (dq1.begin() + pos) == std::ptrdiff_t(dq2.size() - pos);
+            }
+            break;
+        case 7:
+            if (rng() % 16 == 0)
+            {
+                dq1.shrink_to_fit();
+            }
+            break;
+        }
+        ok = ok && dq1.size() == dq2.size() && std::equal(dq1.begin(), dq1.end(), dq2.begin());
+    }
+    util.assertEqual(ok, true);
+}
+
+struct DequeBigElement
+{
+    char bytes[1000];
+    int value;
+    DequeBigElement(int i = 0) : value(i) {}
+    bool operator==(const DequeBigElement& other) const { return value == other.value; }
+};
+
+void testDequeBlockSize(bool showDetails)
+{
+    TestUtil util(showDetails, "deque block size");
+    // elements in one block are the largest power of 2 fitting in the block bytes
+    static_assert(tstd::impl::deque_block_elements<char, 4096> == 4096);
+    static_assert(tstd::impl::deque_block_elements<int, 4096> == 1024);
+    static_assert(tstd::impl::deque_block_elements<int, 100> == 16);
+    static_assert(tstd::impl::deque_block_elements<DequeBigElement, 4096> == 4);
+    static_assert(tstd::impl::deque_block_elements<DequeBigElement, 512> == 1);
+    randomDequeOperations<int, 64>(util, [](int i) { return i; });
+    randomDequeOperations<int, tstd::impl::deque_default_block_bytes>(util, [](int i) { return i; });
+    randomDequeOperations<std::string, 128>(util, [](int i) { return std::to_string(i) + std::string(20, 'x'); });
+    randomDequeOperations<DequeBigElement, 4096>(util, [](int i) { return DequeBigElement(i); });
+    randomDequeOperations<DequeBigElement, 512>(util, [](int i) { return DequeBigElement(i); });
+    // block bytes are part of the type, adaptors take any of them
+    {
+        tstd::queue<int, tstd::deque<int, tstd::allocator<int>, 64>> que;
+        for (int i = 0; i < 100; ++i)
+        {
+            que.push(i);
+        }
+        int sum = 0;
+        while (!que.empty())
+        {
+            sum += que.front();
+            que.pop();
+        }
+        util.assertEqual(sum, 4950);
+    }
+
+    // final result
+    util.showFinalResult();
+}
+
+struct DequeCacheTag {};
+
+void testDequeBlockCache(bool showDetails)
+{
+    TestUtil util(showDetails, "deque block cache");
+    using Alloc = tstd::counting_allocator<int, DequeCacheTag>;
+    // a queue with steady length allocates nothing after warming up
+    {
+        tstd::queue<int, tstd::deque<int, Alloc, 64>> que;
+        for (int i = 0; i < 1000; ++i)
+        {
+            que.push(i);
+        }
+        for (int i = 0; i < 1000; ++i) // map is recentred to its final place
+        {
+            que.push(i);
+            que.pop();
+        }
+        tstd::reset_allocation_stats<DequeCacheTag>();
+        long long sum = 0;
+        for (int i = 0; i < 100000; ++i)
+        {
+            que.push(i);
+            sum += que.front();
+            que.pop();
+        }
+        auto stats = tstd::get_allocation_stats<DequeCacheTag>();
+        util.assertEqual(stats.allocations, std::size_t(0));
+        util.assertEqual(stats.deallocations, std::size_t(0));
+        util.assertEqual(que.size(), std::size_t(1000));
+        util.assertEqual(que.front(), 99000);
+        util.assertEqual(sum, 1000LL * 999 / 2 + 98999LL * 99000 / 2);
+    }
+    // buffers freed at one end are reused at the other end, shrink_to_fit frees them
+    {
+        tstd::deque<int, Alloc, 64> dq(64, 1); // 16 elements in one buffer
+        for (int i = 0; i < 32; ++i)
+        {
+            dq.pop_front();
+        }
+        util.assertEqual(dq.spare_buffers(), std::size_t(2));
+        tstd::reset_allocation_stats<DequeCacheTag>();
+        for (int i = 0; i < 20; ++i)
+        {
+            dq.push_back(i);
+        }
+        util.assertEqual(tstd::get_allocation_stats<DequeCacheTag>().allocations, std::size_t(0));
+        util.assertEqual(dq.back(), 19);
+        util.assertEqual(dq.size(), std::size_t(52));
+        dq.clear();
+        util.assertEqual(dq.spare_buffers(), std::size_t(2));
+        dq.shrink_to_fit();
+        util.assertEqual(dq.spare_buffers(), std::size_t(0));
+        tstd::deque<int, Alloc, 64> dq2(std::move(dq));
+        dq2.push_back(1);
+        util.assertSequenceEqual(dq2, std::vector<int>{1});
+    }
+    util.assertEqual(tstd::get_allocation_stats<DequeCacheTag>().live_bytes, std::size_t(0));
+
+    // final result
+    util.showFinalResult();
+}
@@ -232,6 +232,17 @@ public:
                 << "\n\tright set: " << PrintSequenceElements(b2, e2, maxSequenceLength)  << std::endl;
         }
     }
+    // show allocation report (e.g. tstd::allocation_stats of a counting allocator) in details
+    template<typename Report>
+    void showAllocationReport(const std::string& name, const Report& report, const std::source_location& loc = std::source_location::current())
+    {
+        if (showDetails)
+        {
+            std::cout << std::boolalpha << std::dec;
+            std::cout << loc.file_name() << ":" << std::setw(lineNumberWidth) << loc.line() << ": "
+                << "allocation report of " << name << ":\n\t" << report << std::endl;
+        }
+    }
 private:
     int passedCount;
     int totalCount;